@@ -0,0 +1,207 @@
+// runtime-alarm.h - 1.0.0 - 2022-12-11
+//
+// Copyright (c) 2022 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+// Alarm engine
+// The program writes its alarm conditions into a contiguous bit area of the memory, alarm 'n' is bit n % 8
+// of the byte 'address + n / 8'. At the end of every scan the area is compared with the previous image 32 bits
+// at a time, so unchanged words cost a single XOR. Every changed bit pushes a timestamped event.
+//
+// Acknowledgement bits live in a second bit area of the same size. The engine sets the bit when its alarm
+// is raised, the HMI or the program clears it to acknowledge the alarm, which pushes an acknowledge event.
+//
+// Events are written into a ring by a single producer and numbered by an increasing sequence. Readers keep
+// their own sequence cursor and fetch only the events after it, an event that was already overwritten is
+// reported as lost instead of blocking the producer.
+//
+// Event upload format (all numbers are big-endian):
+//   <u32 next_sequence> { <u32 sequence> <u16 alarm> <u8 type> <u32 time> }
+
+#ifndef PLCRUNTIME_ALARM_MAX_COUNT
+#define PLCRUNTIME_ALARM_MAX_COUNT 64
+#endif // PLCRUNTIME_ALARM_MAX_COUNT
+
+#ifndef PLCRUNTIME_ALARM_QUEUE_SIZE
+#define PLCRUNTIME_ALARM_QUEUE_SIZE 16
+#endif // PLCRUNTIME_ALARM_QUEUE_SIZE
+
+#define PLCRUNTIME_ALARM_AREA_SIZE ((PLCRUNTIME_ALARM_MAX_COUNT + 7) / 8)
+
+enum AlarmEventType {
+    ALARM_RAISED = 1,
+    ALARM_CLEARED,
+    ALARM_ACKNOWLEDGED,
+};
+
+struct AlarmEvent {
+    u32 sequence;
+    u32 time;  // Timestamp in milliseconds
+    u16 alarm; // Alarm index in the bit area
+    u8 type;   // AlarmEventType
+};
+
+class RuntimeAlarms {
+public:
+    u32 address = 0;     // Alarm condition bit area
+    u32 ack_address = 0; // Acknowledgement bit area
+    u16 count = 0;       // Number of alarms, 0 if disabled
+    volatile u32 sequence = 0; // Sequence of the next event
+
+    RuntimeAlarms() {}
+
+    // Configure the alarm and acknowledgement bit areas, clears the events. Returns true on error
+    bool configure(u32 alarm_address, u32 acknowledge_address, u16 alarm_count) {
+        u32 size = (alarm_count + 7) / 8;
+        if (alarm_count > PLCRUNTIME_ALARM_MAX_COUNT) return true;
+        if (alarm_address + size > PLCRUNTIME_MAX_MEMORY_SIZE) return true;
+        if (acknowledge_address + size > PLCRUNTIME_MAX_MEMORY_SIZE) return true;
+        address = alarm_address;
+        ack_address = acknowledge_address;
+        count = alarm_count;
+        reset();
+        return false;
+    }
+
+    void disable() {
+        count = 0;
+        reset();
+    }
+
+    // Forget the previous images and the events, alarms that are active on the next scan are raised again
+    void reset() {
+        for (u32 i = 0; i < PLCRUNTIME_ALARM_AREA_SIZE; i++) {
+            previous[i] = 0;
+            previous_ack[i] = 0;
+        }
+        sequence = 0;
+    }
+
+    // Clear the acknowledgement bit of the alarm, the event is pushed on the next scan. Returns true on error
+    bool acknowledge(plc_memory_t memory, u16 alarm) {
+        if (alarm >= count) return true;
+        u8 bits = 0;
+        if (get_u8(memory, ack_address + alarm / 8, bits)) return true;
+        return set_u8(memory, ack_address + alarm / 8, bits & ~(1 << (alarm % 8)));
+    }
+
+    // Clear all acknowledgement bits
+    void acknowledgeAll(plc_memory_t memory) {
+        for (u32 i = 0; i < (u32) (count + 7) / 8; i++) set_u8(memory, ack_address + i, 0);
+    }
+
+    // Compare the bit areas with the previous images and push the events, called at the end of every scan
+    void scan(plc_memory_t memory) {
+        if (count == 0) return;
+        u32 size = (count + 7) / 8;
+        u32 now = millis();
+        for (u32 offset = 0; offset < size; offset += 4) {
+            u8 n = size - offset < 4 ? size - offset : 4;
+            u32 mask = offset * 8 + 32 > count ? ((u32) 1 << (count - offset * 8)) - 1 : 0xFFFFFFFF;
+            u8 word[4];
+            readArea_u8(memory, address + offset, word, n);
+            u32 state = readWord(word, n) & mask;
+            u32 old_state = readWord(previous + offset, n);
+            readArea_u8(memory, ack_address + offset, word, n);
+            u32 ack = readWord(word, n) & mask;
+            u32 old_ack = readWord(previous_ack + offset, n);
+            u32 changed = state ^ old_state;
+            u32 acknowledged = old_ack & ~ack;
+            if ((changed | acknowledged) == 0) continue;
+            u16 base = offset * 8;
+            for (u8 bit = 0; acknowledged; bit++, acknowledged >>= 1) {
+                if (acknowledged & 1) push(base + bit, ALARM_ACKNOWLEDGED, now);
+            }
+            u32 raised = changed & state;
+            for (u8 bit = 0; changed; bit++, changed >>= 1) {
+                if (changed & 1) push(base + bit, (state >> bit) & 1 ? ALARM_RAISED : ALARM_CLEARED, now);
+            }
+            // Raised alarms wait for an acknowledgement
+            if (raised) {
+                ack |= raised;
+                writeWord(word, n, ack);
+                writeArea_u8(memory, ack_address + offset, word, n);
+            }
+            writeWord(previous + offset, n, state);
+            writeWord(previous_ack + offset, n, ack);
+        }
+    }
+
+    // Read the event with the given sequence. Returns true if it was not pushed yet or was already overwritten
+    bool read(u32 event_sequence, AlarmEvent& event) const {
+        u32 next = sequence;
+        if (event_sequence >= next) return true;
+        if (next - event_sequence > PLCRUNTIME_ALARM_QUEUE_SIZE) return true;
+        event = queue[event_sequence % PLCRUNTIME_ALARM_QUEUE_SIZE];
+        // The slot could have been overwritten while it was copied
+        if (sequence - event_sequence > PLCRUNTIME_ALARM_QUEUE_SIZE) return true;
+        return false;
+    }
+
+    // Oldest sequence that can still be read
+    u32 oldest() const {
+        u32 next = sequence;
+        return next > PLCRUNTIME_ALARM_QUEUE_SIZE ? next - PLCRUNTIME_ALARM_QUEUE_SIZE : 0;
+    }
+
+    // Print the events from the given sequence on in the upload format as hex
+    void upload(u32 from) const {
+        u32 next = sequence;
+        if (from < oldest()) from = oldest();
+        printHex(next, 4);
+        AlarmEvent event;
+        for (u32 i = from; i < next; i++) {
+            if (read(i, event)) continue;
+            printHex(event.sequence, 4);
+            printHex(event.alarm, 2);
+            printHex(event.type, 1);
+            printHex(event.time, 4);
+        }
+        Serial.println();
+    }
+
+private:
+    u8 previous[PLCRUNTIME_ALARM_AREA_SIZE];     // Alarm bit area of the previous scan
+    u8 previous_ack[PLCRUNTIME_ALARM_AREA_SIZE]; // Acknowledgement bit area of the previous scan
+    AlarmEvent queue[PLCRUNTIME_ALARM_QUEUE_SIZE];
+
+    void push(u16 alarm, u8 type, u32 time) {
+        u32 next = sequence;
+        AlarmEvent& event = queue[next % PLCRUNTIME_ALARM_QUEUE_SIZE];
+        event.sequence = next;
+        event.time = time;
+        event.alarm = alarm;
+        event.type = type;
+        // Publish the event after it is written
+        sequence = next + 1;
+    }
+
+    // Up to 4 bytes of a bit area as a word, the first byte holds the lowest bits
+    static u32 readWord(const u8* data, u8 size) {
+        u32 word = 0;
+        for (u8 i = 0; i < size; i++) word |= (u32) data[i] << (i * 8);
+        return word;
+    }
+
+    static void writeWord(u8* data, u8 size, u32 word) {
+        for (u8 i = 0; i < size; i++) data[i] = (word >> (i * 8)) & 0xFF;
+    }
+};
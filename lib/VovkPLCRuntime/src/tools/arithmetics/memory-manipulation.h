@@ -356,7 +356,7 @@ namespace PLCMethods {
 
 
     // Pop the pointer from the stack and push the value from the memory to the stack
-    RuntimeError LOAD(RuntimeStack& stack, u8* memory, u8* program, u32 prog_size, u32& index) {
+    RuntimeError LOAD(RuntimeStack& stack, plc_memory_t memory, u8* program, u32 prog_size, u32& index) {
         u32 size = 1;
         if (index + size > prog_size) return PROGRAM_POINTER_OUT_OF_BOUNDS;
         u8 data_type = 0;
@@ -367,7 +367,7 @@ namespace PLCMethods {
     }
 
     // (1.) Pop the value from the stack, (2.) pop the pointer from the stack, (3.) put the value to the memory
-    RuntimeError MOVE(RuntimeStack& stack, u8* memory, u8* program, u32 prog_size, u32& index) {
+    RuntimeError MOVE(RuntimeStack& stack, plc_memory_t memory, u8* program, u32 prog_size, u32& index) {
         u32 size = 1;
         if (index + size > prog_size) return PROGRAM_POINTER_OUT_OF_BOUNDS;
         u8 data_type = 0;
@@ -378,7 +378,7 @@ namespace PLCMethods {
     }
 
     // (1.) Pop the value from the stack, (2.) pop the pointer from the stack, (3.) put the value to the memory, (4.) push the value back to the stack
-    RuntimeError MOVE_COPY(RuntimeStack& stack, u8* memory, u8* program, u32 prog_size, u32& index) {
+    RuntimeError MOVE_COPY(RuntimeStack& stack, plc_memory_t memory, u8* program, u32 prog_size, u32& index) {
         u32 size = 1;
         if (index + size > prog_size) return PROGRAM_POINTER_OUT_OF_BOUNDS;
         u8 data_type = 0;
@@ -388,6 +388,26 @@ namespace PLCMethods {
         return status;
     }
 
+    // Push the value at the frame offset to the stack
+    RuntimeError LOCAL_LOAD(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
+        u32 size = 2;
+        if (index + size > prog_size) return PROGRAM_POINTER_OUT_OF_BOUNDS;
+        u8 data_type = program[index];
+        u8 offset = program[index + 1];
+        index += size;
+        return stack.load_from_frame_to_stack(offset, data_type);
+    }
+
+    // Pop the value from the stack and put it to the frame offset
+    RuntimeError LOCAL_STORE(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
+        u32 size = 2;
+        if (index + size > prog_size) return PROGRAM_POINTER_OUT_OF_BOUNDS;
+        u8 data_type = program[index];
+        u8 offset = program[index + 1];
+        index += size;
+        return stack.store_from_stack_to_frame(offset, data_type);
+    }
+
 
     // Duplicate the value on top of the stack
     RuntimeError COPY(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
@@ -400,7 +420,6 @@ namespace PLCMethods {
             case type_pointer: {
                 RuntimeError e = STATUS_SUCCESS;
                 MY_PTR_t value = stack.peek_pointer();
-                value = reverse_byte_order(value);
                 e = stack.push_pointer(value);
                 return e;
             }
@@ -426,8 +445,6 @@ namespace PLCMethods {
         if (sizeof(A) + sizeof(B) > stack.size()) return STACK_UNDERFLOW;
         B b = stack.pop_custom<B>();
         A a = stack.pop_custom<A>();
-        a = reverse_byte_order(a);
-        b = reverse_byte_order(b);
         stack.push_custom<B>(b);
         stack.push_custom<A>(a);
         return STATUS_SUCCESS;
@@ -109,6 +109,7 @@ namespace PLCMethods {
     RuntimeError handle_RET(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
         IGNORE_UNUSED u32 index_start = index;
         if (stack.call_stack.size() == 0) return CALL_STACK_UNDERFLOW;
+        if (stack.frameOpen()) return FRAME_NOT_CLOSED;
         u16 ret_index = stack.popCall();
         index = ret_index;
         if (index >= prog_size) return CHECK_PROGRAM_POINTER_BOUNDS_HEAD(program, prog_size, index, index_start);
@@ -118,6 +119,7 @@ namespace PLCMethods {
         IGNORE_UNUSED u32 index_start = index;
         if (stack.call_stack.size() == 0) return CALL_STACK_UNDERFLOW;
         if (stack.pop_bool()) {
+            if (stack.frameOpen()) return FRAME_NOT_CLOSED;
             u16 ret_index = stack.popCall();
             index = ret_index;
             if (index >= prog_size) return CHECK_PROGRAM_POINTER_BOUNDS_HEAD(program, prog_size, index, index_start);
@@ -128,6 +130,7 @@ namespace PLCMethods {
         IGNORE_UNUSED u32 index_start = index;
         if (stack.call_stack.size() == 0) return CALL_STACK_UNDERFLOW;
         if (!stack.pop_bool()) {
+            if (stack.frameOpen()) return FRAME_NOT_CLOSED;
             u16 ret_index = stack.popCall();
             index = ret_index;
             if (index >= prog_size) return CHECK_PROGRAM_POINTER_BOUNDS_HEAD(program, prog_size, index, index_start);
@@ -135,6 +138,18 @@ namespace PLCMethods {
         return STATUS_SUCCESS;
     }
 
+    // A frame is closed by LEAVE in the call that opened it, RET fails while it is open
+    RuntimeError handle_ENTER(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
+        u32 size = 1;
+        if (index + size > prog_size) return PROGRAM_POINTER_OUT_OF_BOUNDS;
+        u8 frame_size = program[index];
+        index += size;
+        return stack.enterFrame(frame_size);
+    }
+    RuntimeError handle_LEAVE(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
+        return stack.leaveFrame();
+    }
+
 
     RuntimeError handle_EXIT(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
         if (index >= prog_size) return STATUS_SUCCESS;
@@ -142,4 +157,9 @@ namespace PLCMethods {
         return (RuntimeError) exit_code;
     }
 
+    RuntimeError handle_NOP(RuntimeStack& stack) { return STATUS_SUCCESS; }
+
+    // EXIT has no operand, it ends the program cycle without an exit code
+    RuntimeError handle_EXIT_PROGRAM(RuntimeStack& stack) { return PROGRAM_EXITED; }
+
 }
\ No newline at end of file
@@ -0,0 +1,114 @@
+// methods-lut.h - 1.0.0 - 2022-12-11
+//
+// Copyright (c) 2022 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+// ################################################################################################
+// Interpolated lookup table (characteristic curve)
+// ################################################################################################
+// LUT_INTERP pops the input value x and the table pointer below it and pushes the piecewise linear interpolation of
+// the table at x. Inputs outside of the table are clamped to the first or the last point. The table is stored in the
+// memory in the same byte order as LOAD and MOVE use, all values are of the instruction data type:
+//
+//    u16 header             - number of points (2 or more) in the low 15 bits, bit 15 set for uniform spacing
+//    { x, y } * count       - breakpoints with ascending x
+// or with uniform spacing:
+//    x0, dx, y * count      - first x, distance between the points (> 0) and the y values
+//
+// f32 tables are interpolated in floating point, i16 tables (also fixed point values of any scale) in integer math.
+
+#define PLCRUNTIME_LUT_UNIFORM 0x8000
+
+namespace PLCMethods {
+
+    // The x positions of a uniform table are computed in the wide type, they can run past the range of the data type
+    template <typename T> struct LutMath;
+    template <> struct LutMath<f32> {
+        typedef f32 wide;
+        static inline f32 interpolate(f32 x, f32 x0, f32 x1, f32 y0, f32 y1) { return y0 + (y1 - y0) * (x - x0) / (x1 - x0); }
+    };
+    template <> struct LutMath<i16> {
+        typedef i32 wide;
+        // The product of two i16 spans does not fit into i32
+        static inline i16 interpolate(i32 x, i32 x0, i32 x1, i16 y0, i16 y1) { return y0 + (i16) ((i64) (y1 - y0) * (x - x0) / (x1 - x0)); }
+    };
+
+    template <typename T> inline T lutRead(plc_memory_t memory, u32 address) {
+        T value;
+        readArea_u8(memory, address, reinterpret_cast<u8*>(&value), sizeof(T));
+        return value;
+    }
+
+    template <typename T> RuntimeError lutInterpolate(RuntimeStack& stack, plc_memory_t memory) {
+        if (stack.size() < sizeof(T) + sizeof(MY_PTR_t)) return STACK_UNDERFLOW;
+        T x = StackValue<T>::pop(stack);
+        u32 address = stack.pop_pointer();
+        if (address + 2 > PLCRUNTIME_MAX_MEMORY_SIZE) return INVALID_MEMORY_ADDRESS;
+        u16 header = lutRead<u16>(memory, address);
+        u32 count = header & ~PLCRUNTIME_LUT_UNIFORM;
+        if (count < 2) return INVALID_MEMORY_SIZE;
+        u32 table = address + 2;
+        const u32 size = sizeof(T);
+        if (header & PLCRUNTIME_LUT_UNIFORM) {
+            if (table + (count + 2) * size > PLCRUNTIME_MAX_MEMORY_SIZE) return INVALID_MEMORY_ADDRESS;
+            typedef typename LutMath<T>::wide W;
+            W x0 = lutRead<T>(memory, table);
+            W dx = lutRead<T>(memory, table + size);
+            if (!(dx > 0)) return EXECUTION_ERROR;
+            u32 ys = table + 2 * size;
+            if (!(x > x0)) return StackValue<T>::push(stack, lutRead<T>(memory, ys));
+            if (!(x < x0 + (W) (count - 1) * dx)) return StackValue<T>::push(stack, lutRead<T>(memory, ys + (count - 1) * size));
+            // Segment index straight from the spacing, no search
+            u32 i = (u32) ((x - x0) / dx);
+            if (i > count - 2) i = count - 2;
+            W xa = x0 + (W) i * dx;
+            T y = LutMath<T>::interpolate(x, xa, xa + dx, lutRead<T>(memory, ys + i * size), lutRead<T>(memory, ys + (i + 1) * size));
+            return StackValue<T>::push(stack, y);
+        }
+        if (table + count * 2 * size > PLCRUNTIME_MAX_MEMORY_SIZE) return INVALID_MEMORY_ADDRESS;
+        const u32 point = 2 * size;
+        if (!(x > lutRead<T>(memory, table))) return StackValue<T>::push(stack, lutRead<T>(memory, table + size));
+        if (!(x < lutRead<T>(memory, table + (count - 1) * point))) return StackValue<T>::push(stack, lutRead<T>(memory, table + (count - 1) * point + size));
+        // Binary search for the segment [lo, lo + 1] with x(lo) < x <= x(lo + 1)
+        u32 lo = 0;
+        u32 hi = count - 1;
+        while (hi - lo > 1) {
+            u32 mid = (lo + hi) >> 1;
+            if (lutRead<T>(memory, table + mid * point) < x) lo = mid;
+            else hi = mid;
+        }
+        u32 a = table + lo * point;
+        u32 b = a + point;
+        T y = LutMath<T>::interpolate(x, lutRead<T>(memory, a), lutRead<T>(memory, b), lutRead<T>(memory, a + size), lutRead<T>(memory, b + size));
+        return StackValue<T>::push(stack, y);
+    }
+
+    RuntimeError handle_LUT_INTERP(RuntimeStack& stack, plc_memory_t memory, u8* program, u32 prog_size, u32& index) {
+        if (index + 1 > prog_size) return PROGRAM_POINTER_OUT_OF_BOUNDS;
+        u8 data_type = program[index++];
+        switch (data_type) {
+            case type_i16: return lutInterpolate<i16>(stack, memory);
+            case type_f32: return lutInterpolate<f32>(stack, memory);
+            default: return INVALID_DATA_TYPE;
+        }
+    }
+
+}
@@ -0,0 +1,205 @@
+// methods-math.h - 1.0.0 - 2022-12-11
+//
+// Copyright (c) 2022 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+// ################################################################################################
+// Templated arithmetic and comparison core
+// ################################################################################################
+// Every typed arithmetic instruction is the same pop-op-push sequence, only the value type and the
+// operation change. The operation is a struct with a static 'apply' method, the value type selects the
+// typed stack accessors through StackValue<T>. The data type operand of the instruction is resolved by
+// the dispatch templates below, one switch per instruction family instead of one function per type.
+
+namespace PLCMethods {
+
+    template <typename T> struct StackValue;
+
+#define PLCRUNTIME_STACK_VALUE(type, name) \
+    template <> struct StackValue<type> { \
+        static inline type pop(RuntimeStack& stack) { return stack.pop_##name(); } \
+        static inline RuntimeError push(RuntimeStack& stack, type value) { return stack.push_##name(value); } \
+    };
+
+    PLCRUNTIME_STACK_VALUE(u8, u8)
+    PLCRUNTIME_STACK_VALUE(u16, u16)
+    PLCRUNTIME_STACK_VALUE(u32, u32)
+    PLCRUNTIME_STACK_VALUE(i8, i8)
+    PLCRUNTIME_STACK_VALUE(i16, i16)
+    PLCRUNTIME_STACK_VALUE(i32, i32)
+    PLCRUNTIME_STACK_VALUE(f32, f32)
+#ifdef USE_X64_OPS
+    PLCRUNTIME_STACK_VALUE(u64, u64)
+    PLCRUNTIME_STACK_VALUE(i64, i64)
+    PLCRUNTIME_STACK_VALUE(f64, f64)
+#endif // USE_X64_OPS
+
+#undef PLCRUNTIME_STACK_VALUE
+
+    // Arithmetic operations
+    struct AddOp { template <typename T> static inline T apply(T a, T b) { return a + b; } };
+    struct SubOp { template <typename T> static inline T apply(T a, T b) { return a - b; } };
+    struct MulOp { template <typename T> static inline T apply(T a, T b) { return a * b; } };
+    struct DivOp { template <typename T> static inline T apply(T a, T b) { return a / b; } };
+    struct ModOp {
+        template <typename T> static inline T apply(T a, T b) { return a % b; }
+        static inline f32 apply(f32 a, f32 b) { return fmod(a, b); }
+#ifdef USE_X64_OPS
+        static inline f64 apply(f64 a, f64 b) { return fmod(a, b); }
+#endif // USE_X64_OPS
+    };
+    struct PowOp {
+        // Integers use exponentiation by squaring, the result wraps around like the other integer operations
+        template <typename T> static inline T apply(T a, T b) {
+            if (b < 0) return a == 1 ? 1 : a == (T) -1 ? ((b & 1) ? a : 1) : 0;
+            T result = 1;
+            while (b) {
+                if (b & 1) result *= a;
+                a *= a;
+                b >>= 1;
+            }
+            return result;
+        }
+        // f32 squares and multiplies for whole exponents, negative ones give the reciprocal, the rest goes to pow()
+        static inline f32 apply(f32 a, f32 b) {
+            if (b <= -2147483648.0f || b >= 2147483648.0f || b != (f32) (i32) b) return pow(a, b);
+            i32 exponent = (i32) b;
+            u32 n = exponent < 0 ? 0 - (u32) exponent : (u32) exponent;
+            f32 result = 1;
+            while (n) {
+                if (n & 1) result *= a;
+                a *= a;
+                n >>= 1;
+            }
+            return exponent < 0 ? 1 / result : result;
+        }
+#ifdef USE_X64_OPS
+        static inline f64 apply(f64 a, f64 b) { return pow(a, b); }
+#endif // USE_X64_OPS
+    };
+    struct NegOp { template <typename T> static inline T apply(T a) { return -a; } };
+    struct AbsOp {
+        template <typename T> static inline T apply(T a) { return a < 0 ? -a : a; }
+#ifdef USE_X64_OPS
+        static inline f64 apply(f64 a) { return fabs(a); }
+#endif // USE_X64_OPS
+    };
+    struct SqrtOp { template <typename T> static inline T apply(T a) { return sqrt(a); } };
+    struct SinOp { template <typename T> static inline T apply(T a) { return sin(a); } };
+    struct CosOp { template <typename T> static inline T apply(T a) { return cos(a); } };
+
+    // Comparison operations
+    struct CmpEqOp { template <typename T> static inline bool apply(T a, T b) { return a == b; } };
+    struct CmpNeqOp { template <typename T> static inline bool apply(T a, T b) { return a != b; } };
+    struct CmpGtOp { template <typename T> static inline bool apply(T a, T b) { return a > b; } };
+    struct CmpGteOp { template <typename T> static inline bool apply(T a, T b) { return a >= b; } };
+    struct CmpLtOp { template <typename T> static inline bool apply(T a, T b) { return a < b; } };
+    struct CmpLteOp { template <typename T> static inline bool apply(T a, T b) { return a <= b; } };
+
+    // [a, b] -> [a op b]
+    template <typename T, typename Op> RuntimeError BinaryOp(RuntimeStack& stack) {
+        T b = StackValue<T>::pop(stack);
+        T a = StackValue<T>::pop(stack);
+        StackValue<T>::push(stack, Op::apply(a, b));
+        return STATUS_SUCCESS;
+    }
+
+    // [a] -> [op a]
+    template <typename T, typename Op> RuntimeError UnaryOp(RuntimeStack& stack) {
+        T a = StackValue<T>::pop(stack);
+        StackValue<T>::push(stack, Op::apply(a));
+        return STATUS_SUCCESS;
+    }
+
+    // [a, b] -> [a op b] as a boolean byte
+    template <typename T, typename Op> RuntimeError CompareOp(RuntimeStack& stack) {
+        T b = StackValue<T>::pop(stack);
+        T a = StackValue<T>::pop(stack);
+        stack.push_u8(Op::apply(a, b));
+        return STATUS_SUCCESS;
+    }
+
+    // Binary operations are defined for every data type, booleans are handled as u8
+    template <typename Op> RuntimeError BinaryOpDispatch(RuntimeStack& stack, u8 data_type) {
+        switch (data_type) {
+            case type_bool:
+            case type_u8: return BinaryOp<u8, Op>(stack);
+            case type_u16: return BinaryOp<u16, Op>(stack);
+            case type_u32: return BinaryOp<u32, Op>(stack);
+            case type_i8: return BinaryOp<i8, Op>(stack);
+            case type_i16: return BinaryOp<i16, Op>(stack);
+            case type_i32: return BinaryOp<i32, Op>(stack);
+            case type_f32: return BinaryOp<f32, Op>(stack);
+#ifdef USE_X64_OPS
+            case type_u64: return BinaryOp<u64, Op>(stack);
+            case type_i64: return BinaryOp<i64, Op>(stack);
+            case type_f64: return BinaryOp<f64, Op>(stack);
+#endif // USE_X64_OPS
+            default: return INVALID_DATA_TYPE;
+        }
+    }
+
+    template <typename Op> RuntimeError CompareOpDispatch(RuntimeStack& stack, u8 data_type) {
+        switch (data_type) {
+            case type_bool:
+            case type_u8: return CompareOp<u8, Op>(stack);
+            case type_u16: return CompareOp<u16, Op>(stack);
+            case type_u32: return CompareOp<u32, Op>(stack);
+            case type_i8: return CompareOp<i8, Op>(stack);
+            case type_i16: return CompareOp<i16, Op>(stack);
+            case type_i32: return CompareOp<i32, Op>(stack);
+            case type_f32: return CompareOp<f32, Op>(stack);
+#ifdef USE_X64_OPS
+            case type_u64: return CompareOp<u64, Op>(stack);
+            case type_i64: return CompareOp<i64, Op>(stack);
+            case type_f64: return CompareOp<f64, Op>(stack);
+#endif // USE_X64_OPS
+            default: return INVALID_DATA_TYPE;
+        }
+    }
+
+    // Sign operations (NEG, ABS) are defined for signed and real types only
+    template <typename Op> RuntimeError SignedOpDispatch(RuntimeStack& stack, u8 data_type) {
+        switch (data_type) {
+            case type_i8: return UnaryOp<i8, Op>(stack);
+            case type_i16: return UnaryOp<i16, Op>(stack);
+            case type_i32: return UnaryOp<i32, Op>(stack);
+            case type_f32: return UnaryOp<f32, Op>(stack);
+#ifdef USE_X64_OPS
+            case type_i64: return UnaryOp<i64, Op>(stack);
+            case type_f64: return UnaryOp<f64, Op>(stack);
+#endif // USE_X64_OPS
+            default: return INVALID_DATA_TYPE;
+        }
+    }
+
+    // Math functions (SQRT, SIN, COS) are defined for real types only
+    template <typename Op> RuntimeError RealOpDispatch(RuntimeStack& stack, u8 data_type) {
+        switch (data_type) {
+            case type_f32: return UnaryOp<f32, Op>(stack);
+#ifdef USE_X64_OPS
+            case type_f64: return UnaryOp<f64, Op>(stack);
+#endif // USE_X64_OPS
+            default: return INVALID_DATA_TYPE;
+        }
+    }
+
+}
@@ -0,0 +1,157 @@
+// methods-string.h - 1.0.0 - 2022-12-11
+//
+// Copyright (c) 2022 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+// ################################################################################################
+// Byte strings
+// ################################################################################################
+// Instructions for parsing and building telegrams in memory buffers. A string is a pointer and a u16 length, both
+// taken from the stack. Every range is checked once before the bytes are touched, an out of bounds range is an
+// INVALID_MEMORY_ADDRESS error. Positions are relative to the start of the buffer. Stack arguments, first pushed first:
+//
+//    STR_FIND_BYTE    ptr buffer, u16 length, u8 byte                     -> u16 position, 0xFFFF if not found
+//    STR_FIND         ptr buffer, u16 length, ptr pattern, u16 length     -> u16 position, 0xFFFF if not found
+//    STR_CMP          ptr a, ptr b, u16 length                            -> i8 -1, 0 or 1 (a < b, a == b, a > b)
+//    STR_COPY_UNTIL   ptr destination, ptr source, u16 length, u8 byte    -> u16 bytes copied, the delimiter excluded
+//    STR_ATOI         ptr buffer, u16 length                              -> i32 value, u16 bytes used (0 if no number)
+//    STR_ITOA         ptr destination, u16 length, i32 value              -> u16 bytes written (0 if it does not fit)
+//
+// STR_ATOI skips spaces before and after an optional '+' or '-' sign and stops at the first non-digit, the value
+// saturates at the i32 range. STR_ITOA writes the decimal digits with a '-' sign for negative values and no terminator.
+
+#define PLCRUNTIME_STR_NOT_FOUND 0xFFFF
+
+namespace PLCMethods {
+
+    inline bool strOutOfBounds(u32 address, u32 length) { return address + length > PLCRUNTIME_MAX_MEMORY_SIZE; }
+
+    RuntimeError handle_STR_FIND_BYTE(RuntimeStack& stack, plc_memory_t memory, u8* program, u32 prog_size, u32& index) {
+        if (stack.size() < sizeof(MY_PTR_t) + 3) return STACK_UNDERFLOW;
+        u8 byte = stack.pop_u8();
+        u16 length = stack.pop_u16();
+        u32 buffer = stack.pop_pointer();
+        if (strOutOfBounds(buffer, length)) return INVALID_MEMORY_ADDRESS;
+        for (u32 i = 0; i < length; i++) {
+            if (peek_u8(memory, buffer + i) == byte) return stack.push_u16(i);
+        }
+        return stack.push_u16(PLCRUNTIME_STR_NOT_FOUND);
+    }
+
+    RuntimeError handle_STR_FIND(RuntimeStack& stack, plc_memory_t memory, u8* program, u32 prog_size, u32& index) {
+        if (stack.size() < 2 * sizeof(MY_PTR_t) + 4) return STACK_UNDERFLOW;
+        u16 pattern_length = stack.pop_u16();
+        u32 pattern = stack.pop_pointer();
+        u16 length = stack.pop_u16();
+        u32 buffer = stack.pop_pointer();
+        if (strOutOfBounds(buffer, length) || strOutOfBounds(pattern, pattern_length)) return INVALID_MEMORY_ADDRESS;
+        if (pattern_length == 0) return stack.push_u16(0);
+        if (pattern_length > length) return stack.push_u16(PLCRUNTIME_STR_NOT_FOUND);
+        u8 first = peek_u8(memory, pattern);
+        for (u32 i = 0; i + pattern_length <= length; i++) {
+            if (peek_u8(memory, buffer + i) != first) continue;
+            u32 j = 1;
+            while (j < pattern_length && peek_u8(memory, buffer + i + j) == peek_u8(memory, pattern + j)) j++;
+            if (j == pattern_length) return stack.push_u16(i);
+        }
+        return stack.push_u16(PLCRUNTIME_STR_NOT_FOUND);
+    }
+
+    RuntimeError handle_STR_CMP(RuntimeStack& stack, plc_memory_t memory, u8* program, u32 prog_size, u32& index) {
+        if (stack.size() < 2 * sizeof(MY_PTR_t) + 2) return STACK_UNDERFLOW;
+        u16 length = stack.pop_u16();
+        u32 b = stack.pop_pointer();
+        u32 a = stack.pop_pointer();
+        if (strOutOfBounds(a, length) || strOutOfBounds(b, length)) return INVALID_MEMORY_ADDRESS;
+        for (u32 i = 0; i < length; i++) {
+            u8 x = peek_u8(memory, a + i);
+            u8 y = peek_u8(memory, b + i);
+            if (x != y) return stack.push_i8(x < y ? -1 : 1);
+        }
+        return stack.push_i8(0);
+    }
+
+    RuntimeError handle_STR_COPY_UNTIL(RuntimeStack& stack, plc_memory_t memory, u8* program, u32 prog_size, u32& index) {
+        if (stack.size() < 2 * sizeof(MY_PTR_t) + 3) return STACK_UNDERFLOW;
+        u8 delimiter = stack.pop_u8();
+        u16 length = stack.pop_u16();
+        u32 source = stack.pop_pointer();
+        u32 destination = stack.pop_pointer();
+        if (strOutOfBounds(source, length) || strOutOfBounds(destination, length)) return INVALID_MEMORY_ADDRESS;
+        u32 count = 0;
+        while (count < length && peek_u8(memory, source + count) != delimiter) count++;
+        // Copied in chunks, so the paged memory is written with one call per chunk
+        u8 chunk[16];
+        for (u32 done = 0; done < count; done += sizeof(chunk)) {
+            u32 size = count - done < sizeof(chunk) ? count - done : sizeof(chunk);
+            for (u32 i = 0; i < size; i++) chunk[i] = peek_u8(memory, source + done + i);
+            if (writeArea_u8(memory, destination + done, chunk, size)) return INVALID_MEMORY_ADDRESS;
+        }
+        return stack.push_u16(count);
+    }
+
+    RuntimeError handle_STR_ATOI(RuntimeStack& stack, plc_memory_t memory, u8* program, u32 prog_size, u32& index) {
+        if (stack.size() < sizeof(MY_PTR_t) + 2) return STACK_UNDERFLOW;
+        u16 length = stack.pop_u16();
+        u32 buffer = stack.pop_pointer();
+        if (strOutOfBounds(buffer, length)) return INVALID_MEMORY_ADDRESS;
+        u32 i = 0;
+        while (i < length && peek_u8(memory, buffer + i) == ' ') i++;
+        bool negative = false;
+        if (i < length && (peek_u8(memory, buffer + i) == '-' || peek_u8(memory, buffer + i) == '+')) {
+            negative = peek_u8(memory, buffer + i++) == '-';
+            while (i < length && peek_u8(memory, buffer + i) == ' ') i++; // Scales pad between the sign and the digits
+        }
+        u32 digits = i;
+        u32 limit = negative ? 0x80000000 : 0x7FFFFFFF;
+        u32 value = 0;
+        for (; i < length; i++) {
+            u8 c = peek_u8(memory, buffer + i);
+            if (c < '0' || c > '9') break;
+            u32 digit = c - '0';
+            value = value > (limit - digit) / 10 ? limit : value * 10 + digit;
+        }
+        if (i == digits) i = 0; // No digits, not even the spaces and the sign are used
+        RuntimeError status = stack.push_i32(negative ? (i32) (0 - value) : (i32) value);
+        if (status != STATUS_SUCCESS) return status;
+        return stack.push_u16(i);
+    }
+
+    RuntimeError handle_STR_ITOA(RuntimeStack& stack, plc_memory_t memory, u8* program, u32 prog_size, u32& index) {
+        if (stack.size() < sizeof(MY_PTR_t) + 6) return STACK_UNDERFLOW;
+        i32 value = stack.pop_i32();
+        u16 length = stack.pop_u16();
+        u32 destination = stack.pop_pointer();
+        if (strOutOfBounds(destination, length)) return INVALID_MEMORY_ADDRESS;
+        u8 text[11];
+        u32 size = 0;
+        u32 magnitude = value < 0 ? 0 - (u32) value : (u32) value;
+        do {
+            text[sizeof(text) - 1 - size++] = '0' + magnitude % 10;
+            magnitude /= 10;
+        } while (magnitude);
+        if (value < 0) text[sizeof(text) - 1 - size++] = '-';
+        if (size > length) return stack.push_u16(0);
+        if (writeArea_u8(memory, destination, text + sizeof(text) - size, size)) return INVALID_MEMORY_ADDRESS;
+        return stack.push_u16(size);
+    }
+
+}
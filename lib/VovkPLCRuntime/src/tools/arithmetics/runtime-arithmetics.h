@@ -22,359 +22,41 @@
 #pragma once
 
 #include "runtime-parsing.h"
-#include "math-u8.h"
-#include "math-u16.h"
-#include "math-u32.h"
-#include "math-i8.h"
-#include "math-i16.h"
-#include "math-i32.h"
-#include "math-f32.h"
-#ifdef USE_X64_OPS
-#include "math-u64.h"
-#include "math-i64.h"
-#include "math-f64.h"
-#endif // USE_X64_OPS
+#include "methods-math.h"
 #include "memory-manipulation.h"
 #include "methods-bitwise.h"
 #include "methods-logic.h"
-#include "methods-comparison.h"
 #include "methods-flow.h"
+#include "methods-lut.h"
+#include "methods-string.h"
 
 namespace PLCMethods {
 
-    RuntimeError handle_ADD(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
-        u32 size = 1;
-        if (index + size > prog_size) return PROGRAM_POINTER_OUT_OF_BOUNDS;
+    // Reads the data type operand of the instruction and runs the typed operation for it
+    template <RuntimeError(*Dispatch)(RuntimeStack&, u8)> RuntimeError handle_typed(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
+        if (index + 1 > prog_size) return PROGRAM_POINTER_OUT_OF_BOUNDS;
         u8 data_type = program[index++];
-        switch (data_type) {
-            case type_bool:
-            case type_u8: return ADD_uint8_t(stack);
-            case type_u16: return ADD_uint16_t(stack);
-            case type_u32: return ADD_uint32_t(stack);
-            case type_i8: return ADD_int8_t(stack);
-            case type_i16: return ADD_int16_t(stack);
-            case type_i32: return ADD_int32_t(stack);
-            case type_f32: return ADD_float(stack);
-#ifdef USE_X64_OPS
-            case type_u64: return ADD_uint64_t(stack);
-            case type_i64: return ADD_int64_t(stack);
-            case type_f64: return ADD_double(stack);
-#endif // USE_X64_OPS
-            default: return INVALID_DATA_TYPE;
-        }
-    }
-
-    RuntimeError handle_SUB(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
-        u32 size = 1;
-        if (index + size > prog_size) return PROGRAM_POINTER_OUT_OF_BOUNDS;
-        u8 data_type = program[index++];
-        switch (data_type) {
-            case type_bool:
-            case type_u8: return SUB_uint8_t(stack);
-            case type_u16: return SUB_uint16_t(stack);
-            case type_u32: return SUB_uint32_t(stack);
-            case type_i8: return SUB_int8_t(stack);
-            case type_i16: return SUB_int16_t(stack);
-            case type_i32: return SUB_int32_t(stack);
-            case type_f32: return SUB_float(stack);
-#ifdef USE_X64_OPS
-            case type_u64: return SUB_uint64_t(stack);
-            case type_i64: return SUB_int64_t(stack);
-            case type_f64: return SUB_double(stack);
-#endif // USE_X64_OPS
-            default: return INVALID_DATA_TYPE;
-        }
-    }
-
-    RuntimeError handle_MUL(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
-        u32 size = 1;
-        if (index + size > prog_size) return PROGRAM_POINTER_OUT_OF_BOUNDS;
-        u8 data_type = program[index++];
-        switch (data_type) {
-            case type_bool:
-            case type_u8: return MUL_uint8_t(stack);
-            case type_u16: return MUL_uint16_t(stack);
-            case type_u32: return MUL_uint32_t(stack);
-            case type_i8: return MUL_int8_t(stack);
-            case type_i16: return MUL_int16_t(stack);
-            case type_i32: return MUL_int32_t(stack);
-            case type_f32: return MUL_float(stack);
-#ifdef USE_X64_OPS
-            case type_u64: return MUL_uint64_t(stack);
-            case type_i64: return MUL_int64_t(stack);
-            case type_f64: return MUL_double(stack);
-#endif // USE_X64_OPS
-            default: return INVALID_DATA_TYPE;
-        }
-    }
-
-    RuntimeError handle_DIV(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
-        u32 size = 1;
-        if (index + size > prog_size) return PROGRAM_POINTER_OUT_OF_BOUNDS;
-        u8 data_type = program[index++];
-        switch (data_type) {
-            case type_bool:
-            case type_u8: return DIV_uint8_t(stack);
-            case type_u16: return DIV_uint16_t(stack);
-            case type_u32: return DIV_uint32_t(stack);
-            case type_i8: return DIV_int8_t(stack);
-            case type_i16: return DIV_int16_t(stack);
-            case type_i32: return DIV_int32_t(stack);
-            case type_f32: return DIV_float(stack);
-#ifdef USE_X64_OPS
-            case type_u64: return DIV_uint64_t(stack);
-            case type_i64: return DIV_int64_t(stack);
-            case type_f64: return DIV_double(stack);
-#endif // USE_X64_OPS
-            default: return INVALID_DATA_TYPE;
-        }
-    }
-
-    RuntimeError handle_MOD(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
-        u32 size = 1;
-        if (index + size > prog_size) return PROGRAM_POINTER_OUT_OF_BOUNDS;
-        u8 data_type = program[index++];
-        switch (data_type) {
-            case type_bool:
-            case type_u8: return MOD_uint8_t(stack);
-            case type_u16: return MOD_uint16_t(stack);
-            case type_u32: return MOD_uint32_t(stack);
-            case type_i8: return MOD_int8_t(stack);
-            case type_i16: return MOD_int16_t(stack);
-            case type_i32: return MOD_int32_t(stack);
-            case type_f32: return MOD_float(stack);
-#ifdef USE_X64_OPS
-            case type_u64: return MOD_uint64_t(stack);
-            case type_i64: return MOD_int64_t(stack);
-            case type_f64: return MOD_double(stack);
-#endif // USE_X64_OPS
-            default: return INVALID_DATA_TYPE;
-        }
-    }
-
-    RuntimeError handle_POW(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
-        u32 size = 1;
-        if (index + size > prog_size) return PROGRAM_POINTER_OUT_OF_BOUNDS;
-        u8 data_type = program[index++];
-        switch (data_type) {
-            case type_bool:
-            case type_u8: return POW_uint8_t(stack);
-            case type_u16: return POW_uint16_t(stack);
-            case type_u32: return POW_uint32_t(stack);
-            case type_i8: return POW_int8_t(stack);
-            case type_i16: return POW_int16_t(stack);
-            case type_i32: return POW_int32_t(stack);
-            case type_f32: return POW_float(stack);
-#ifdef USE_X64_OPS
-            case type_u64: return POW_uint64_t(stack);
-            case type_i64: return POW_int64_t(stack);
-            case type_f64: return POW_double(stack);
-#endif // USE_X64_OPS
-            default: return INVALID_DATA_TYPE;
-        }
-    }
-
-    RuntimeError handle_NEG(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
-        u32 size = 0;
-        if (index + size > prog_size) return PROGRAM_POINTER_OUT_OF_BOUNDS;
-        u8 data_type = program[index++];
-        switch (data_type) {
-            case type_i8: return NEG_int8_t(stack);
-            case type_i16: return NEG_int16_t(stack);
-            case type_i32: return NEG_int32_t(stack);
-            case type_f32: return NEG_float(stack);
-#ifdef USE_X64_OPS
-            case type_i64: return NEG_int64_t(stack);
-            case type_f64: return NEG_double(stack);
-#endif // USE_X64_OPS
-            default: return INVALID_DATA_TYPE;
-        }
-    }
-
-RuntimeError handle_ABS(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
-        u32 size = 0;
-        if (index + size > prog_size) return PROGRAM_POINTER_OUT_OF_BOUNDS;
-        u8 data_type = program[index++];
-        switch (data_type) {
-            case type_i8: return ABS_int8_t(stack);
-            case type_i16: return ABS_int16_t(stack);
-            case type_i32: return ABS_int32_t(stack);
-            case type_f32: return ABS_float(stack);
-#ifdef USE_X64_OPS
-            case type_i64: return ABS_int64_t(stack);
-            case type_f64: return ABS_double(stack);
-#endif // USE_X64_OPS
-            default: return INVALID_DATA_TYPE;
-        }
-    }
-
-    RuntimeError handle_SQRT(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
-        u32 size = 0;
-        if (index + size > prog_size) return PROGRAM_POINTER_OUT_OF_BOUNDS;
-        u8 data_type = program[index++];
-        switch (data_type) {
-            case type_f32: return SQRT_float(stack);
-#ifdef USE_X64_OPS
-            case type_f64: return SQRT_double(stack);
-#endif // USE_X64_OPS
-            default: return INVALID_DATA_TYPE;
-        }
-    }
-
-    RuntimeError handle_SIN(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
-        u32 size = 0;
-        if (index + size > prog_size) return PROGRAM_POINTER_OUT_OF_BOUNDS;
-        u8 data_type = program[index++];
-        switch (data_type) {
-            case type_f32: return SIN_float(stack);
-#ifdef USE_X64_OPS
-            case type_f64: return SIN_double(stack);
-#endif // USE_X64_OPS
-            default: return INVALID_DATA_TYPE;
-        }
-    }
-
-    RuntimeError handle_COS(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
-        u32 size = 0;
-        if (index + size > prog_size) return PROGRAM_POINTER_OUT_OF_BOUNDS;
-        u8 data_type = program[index++];
-        switch (data_type) {
-            case type_f32: return COS_float(stack);
-#ifdef USE_X64_OPS
-            case type_f64: return COS_double(stack);
-#endif // USE_X64_OPS
-            default: return INVALID_DATA_TYPE;
-        }
+        return Dispatch(stack, data_type);
     }
 
+    RuntimeError handle_ADD(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) { return handle_typed<BinaryOpDispatch<AddOp> >(stack, program, prog_size, index); }
+    RuntimeError handle_SUB(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) { return handle_typed<BinaryOpDispatch<SubOp> >(stack, program, prog_size, index); }
+    RuntimeError handle_MUL(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) { return handle_typed<BinaryOpDispatch<MulOp> >(stack, program, prog_size, index); }
+    RuntimeError handle_DIV(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) { return handle_typed<BinaryOpDispatch<DivOp> >(stack, program, prog_size, index); }
+    RuntimeError handle_MOD(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) { return handle_typed<BinaryOpDispatch<ModOp> >(stack, program, prog_size, index); }
+    RuntimeError handle_POW(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) { return handle_typed<BinaryOpDispatch<PowOp> >(stack, program, prog_size, index); }
+    RuntimeError handle_NEG(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) { return handle_typed<SignedOpDispatch<NegOp> >(stack, program, prog_size, index); }
+    RuntimeError handle_ABS(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) { return handle_typed<SignedOpDispatch<AbsOp> >(stack, program, prog_size, index); }
+    RuntimeError handle_SQRT(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) { return handle_typed<RealOpDispatch<SqrtOp> >(stack, program, prog_size, index); }
+    RuntimeError handle_SIN(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) { return handle_typed<RealOpDispatch<SinOp> >(stack, program, prog_size, index); }
+    RuntimeError handle_COS(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) { return handle_typed<RealOpDispatch<CosOp> >(stack, program, prog_size, index); }
 
     // Comparison operators
-    RuntimeError handle_CMP_EQ(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
-        u32 size = 1;
-        if (index + size > prog_size) return PROGRAM_POINTER_OUT_OF_BOUNDS;
-        u8 data_type = program[index++];
-        switch (data_type) {
-            case type_bool:
-            case type_u8: return CMP_EQ_uint8_t(stack);
-            case type_u16: return CMP_EQ_uint16_t(stack);
-            case type_u32: return CMP_EQ_uint32_t(stack);
-            case type_i8: return CMP_EQ_int8_t(stack);
-            case type_i16: return CMP_EQ_int16_t(stack);
-            case type_i32: return CMP_EQ_int32_t(stack);
-            case type_f32: return CMP_EQ_float(stack);
-#ifdef USE_X64_OPS
-            case type_u64: return CMP_EQ_uint64_t(stack);
-            case type_i64: return CMP_EQ_int64_t(stack);
-            case type_f64: return CMP_EQ_double(stack);
-#endif // USE_X64_OPS
-            default: return INVALID_DATA_TYPE;
-        }
-    }
-    RuntimeError handle_CMP_NEQ(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
-        u32 size = 1;
-        if (index + size > prog_size) return PROGRAM_POINTER_OUT_OF_BOUNDS;
-        u8 data_type = program[index++];
-        switch (data_type) {
-            case type_bool:
-            case type_u8: return CMP_NEQ_uint8_t(stack);
-            case type_u16: return CMP_NEQ_uint16_t(stack);
-            case type_u32: return CMP_NEQ_uint32_t(stack);
-            case type_i8: return CMP_NEQ_int8_t(stack);
-            case type_i16: return CMP_NEQ_int16_t(stack);
-            case type_i32: return CMP_NEQ_int32_t(stack);
-            case type_f32: return CMP_NEQ_float(stack);
-#ifdef USE_X64_OPS
-            case type_u64: return CMP_NEQ_uint64_t(stack);
-            case type_i64: return CMP_NEQ_int64_t(stack);
-            case type_f64: return CMP_NEQ_double(stack);
-#endif // USE_X64_OPS
-            default: return INVALID_DATA_TYPE;
-        }
-    }
-    RuntimeError handle_CMP_GT(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
-        u32 size = 1;
-        if (index + size > prog_size) return PROGRAM_POINTER_OUT_OF_BOUNDS;
-        u8 data_type = program[index++];
-        switch (data_type) {
-            case type_bool:
-            case type_u8: return CMP_GT_uint8_t(stack);
-            case type_u16: return CMP_GT_uint16_t(stack);
-            case type_u32: return CMP_GT_uint32_t(stack);
-            case type_i8: return CMP_GT_int8_t(stack);
-            case type_i16: return CMP_GT_int16_t(stack);
-            case type_i32: return CMP_GT_int32_t(stack);
-            case type_f32: return CMP_GT_float(stack);
-#ifdef USE_X64_OPS
-            case type_u64: return CMP_GT_uint64_t(stack);
-            case type_i64: return CMP_GT_int64_t(stack);
-            case type_f64: return CMP_GT_double(stack);
-#endif // USE_X64_OPS
-            default: return INVALID_DATA_TYPE;
-        }
-    }
-    RuntimeError handle_CMP_GTE(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
-        u32 size = 1;
-        if (index + size > prog_size) return PROGRAM_POINTER_OUT_OF_BOUNDS;
-        u8 data_type = program[index++];
-        switch (data_type) {
-            case type_bool:
-            case type_u8: return CMP_GTE_uint8_t(stack);
-            case type_u16: return CMP_GTE_uint16_t(stack);
-            case type_u32: return CMP_GTE_uint32_t(stack);
-            case type_i8: return CMP_GTE_int8_t(stack);
-            case type_i16: return CMP_GTE_int16_t(stack);
-            case type_i32: return CMP_GTE_int32_t(stack);
-            case type_f32: return CMP_GTE_float(stack);
-#ifdef USE_X64_OPS
-            case type_u64: return CMP_GTE_uint64_t(stack);
-            case type_i64: return CMP_GTE_int64_t(stack);
-            case type_f64: return CMP_GTE_double(stack);
-#endif // USE_X64_OPS
-            default: return INVALID_DATA_TYPE;
-        }
-    }
-    RuntimeError handle_CMP_LT(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
-        u32 size = 1;
-        if (index + size > prog_size) return PROGRAM_POINTER_OUT_OF_BOUNDS;
-        u8 data_type = program[index++];
-        switch (data_type) {
-            case type_bool:
-            case type_u8: return CMP_LT_uint8_t(stack);
-            case type_u16: return CMP_LT_uint16_t(stack);
-            case type_u32: return CMP_LT_uint32_t(stack);
-            case type_i8: return CMP_LT_int8_t(stack);
-            case type_i16: return CMP_LT_int16_t(stack);
-            case type_i32: return CMP_LT_int32_t(stack);
-            case type_f32: return CMP_LT_float(stack);
-#ifdef USE_X64_OPS
-            case type_u64: return CMP_LT_uint64_t(stack);
-            case type_i64: return CMP_LT_int64_t(stack);
-            case type_f64: return CMP_LT_double(stack);
-#endif // USE_X64_OPS
-            default: return INVALID_DATA_TYPE;
-        }
-    }
-    RuntimeError handle_CMP_LTE(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
-        u32 size = 1;
-        if (index + size > prog_size) return PROGRAM_POINTER_OUT_OF_BOUNDS;
-        u8 data_type = program[index++];
-        switch (data_type) {
-            case type_bool:
-            case type_u8: return CMP_LTE_uint8_t(stack);
-            case type_u16: return CMP_LTE_uint16_t(stack);
-            case type_u32: return CMP_LTE_uint32_t(stack);
-            case type_i8: return CMP_LTE_int8_t(stack);
-            case type_i16: return CMP_LTE_int16_t(stack);
-            case type_i32: return CMP_LTE_int32_t(stack);
-            case type_f32: return CMP_LTE_float(stack);
-#ifdef USE_X64_OPS
-            case type_u64: return CMP_LTE_uint64_t(stack);
-            case type_i64: return CMP_LTE_int64_t(stack);
-            case type_f64: return CMP_LTE_double(stack);
-#endif // USE_X64_OPS
-            default: return INVALID_DATA_TYPE;
-        }
-    }
+    RuntimeError handle_CMP_EQ(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) { return handle_typed<CompareOpDispatch<CmpEqOp> >(stack, program, prog_size, index); }
+    RuntimeError handle_CMP_NEQ(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) { return handle_typed<CompareOpDispatch<CmpNeqOp> >(stack, program, prog_size, index); }
+    RuntimeError handle_CMP_GT(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) { return handle_typed<CompareOpDispatch<CmpGtOp> >(stack, program, prog_size, index); }
+    RuntimeError handle_CMP_GTE(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) { return handle_typed<CompareOpDispatch<CmpGteOp> >(stack, program, prog_size, index); }
+    RuntimeError handle_CMP_LT(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) { return handle_typed<CompareOpDispatch<CmpLtOp> >(stack, program, prog_size, index); }
+    RuntimeError handle_CMP_LTE(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) { return handle_typed<CompareOpDispatch<CmpLteOp> >(stack, program, prog_size, index); }
 
 }
-
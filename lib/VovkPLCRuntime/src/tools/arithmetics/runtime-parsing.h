@@ -86,9 +86,9 @@ struct Extract_t {
     static RuntimeError type_pointer(u8* bytecode, u32 bytecode_size, u32& index, MY_PTR_t* value) {
         u32 size = sizeof(MY_PTR_t);
         if (index + size > bytecode_size) return PROGRAM_SIZE_EXCEEDED;
-        // *value = bytecode[index];
+        *value = 0;
         for (u8 i = 0; i < size; i++) {
-            ((u8*) value)[i] = bytecode[index + i];
+            *value = (*value << 8) | bytecode[index + i];
         }
         index += size;
         return STATUS_SUCCESS;
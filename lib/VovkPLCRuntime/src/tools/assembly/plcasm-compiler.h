@@ -642,7 +642,7 @@ bool add_token(char* string, int length) {
         // If [keyword , - , number] then change to [keyword , -number]
 
         bool skip = false;
-        if (p1_type == TOKEN_OPERATOR && p2_type == TOKEN_KEYWORD) {
+        if (p1_type == TOKEN_OPERATOR && p1_token == "-" && p2_type == TOKEN_KEYWORD) {
             if (token.type == TOKEN_INTEGER) {
                 p1_token.value_int = -token.value_int;
                 p1_token.type = TOKEN_INTEGER;
@@ -757,8 +757,8 @@ bool tokenize() {
             continue;
         }
 
-        // c == # || c == /
-        if (c == '#' || c == '/') {
+        // c == # || c == //
+        if (c == '#' || (c == '/' && c1 == '/')) {
             error = add_token_optional(token_start, token_length);
             if (error) return error;
             while (i < assembly_string_length && assembly_string[i] != '\n') i++;
@@ -1060,8 +1060,414 @@ bool buildErrorExpectedInt(Token token) { return buildError(token, "unexpected t
 bool buildErrorExpectedFloat(Token token) { return buildError(token, "unexpected token, expected float"); }
 bool buildErrorUnknownLabel(Token token) { return buildError(token, "unknown label"); }
 
+// ################################################################################################
+// Infix expression compiler
+// ################################################################################################
+// Usage: <type>.expr <infix expression>
+// The expression is parsed into a tree and compiled into stack code which leaves the result on the stack.
+//  - operands:  numeric literals, const names, memory tags '[address]' or '[const_name]' (loaded as <type>)
+//  - operators: + - * / % and unary -
+//  - functions: sqrt(x), sin(x), cos(x), abs(x), pow(x, y)
+// Example:
+/*
+    const a = 0
+    const b = 4
+    ptr.const 8
+    f32.expr 10 * (1 - [a] * ([b] + 2.5) / 4)
+    f32.move
+*/
+// Code generation:
+//  - constant subtrees are folded at compile time
+//  - identical subtrees are shared (hash-consed), so 'x op x' is compiled as 'x, copy, op'
+//  - operands are ordered by their stack need (Sethi-Ullman), so the deeper subtree is evaluated first.
+//    Non-commutative operators evaluated in reverse order are followed by a 'swap'.
+//    This keeps right-nested expressions at a constant stack depth instead of growing with every nesting level.
+
+#define MAX_EXPR_NODES 256
+
+enum ExprNodeKind {
+    EXPR_CONST = 0,
+    EXPR_LOAD,
+    EXPR_UNARY,
+    EXPR_BINARY,
+};
+
+struct ExprNode {
+    ExprNodeKind kind;
+    PLCRuntimeInstructionSet op;
+    int a;
+    int b;
+    i64 value_int;
+    float value_float;
+    int need;
+};
+
+ExprNode expr_nodes[MAX_EXPR_NODES] = { };
+int expr_node_count = 0;
+int expr_token_index = 0;
+int expr_token_end = 0;
+u8 expr_type = 0;
+
+bool exprIsReal() { return expr_type == type_f32 || expr_type == type_f64; }
+bool exprIsSigned() { return expr_type == type_i8 || expr_type == type_i16 || expr_type == type_i32 || expr_type == type_i64; }
+
+// Wrap an integer to the width of the expression type, so folded constants overflow the same way the runtime does
+i64 exprWrapInt(i64 value) {
+    switch (expr_type) {
+        case type_bool: return value != 0;
+        case type_u8: return (u8) value;
+        case type_i8: return (i8) value;
+        case type_u16: return (u16) value;
+        case type_i16: return (i16) value;
+        case type_u32: return (u32) value;
+        case type_i32: return (i32) value;
+        default: return value;
+    }
+}
+
+bool exprOpIsCommutative(PLCRuntimeInstructionSet op) {
+    return op == ADD || op == MUL;
+}
+
+// Returns the index of an existing identical node or creates a new one. Returns -1 if the node pool is full.
+int exprNode(ExprNodeKind kind, PLCRuntimeInstructionSet op, int a, int b, i64 value_int, float value_float) {
+    for (int i = 0; i < expr_node_count; i++) {
+        ExprNode& n = expr_nodes[i];
+        if (n.kind != kind || n.op != op || n.a != a || n.b != b) continue;
+        if (kind == EXPR_CONST && (n.value_int != value_int || n.value_float != value_float)) continue;
+        if (kind == EXPR_LOAD && n.value_int != value_int) continue;
+        return i;
+    }
+    if (expr_node_count >= MAX_EXPR_NODES) return -1;
+    ExprNode& n = expr_nodes[expr_node_count];
+    n.kind = kind;
+    n.op = op;
+    n.a = a;
+    n.b = b;
+    n.value_int = value_int;
+    n.value_float = value_float;
+    n.need = 1;
+    if (kind == EXPR_UNARY) n.need = expr_nodes[a].need;
+    if (kind == EXPR_BINARY) {
+        int l = expr_nodes[a].need;
+        int r = expr_nodes[b].need;
+        if (a == b) n.need = l > 2 ? l : 2; // x, copy, op
+        else n.need = l == r ? l + 1 : (l > r ? l : r);
+    }
+    return expr_node_count++;
+}
+
+int exprConst(i64 value_int, float value_float) {
+    if (exprIsReal()) return exprNode(EXPR_CONST, NOP, -1, -1, 0, value_float);
+    return exprNode(EXPR_CONST, NOP, -1, -1, exprWrapInt(value_int), 0);
+}
+
+int exprUnary(PLCRuntimeInstructionSet op, int a) {
+    if (a < 0) return -1;
+    ExprNode& n = expr_nodes[a];
+    if (n.kind == EXPR_CONST) { // Constant folding
+        if (exprIsReal()) {
+            float x = n.value_float;
+            if (op == NEG) return exprConst(0, -x);
+            if (op == ABS) return exprConst(0, x < 0 ? -x : x);
+            if (op == SQRT) return exprConst(0, sqrt(x));
+            if (op == SIN) return exprConst(0, sin(x));
+            if (op == COS) return exprConst(0, cos(x));
+        } else {
+            u64 x = n.value_int;
+            if (op == NEG) return exprConst(0 - x, 0);
+            if (op == ABS) return exprConst(n.value_int < 0 ? 0 - x : x, 0);
+        }
+    }
+    if (op == NEG && n.kind == EXPR_UNARY && n.op == NEG) return n.a; // -(-x) => x
+    return exprNode(EXPR_UNARY, op, a, -1, 0, 0);
+}
+
+int exprBinary(PLCRuntimeInstructionSet op, int a, int b) {
+    if (a < 0 || b < 0) return -1;
+    ExprNode& x = expr_nodes[a];
+    ExprNode& y = expr_nodes[b];
+    if (x.kind == EXPR_CONST && y.kind == EXPR_CONST) { // Constant folding
+        if (exprIsReal()) {
+            float p = x.value_float;
+            float q = y.value_float;
+            if (op == ADD) return exprConst(0, p + q);
+            if (op == SUB) return exprConst(0, p - q);
+            if (op == MUL) return exprConst(0, p * q);
+            if (op == DIV) return exprConst(0, p / q);
+            // Only small whole exponents are folded, by squaring like the f32 runtime, the rest is left to it
+            if (op == POW && q >= 0 && q <= 255 && q == (int) q) {
+                float result = 1;
+                for (int n = (int) q; n; n >>= 1) {
+                    if (n & 1) result *= p;
+                    p *= p;
+                }
+                return exprConst(0, result);
+            }
+        } else {
+            // Computed in 64 bits without overflow and wrapped to the width of the type by exprConst()
+            u64 p = x.value_int;
+            u64 q = y.value_int;
+            if (op == ADD) return exprConst(p + q, 0);
+            if (op == SUB) return exprConst(p - q, 0);
+            if (op == MUL) return exprConst(p * q, 0);
+            // Division is only folded where C integer division matches the runtime for every type
+            if (op == DIV && x.value_int >= 0 && y.value_int > 0) return exprConst(p / q, 0);
+            if (op == MOD && x.value_int >= 0 && y.value_int > 0) return exprConst(p % q, 0);
+            // Exponentiation by squaring like the runtime, negative exponents are left to it
+            if (op == POW && y.value_int >= 0) {
+                u64 result = 1;
+                for (; q; q >>= 1, p *= p) if (q & 1) result *= p;
+                return exprConst(result, 0);
+            }
+        }
+    }
+    // Keep constants on the right side of commutative operators, so equal expressions get the same node
+    if (exprOpIsCommutative(op) && x.kind == EXPR_CONST && y.kind != EXPR_CONST) {
+        int t = a; a = b; b = t;
+    }
+    return exprNode(EXPR_BINARY, op, a, b, 0, 0);
+}
+
+bool exprHasToken() { return expr_token_index < expr_token_end; }
+Token& exprToken() { return tokens[expr_token_index]; }
+
+// The tokenizer merges [keyword , - , number] into a negative number token, which inside an expression is a binary minus
+bool exprIsMergedMinus(Token& token) {
+    return (token.type == TOKEN_INTEGER || token.type == TOKEN_REAL) && token == "-";
+}
+
+bool exprIsOperator(Token& token, const char* op) {
+    return (token.type == TOKEN_OPERATOR || token.type == TOKEN_KEYWORD) && token == op;
+}
+
+bool exprError(const char* message) {
+    Token& token = exprHasToken() ? exprToken() : tokens[expr_token_end - 1];
+    return buildError(token, message);
+}
+
+bool exprParseSum(int& output);
+
+bool exprExpect(const char* op) {
+    if (!exprHasToken() || !exprIsOperator(exprToken(), op)) return true;
+    expr_token_index++;
+    return false;
+}
+
+bool exprParseOperand(int& output) {
+    if (!exprHasToken()) return exprError("unexpected end of expression");
+    Token& token = exprToken();
+    if (exprIsOperator(token, "-")) { // Unary minus
+        expr_token_index++;
+        int a;
+        if (exprParseOperand(a)) return true;
+        output = exprIsSigned() || exprIsReal() ? exprUnary(NEG, a) : exprBinary(SUB, exprConst(0, 0), a);
+        if (output < 0) return exprError("expression is too complex");
+        return false;
+    }
+    if (exprIsOperator(token, "(")) {
+        expr_token_index++;
+        if (exprParseSum(output)) return true;
+        if (exprExpect(")")) return exprError("expected ')'");
+        return false;
+    }
+    if (exprIsOperator(token, "[")) { // Memory tag
+        expr_token_index++;
+        int address = 0;
+        if (!exprHasToken() || intFromToken(exprToken(), address)) return exprError("expected memory address");
+        expr_token_index++;
+        if (exprExpect("]")) return exprError("expected ']'");
+        output = exprNode(EXPR_LOAD, LOAD, -1, -1, address, 0);
+        if (output < 0) return exprError("expression is too complex");
+        return false;
+    }
+    if (token.type == TOKEN_KEYWORD) {
+        PLCRuntimeInstructionSet function = NOP;
+        if (token == "sqrt") function = SQRT;
+        if (token == "sin") function = SIN;
+        if (token == "cos") function = COS;
+        if (token == "abs") function = ABS;
+        if (token == "pow") function = POW;
+        if (function != NOP) {
+            expr_token_index++;
+            if (exprExpect("(")) return exprError("expected '('");
+            int a, b = -1;
+            if (exprParseSum(a)) return true;
+            if (function == POW) {
+                if (exprExpect(",")) return exprError("expected ','");
+                if (exprParseSum(b)) return true;
+            }
+            if (exprExpect(")")) return exprError("expected ')'");
+            if ((function == SQRT || function == SIN || function == COS) && !exprIsReal()) return buildError(token, "function requires a floating point type");
+            if (function == ABS && !exprIsSigned() && !exprIsReal()) output = a;
+            else output = function == POW ? exprBinary(POW, a, b) : exprUnary(function, a);
+            if (output < 0) return exprError("expression is too complex");
+            return false;
+        }
+    }
+    // Literal or const name
+    int value_int = 0;
+    float value_float = 0;
+    bool e_int = intFromToken(token, value_int);
+    bool e_real = realFromToken(token, value_float);
+    if (exprIsReal() ? e_real : e_int) return exprError(exprIsReal() ? "unexpected token, expected float" : "unexpected token, expected integer");
+    if (!exprIsReal() && token.type == TOKEN_REAL) return buildErrorExpectedInt(token);
+    expr_token_index++;
+    output = exprConst(value_int, value_float);
+    if (output < 0) return exprError("expression is too complex");
+    return false;
+}
+
+bool exprParseProduct(int& output) {
+    if (exprParseOperand(output)) return true;
+    while (exprHasToken()) {
+        Token& token = exprToken();
+        PLCRuntimeInstructionSet op = NOP;
+        if (exprIsOperator(token, "*")) op = MUL;
+        if (exprIsOperator(token, "/")) op = DIV;
+        if (exprIsOperator(token, "%")) op = MOD;
+        if (op == NOP) break;
+        expr_token_index++;
+        int b;
+        if (exprParseOperand(b)) return true;
+        output = exprBinary(op, output, b);
+        if (output < 0) return exprError("expression is too complex");
+    }
+    return false;
+}
+
+bool exprParseSum(int& output) {
+    if (exprParseProduct(output)) return true;
+    while (exprHasToken()) {
+        Token& token = exprToken();
+        PLCRuntimeInstructionSet op = NOP;
+        if (exprIsOperator(token, "+")) op = ADD;
+        if (exprIsOperator(token, "-")) op = SUB;
+        int b;
+        if (op != NOP) {
+            expr_token_index++;
+            if (exprParseProduct(b)) return true;
+        } else if (exprIsMergedMinus(token)) {
+            // [x , -5] => x - 5 (the token holds the negated literal)
+            op = SUB;
+            b = exprConst(-token.value_int, -token.value_float);
+            expr_token_index++;
+            while (exprHasToken()) { // Continue the product started by the merged literal
+                Token& next = exprToken();
+                PLCRuntimeInstructionSet mul_op = NOP;
+                if (exprIsOperator(next, "*")) mul_op = MUL;
+                if (exprIsOperator(next, "/")) mul_op = DIV;
+                if (exprIsOperator(next, "%")) mul_op = MOD;
+                if (mul_op == NOP) break;
+                expr_token_index++;
+                int c;
+                if (exprParseOperand(c)) return true;
+                b = exprBinary(mul_op, b, c);
+                if (b < 0) return exprError("expression is too complex");
+            }
+        } else break;
+        output = exprBinary(op, output, b);
+        if (output < 0) return exprError("expression is too complex");
+    }
+    return false;
+}
+
+bool exprEmit(Token& token, u8* code, int size) {
+    address_end = built_bytecode_length + size;
+    if (address_end >= PLCRUNTIME_MAX_PROGRAM_SIZE) return buildErrorSizeLimit(token);
+    for (int j = 0; j < size; j++) {
+        built_bytecode[built_bytecode_length + j] = code[j];
+        crc8_simple(built_bytecode_checksum, code[j]);
+    }
+    built_bytecode_length = address_end;
+    return false;
+}
+
+bool exprEmitConst(Token& token, ExprNode& n) {
+    u8 code[16];
+    int size = 0;
+    switch (expr_type) {
+        case type_bool: size = InstructionCompiler::push_bool(code, n.value_int != 0); break;
+        case type_u8: size = InstructionCompiler::push_u8(code, n.value_int); break;
+        case type_u16: size = InstructionCompiler::push_u16(code, n.value_int); break;
+        case type_u32: size = InstructionCompiler::push_u32(code, n.value_int); break;
+        case type_u64: size = InstructionCompiler::push_u64(code, n.value_int); break;
+        case type_i8: size = InstructionCompiler::push_i8(code, n.value_int); break;
+        case type_i16: size = InstructionCompiler::push_i16(code, n.value_int); break;
+        case type_i32: size = InstructionCompiler::push_i32(code, n.value_int); break;
+        case type_i64: size = InstructionCompiler::push_i64(code, n.value_int); break;
+        case type_f32: size = InstructionCompiler::push_f32(code, n.value_float); break;
+        case type_f64: size = InstructionCompiler::push_f64(code, n.value_float); break;
+        default: return buildError(token, "unsupported expression type");
+    }
+    return exprEmit(token, code, size);
+}
+
+bool exprEmitNode(Token& token, int index) {
+    ExprNode& n = expr_nodes[index];
+    PLCRuntimeInstructionSet type = (PLCRuntimeInstructionSet) expr_type;
+    u8 code[16];
+    int size = 0;
+    if (n.kind == EXPR_CONST) return exprEmitConst(token, n);
+    if (n.kind == EXPR_LOAD) {
+        size = InstructionCompiler::push_pointer(code, n.value_int);
+        size += InstructionCompiler::push_load(code + size, type);
+        return exprEmit(token, code, size);
+    }
+    if (n.kind == EXPR_UNARY) {
+        if (exprEmitNode(token, n.a)) return true;
+        size = InstructionCompiler::push(code, n.op, type);
+        return exprEmit(token, code, size);
+    }
+    if (n.a == n.b) { // Common subexpression: evaluate once and duplicate it
+        if (exprEmitNode(token, n.a)) return true;
+        size = InstructionCompiler::push_copy(code, type);
+    } else if (expr_nodes[n.b].need > expr_nodes[n.a].need) { // Evaluate the deeper operand first
+        if (exprEmitNode(token, n.b)) return true;
+        if (exprEmitNode(token, n.a)) return true;
+        if (!exprOpIsCommutative(n.op)) size = InstructionCompiler::push_swap(code, type, type);
+    } else {
+        if (exprEmitNode(token, n.a)) return true;
+        if (exprEmitNode(token, n.b)) return true;
+    }
+    size += InstructionCompiler::push(code + size, n.op, type);
+    return exprEmit(token, code, size);
+}
+
+// Compiles the expression following the '<type>.expr' token at index 'i' and advances 'i' to its last token
+bool compileExpression(int& i, u8 data_type) {
+    Token& token = tokens[i];
+    expr_node_count = 0;
+    expr_type = data_type;
+    expr_token_index = i + 1;
+    expr_token_end = token_count;
+    if (expr_type == type_pointer) return buildError(token, "unsupported expression type");
+    int root;
+    if (exprParseSum(root)) return true;
+    if (exprHasToken() && exprToken().line == token.line && !(exprToken() == "exit")) return exprError("unexpected token in expression");
+    if (exprEmitNode(token, root)) return true;
+    i = expr_token_index - 1;
+    return false;
+}
+
+#include "plcasm-mnemonics.h"
+#include "plcasm-contacts.h"
+#include "plcasm-optimizer.h"
+#include "plcasm-layout.h"
+#include "plcasm-wcet.h"
+#include "plcasm-verify.h"
+#include "plcasm-subset.h"
+#include "plcasm-tags.h"
+
+// Every instruction that emitted code keeps its line, so bytecode offsets can be traced back to the source
+void buildCloseLine() {
+    ProgramLine& line = programLines[programLineCount];
+    if (line.refToken && built_bytecode_length > line.index && programLineCount + 1 < PLCRUNTIME_MAX_PROGRAM_SIZE) programLineCount++;
+}
+
 bool build(bool finalPass) {
     programLineCount = 0;
+    programLines[0].refToken = nullptr;
     built_bytecode_length = 0;
     built_bytecode_checksum = 0;
     for (int i = 0; i < token_count; i++) {
@@ -1087,6 +1493,7 @@ bool build(bool finalPass) {
         float value_float;
         u8 data_type;
 
+        buildCloseLine();
         ProgramLine& line = programLines[programLineCount];
         line.index = built_bytecode_length;
         line.refToken = &token;
@@ -1106,6 +1513,63 @@ bool build(bool finalPass) {
         Token& token_p2 = hasThird ? tokens[i + 2] : tokens[i];
 
         if (type == TOKEN_KEYWORD) {
+            { // Compiler directives
+                if (token == "optimize") { assembly_optimize = true; continue; }
+                if (token == "scratch") {
+                    if (!hasNext || e_int) return buildErrorExpectedInt(token_p1);
+                    int scratch_size = 0;
+                    if (!hasThird || intFromToken(token_p2, scratch_size)) return buildErrorExpectedInt(token_p2);
+                    if (value_int < 0 || scratch_size < 0 || value_int + scratch_size > PLCRUNTIME_MAX_MEMORY_SIZE) return buildError(token_p1, "scratch area out of memory bounds");
+                    assembly_scratch_address = value_int;
+                    assembly_scratch_size = scratch_size;
+                    i += 2;
+                    continue;
+                }
+                if (token == "target") {
+                    if (!hasNext) return buildError(token, "expected target name");
+                    int target = -1;
+                    for (int t = 0; t < wcet_target_count; t++) if (token_p1 == wcet_targets[t].name) target = t;
+                    if (target < 0) return buildError(token_p1, "unknown target");
+                    wcet_target = target;
+                    i++;
+                    continue;
+                }
+#ifdef PLCRUNTIME_TAGS
+                if (token == "tag") { // tag <name> <type> <address>
+                    if (!hasNext || token_p1.type != TOKEN_KEYWORD) return buildError(token_p1, "expected tag name");
+                    u8 tag_type = 0;
+                    if (!hasThird || typeFromToken(token_p2, tag_type)) return buildError(token_p2, "expected tag data type");
+                    Token& token_p3 = i + 3 < token_count ? tokens[i + 3] : token_p2;
+                    int tag_address = 0;
+                    if (i + 3 >= token_count || intFromToken(token_p3, tag_address)) return buildErrorExpectedInt(token_p3);
+                    if (!finalPass && addAssemblyTag(token_p1, tag_type, tag_address)) return true;
+                    i += 3;
+                    continue;
+                }
+#endif // PLCRUNTIME_TAGS
+                if (token == "deadline") {
+                    if (!hasNext || e_int || value_int <= 0) return buildErrorExpectedInt(token_p1);
+                    wcet_deadline_us = value_int;
+                    i++;
+                    continue;
+                }
+                if (token == "bound") {
+                    int label = -1;
+                    for (int l = 0; hasNext && l < LUT_label_count; l++) if (str_cmp(token_p1, LUT_labels[l].string)) label = l;
+                    if (label < 0) return buildErrorUnknownLabel(token_p1);
+                    int count = 0;
+                    if (!hasThird || intFromToken(token_p2, count) || count <= 0) return buildErrorExpectedInt(token_p2);
+                    if (!finalPass) {
+                        if (wcet_bound_total >= MAX_WCET_BOUNDS) return buildError(token, "too many loop bounds");
+                        wcet_bound_label[wcet_bound_total] = label;
+                        wcet_bound_count[wcet_bound_total] = count;
+                        wcet_bound_total++;
+                    }
+                    i += 2;
+                    continue;
+                }
+            }
+
             { // Handle flow
                 if (hasNext && (token == "jmp" || token == "jump")) { if (finalPass && e_label) return buildErrorUnknownLabel(token_p1); i++; line.size = InstructionCompiler::push_jmp(bytecode, label_address); _line_push; }
                 if (hasNext && (token == "jmp_if" || token == "jump_if")) { if (finalPass && e_label) return buildErrorUnknownLabel(token_p1); i++; line.size = InstructionCompiler::push_jmp_if(bytecode, label_address); _line_push; }
@@ -1117,6 +1581,12 @@ bool build(bool finalPass) {
                 if (token == "ret_if" || token == "return_if") { line.size = InstructionCompiler::push(bytecode, RET_IF); _line_push; }
                 if (token == "ret_if_not" || token == "return_if_not") { line.size = InstructionCompiler::push(bytecode, RET_IF_NOT); _line_push; }
                 if (token == "nop") { line.size = InstructionCompiler::push(bytecode, NOP); _line_push; }
+                if (hasNext && token == "enter") { // enter <frame size>, paired with 'leave' before the return
+                    if (e_int) return buildErrorExpectedInt(token_p1);
+                    i++;
+                    if (value_int < 0 || value_int > 255) return buildError(token_p1, "frame size out of range (0 - 255)");
+                    line.size = InstructionCompiler::push_enter(bytecode, value_int); _line_push;
+                }
             }
 
             { // Stack operations
@@ -1172,6 +1642,11 @@ bool build(bool finalPass) {
                         if (token == "u8.or") { line.size = InstructionCompiler::push(bytecode, LOGIC_OR); _line_push; }
                         if (token == "u8.xor") { line.size = InstructionCompiler::push(bytecode, LOGIC_XOR); _line_push; }
                         if (token == "u8.not") { line.size = InstructionCompiler::push(bytecode, LOGIC_NOT); _line_push; }
+                        if (hasNext && token == "u8.contacts") {
+                            bool error = compileContacts(i);
+                            if (error) return error;
+                            continue;
+                        }
 
                         // Direct memory read/write
                         PLCRuntimeInstructionSet mem_bit_task = (PLCRuntimeInstructionSet) 0;
@@ -1212,32 +1687,25 @@ bool build(bool finalPass) {
                         Serial.print(F("Error: unknown data type ")); token.print(); Serial.print(F(" at ")); Serial.print(token.line); Serial.print(F(":")); Serial.println(token.column);
                         return true;
                     }
-                    // if (hasNext && token.endsWith(".load")) { if (e_int) return buildErrorExpectedInt(token_p1); i++; line.size = InstructionCompiler::pushGET(bytecode, value_int, type); _line_push; }
-                    // if (hasNext && token.endsWith(".store")) { if (e_int) return buildErrorExpectedInt(token_p1); i++; line.size = InstructionCompiler::pushPUT(bytecode, value_int, type); _line_push; }
-                    if (hasNext && token.endsWith(".load")) { line.size = InstructionCompiler::push_load(bytecode, type); _line_push; }
-                    if (hasNext && token.endsWith(".move")) { line.size = InstructionCompiler::push_move(bytecode, type); _line_push; }
-                    if (hasNext && token.endsWith(".move_copy")) { line.size = InstructionCompiler::push_move_copy(bytecode, type); _line_push; }
-                    if (hasNext && token.endsWith(".copy")) { line.size = InstructionCompiler::push_copy(bytecode, type); _line_push; }
-                    // if (hasNext && token.endsWith(".swap")) { line.size = InstructionCompiler::push_swap(bytecode, type); _line_push; }
-                    if (hasNext && token.endsWith(".drop")) { line.size = InstructionCompiler::push_drop(bytecode, type); _line_push; }
-                    if (token.endsWith(".cmp_lt")) { line.size = InstructionCompiler::push(bytecode, CMP_LT, type); _line_push; }
-                    if (token.endsWith(".cmp_gt")) { line.size = InstructionCompiler::push(bytecode, CMP_GT, type); _line_push; }
-                    if (token.endsWith(".cmp_eq")) { line.size = InstructionCompiler::push(bytecode, CMP_EQ, type); _line_push; }
-                    if (token.endsWith(".cmp_neq")) { line.size = InstructionCompiler::push(bytecode, CMP_NEQ, type); _line_push; }
-                    if (token.endsWith(".cmp_gte")) { line.size = InstructionCompiler::push(bytecode, CMP_GTE, type); _line_push; }
-                    if (token.endsWith(".cmp_lte")) { line.size = InstructionCompiler::push(bytecode, CMP_LTE, type); _line_push; }
-
-                    if (token.endsWith(".add")) { line.size = InstructionCompiler::push(bytecode, ADD, type); _line_push; }
-                    if (token.endsWith(".sub")) { line.size = InstructionCompiler::push(bytecode, SUB, type); _line_push; }
-                    if (token.endsWith(".mul")) { line.size = InstructionCompiler::push(bytecode, MUL, type); _line_push; }
-                    if (token.endsWith(".div")) { line.size = InstructionCompiler::push(bytecode, DIV, type); _line_push; }
-                    if (token.endsWith(".mod")) { line.size = InstructionCompiler::push(bytecode, MOD, type); _line_push; }
-                    if (token.endsWith(".pow")) { line.size = InstructionCompiler::push(bytecode, POW, type); _line_push; }
-                    if (token.endsWith(".sqrt")) { line.size = InstructionCompiler::push(bytecode, SQRT, type); _line_push; }
-                    if (token.endsWith(".neg")) { line.size = InstructionCompiler::push(bytecode, NEG, type); _line_push; }
-                    if (token.endsWith(".abs")) { line.size = InstructionCompiler::push(bytecode, ABS, type); _line_push; }
-                    if (token.endsWith(".sin")) { line.size = InstructionCompiler::push(bytecode, SIN, type); _line_push; }
-                    if (token.endsWith(".cos")) { line.size = InstructionCompiler::push(bytecode, COS, type); _line_push; }
+                    // Local variables of the current frame: u8.local_load 0, f32.local_store 4
+                    bool local_load = token.endsWith(".local_load");
+                    if (hasNext && (local_load || token.endsWith(".local_store"))) {
+                        if (e_int) return buildErrorExpectedInt(token_p1);
+                        i++;
+                        if (value_int < 0 || value_int > 255) return buildError(token_p1, "frame offset out of range (0 - 255)");
+                        if (local_load) line.size = InstructionCompiler::push_local_load(bytecode, type, value_int);
+                        else line.size = InstructionCompiler::push_local_store(bytecode, type, value_int);
+                        _line_push;
+                    }
+                    // Instructions with a data type operand, by their opcode name: u8.add, f32.cmp_lt, i16.move_copy ...
+                    int typed_opcode = mnemonicTyped(token);
+                    if (typed_opcode >= 0) { line.size = InstructionCompiler::push(bytecode, typed_opcode, type); _line_push; }
+
+                    if (token.endsWith(".expr")) {
+                        bool error = compileExpression(i, data_type);
+                        if (error) return error;
+                        continue;
+                    }
                 }
             }
         }
@@ -1275,8 +1743,14 @@ bool build(bool finalPass) {
             _line_push;
         }
 
+        if (type == TOKEN_KEYWORD) { // Any instruction without operands by its opcode name
+            int plain_opcode = mnemonicPlain(token);
+            if (plain_opcode >= 0) { line.size = InstructionCompiler::push(bytecode, plain_opcode); _line_push; }
+        }
+
         return buildErrorUnknownToken(token);
     }
+    buildCloseLine();
     for (int i = 0; i < LUT_label_count; i++) {
         LUT_label& label = LUT_labels[i];
         if (label.address == -1) {
@@ -1318,6 +1792,19 @@ WASM_EXPORT bool compileAssembly(bool debug = true) {
     bool error = false;
     if (debug) Serial.print(F("."));
     long t1 = millis();
+    assembly_optimize = false;
+    // A profile is used by one compilation only
+    bool profile_guided = assembly_profile_loaded;
+    assembly_profile_loaded = false;
+    layout_applied = false;
+    assembly_scratch_address = -1;
+    assembly_scratch_size = 0;
+    wcet_target = 0;
+    wcet_deadline_us = 0;
+    wcet_bound_total = 0;
+#ifdef PLCRUNTIME_TAGS
+    assembly_tag_count = 0;
+#endif // PLCRUNTIME_TAGS
     error = tokenize();
     t1 = millis() - t1;
     if (error) { Serial.println(F("Failed at tokenization"));  return error; }
@@ -1351,6 +1838,46 @@ WASM_EXPORT bool compileAssembly(bool debug = true) {
     t1 = millis() - t1;
     if (error) { Serial.println(F("Failed at linking"));  return error; }
 
+    if (assembly_optimize) {
+        if (debug) Serial.print(F("."));
+        int unoptimized_length = built_bytecode_length;
+        error = optimizeBytecode();
+        if (error) { Serial.println(F("Failed at optimization"));  return error; }
+        if (debug) {
+            Serial.print(F(" optimized ")); Serial.print(unoptimized_length); Serial.print(F(" -> ")); Serial.print(built_bytecode_length); Serial.print(F(" bytes ("));
+            Serial.print(opt_count_copy); Serial.print(F(" copies, ")); Serial.print(opt_count_forward); Serial.print(F(" forwarded, ")); Serial.print(opt_count_hoist); Serial.print(F(" hoisted)"));
+        }
+    }
+
+    if (profile_guided) {
+        if (debug) Serial.print(F("."));
+        error = layoutBytecode();
+        if (error) { Serial.println(F("Failed at block layout"));  return error; }
+        if (debug) {
+            Serial.print(F(" layout: ")); Serial.print(layout_count_moved); Serial.print(F(" blocks moved, "));
+            Serial.print(layout_count_inverted); Serial.print(F(" branches inverted"));
+        }
+    }
+
+    // The source lines of the rewritten bytecode are unknown
+    if (assembly_optimize || profile_guided) programLineCount = 0;
+
+    if (verifyBytecode()) Serial.print(F(" stack not verified, the bytecode can not be decoded"));
+    else if (verify_warnings > 0) Serial.println();
+
+    if (wcet_deadline_us > 0) {
+        if (debug) Serial.print(F("."));
+        error = wcetAnalyze();
+        if (error) { Serial.println(F("Failed at timing analysis"));  return error; }
+        if (wcetMicros(wcet_cycles) > wcet_deadline_us) {
+            Serial.println();
+            Serial.print(F("Error: worst case execution time of ")); Serial.print(wcetMicros(wcet_cycles)); Serial.print(F(" us exceeds the deadline of ")); Serial.print(wcet_deadline_us); Serial.println(F(" us"));
+            wcetReport();
+            return true;
+        }
+        if (debug) { Serial.print(F(" worst case ")); Serial.print(wcetMicros(wcet_cycles)); Serial.print(F(" us")); }
+    }
+
     total = millis() - total;
     if (debug) { Serial.print(F(" finished in ")); Serial.print(total); Serial.println(F(" ms")); }
 
@@ -1385,6 +1912,9 @@ WASM_EXPORT bool compileAssembly(bool debug = true) {
                 Serial.println();
             }
         } else Serial.println(F("No consts"));
+#ifdef PLCRUNTIME_TAGS
+        printAssemblyTags();
+#endif // PLCRUNTIME_TAGS
 
         // if (token_count > 0) {
         //     Serial.print(F("Tokens ")); Serial.print(token_count); Serial.println(F(":"));
@@ -1417,9 +1947,289 @@ WASM_EXPORT void printProperties() {
 WASM_EXPORT bool loadCompiledProgram() {
     Serial.printf("Loading program with %d bytes and checksum 0x%02X ...\n", built_bytecode_length, built_bytecode_checksum);
     runtime.loadProgram(built_bytecode, built_bytecode_length, built_bytecode_checksum);
+#ifdef PLCRUNTIME_TAGS
+    // The tag table belongs to the program
+    if (runtime.tags.load(assembly_tags, assembly_tag_count)) Serial.println(F("Error: the tag table does not fit into the runtime"));
+#endif // PLCRUNTIME_TAGS
     return false;
 }
 
+#ifdef PLCRUNTIME_PROFILER
+// Count the executed program offsets from now on, or stop counting. The counts start at zero
+WASM_EXPORT void setProfiling(bool enabled) {
+    runtime.clearProfile();
+    runtime.profiling = enabled;
+}
+
+// Use the execution counts of the last runs as the profile for the next compilation
+WASM_EXPORT void loadRuntimeProfile() {
+    layoutLoadProfile(runtime.program.profile, runtime.program.prog_size);
+}
+
+// Print the execution count of every executed offset as '<offset> <count>' lines
+WASM_EXPORT void printProfile() {
+    for (u32 i = 0; i < runtime.program.prog_size; i++) {
+        if (runtime.program.profile[i] == 0) continue;
+        Serial.print(i); Serial.print(' '); Serial.println(runtime.program.profile[i]);
+    }
+}
+#endif // PLCRUNTIME_PROFILER
+
+#ifdef PLCRUNTIME_MATH_CACHE
+// Enable or disable the math result cache for the loaded program, the cache starts empty
+WASM_EXPORT void setMathCache(bool enabled) {
+    runtime.math_cache.clear();
+    runtime.math_cache.enabled = enabled;
+}
+
+// Print the total math cache hits and misses, followed by '<offset> <hits> <misses>' lines of the cached call sites
+// (the lines only with the profiler)
+WASM_EXPORT void printMathCacheProfile() {
+    Serial.print(runtime.math_cache.hits); Serial.print(' '); Serial.println(runtime.math_cache.misses);
+#ifdef PLCRUNTIME_PROFILER
+    for (u32 i = 0; i < PLCRUNTIME_MATH_CACHE_SIZE; i++) {
+        MathCacheEntry& entry = runtime.math_cache.entries[i];
+        if (entry.site == PLCRUNTIME_MATH_CACHE_EMPTY) continue;
+        Serial.print(entry.site); Serial.print(' '); Serial.print(entry.hits); Serial.print(' '); Serial.println(entry.misses);
+    }
+#endif // PLCRUNTIME_PROFILER
+}
+#endif // PLCRUNTIME_MATH_CACHE
+
+#ifdef PLCRUNTIME_SFC
+// Sequential function chart definition, the segments are program offsets of the loaded program. Returns true on error
+WASM_EXPORT void clearChart() {
+    runtime.sfc.clear();
+}
+
+WASM_EXPORT bool addChartStep(u32 action) {
+    return runtime.sfc.addStep(action);
+}
+
+WASM_EXPORT bool addChartTransition(u32 from, u32 to, u32 condition) {
+    return runtime.sfc.addTransition(from, to, condition);
+}
+
+WASM_EXPORT bool setChartStateArea(u32 address) {
+    return runtime.sfc.setStateArea(address);
+}
+
+WASM_EXPORT bool resetChart(u32 step) {
+    return runtime.sfc.reset(step);
+}
+
+// Print the active steps as a space separated list
+WASM_EXPORT u32 printActiveSteps() {
+    u32 count = 0;
+    for (u16 i = 0; i < runtime.sfc.step_count; i++) {
+        if (!runtime.sfc.isActive(i)) continue;
+        if (count++) Serial.print(' ');
+        Serial.print(i);
+    }
+    Serial.println();
+    return count;
+}
+#endif // PLCRUNTIME_SFC
+
+#ifdef PLCRUNTIME_TREND_LOGGER
+// Trend logger configuration, returns true on error
+WASM_EXPORT bool addTrendTag(u32 address, u8 type) {
+    return runtime.trend.addTag(address, type);
+}
+
+WASM_EXPORT void clearTrendTags() {
+    runtime.trend.clearTags();
+}
+
+WASM_EXPORT void setTrendInterval(u16 scans) {
+    runtime.trend.setInterval(scans);
+}
+
+// Print the held trend samples in the upload format, returns the number of samples
+WASM_EXPORT u32 uploadTrend() {
+    runtime.trend.upload();
+    return runtime.trend.sample_count;
+}
+#endif // PLCRUNTIME_TREND_LOGGER
+
+#ifdef PLCRUNTIME_CAPTURE
+// Capture configuration, returns true on error
+WASM_EXPORT bool addCaptureTag(u32 address, u8 type) {
+    return runtime.capture.addTag(address, type);
+}
+
+WASM_EXPORT void clearCaptureTags() {
+    runtime.capture.clearTags();
+}
+
+// Edge trigger on the bit 'address.bit' or manual trigger
+WASM_EXPORT bool setCaptureTriggerBit(u8 mode, u32 address, u8 bit) {
+    return runtime.capture.setTrigger(mode, address, bit);
+}
+
+// Threshold trigger, the threshold is read from the memory at 'threshold_address' as the given data type
+WASM_EXPORT bool setCaptureTriggerThreshold(u8 mode, u32 address, u8 type, u32 threshold_address) {
+    u8 threshold[8];
+    u8 size = DATA_TYPE_SIZE(type);
+    if (size == 0 || size > sizeof(threshold)) return true;
+    if (readArea_u8(runtime.memory, threshold_address, threshold, size)) return true;
+    return runtime.capture.setTrigger(mode, address, type, threshold);
+}
+
+WASM_EXPORT bool armCapture(u16 pre, u16 post) {
+    return runtime.capture.arm(pre, post);
+}
+
+WASM_EXPORT void triggerCapture() {
+    runtime.capture.trigger();
+}
+
+// Returns the capture state (0 = idle, 1 = armed, 2 = triggered, 3 = complete)
+WASM_EXPORT u8 getCaptureState() {
+    return runtime.capture.state;
+}
+
+// Print the held capture samples in the upload format, returns the number of samples
+WASM_EXPORT u32 uploadCapture() {
+    runtime.capture.upload();
+    return runtime.capture.sample_count;
+}
+#endif // PLCRUNTIME_CAPTURE
+
+#ifdef PLCRUNTIME_ALARMS
+// Alarm engine configuration, returns true on error
+WASM_EXPORT bool configureAlarms(u32 address, u32 ack_address, u16 count) {
+    return runtime.alarms.configure(address, ack_address, count);
+}
+
+// Acknowledge an alarm, 0xFFFF acknowledges all alarms. Returns true on error
+WASM_EXPORT bool acknowledgeAlarm(u16 alarm) {
+    if (alarm == 0xFFFF) {
+        runtime.alarms.acknowledgeAll(runtime.memory);
+        return false;
+    }
+    return runtime.alarms.acknowledge(runtime.memory, alarm);
+}
+
+// Print the alarm events from the given sequence on in the upload format, returns the next sequence
+WASM_EXPORT u32 uploadAlarmEvents(u32 from) {
+    runtime.alarms.upload(from);
+    return runtime.alarms.sequence;
+}
+#endif // PLCRUNTIME_ALARMS
+
+#ifdef PLCRUNTIME_RECIPES
+char recipe_name[PLCRUNTIME_RECIPE_MAX_NAME + 1];
+
+// Store the current memory range as a recipe, the name is read from the input stream. Returns true on error
+WASM_EXPORT bool storeRecipe(u32 address, u16 size) {
+    int length = 0;
+    streamRead(recipe_name, length, PLCRUNTIME_RECIPE_MAX_NAME + 1);
+    return runtime.recipes.snapshot(recipe_name, length, runtime.memory, address, size);
+}
+
+// Apply the recipe named in the input stream at the start of the next scan. Returns true on error
+WASM_EXPORT bool applyRecipe() {
+    int length = 0;
+    streamRead(recipe_name, length, PLCRUNTIME_RECIPE_MAX_NAME + 1);
+    return runtime.recipes.request(runtime.recipes.find(recipe_name, length));
+}
+
+// Remove the recipe named in the input stream. Returns true on error
+WASM_EXPORT bool removeRecipe() {
+    int length = 0;
+    streamRead(recipe_name, length, PLCRUNTIME_RECIPE_MAX_NAME + 1);
+    return runtime.recipes.remove(runtime.recipes.find(recipe_name, length));
+}
+
+WASM_EXPORT void clearRecipes() {
+    runtime.recipes.clear();
+}
+#endif // PLCRUNTIME_RECIPES
+
+#ifdef PLCRUNTIME_COMM
+// Place the receive and transmit rings of an auxiliary port in the memory, returns true on error
+WASM_EXPORT bool configureComm(u8 port, u32 rx_address, u16 rx_size, u32 tx_address, u16 tx_size) {
+    return runtime.comm.configure(runtime.memory, port, rx_address, rx_size, tx_address, tx_size);
+}
+
+// Move the bytes of the input stream into the receive ring of the port, returns the number of bytes that fit
+WASM_EXPORT u32 commReceive(u8 port) {
+    u8 chunk[16];
+    u32 total = 0;
+    u16 room = runtime.comm.space(runtime.memory, port);
+    while (room > 0 && streamAvailable() > 0) {
+        u16 count = 0;
+        while (count < sizeof(chunk) && count < room && streamAvailable() > 0) chunk[count++] = __streamInRead();
+        runtime.comm.receive(runtime.memory, port, chunk, count);
+        room -= count;
+        total += count;
+    }
+    return total;
+}
+
+// Print the pending bytes of the transmit ring of the port in hex, returns the number of bytes sent
+WASM_EXPORT u32 commTransmit(u8 port) {
+    u8 chunk[16];
+    u32 total = 0;
+    char c1, c2;
+    while (true) {
+        u16 count = runtime.comm.transmit(runtime.memory, port, chunk, sizeof(chunk));
+        if (count == 0) break;
+        for (u16 i = 0; i < count; i++) {
+            byteToHex(chunk[i], c1, c2);
+            streamOut(c1);
+            streamOut(c2);
+        }
+        total += count;
+    }
+    return total;
+}
+#endif // PLCRUNTIME_COMM
+
+#ifdef PLCRUNTIME_TAGS
+// Resolve the tag named in the input stream, prints '<address> <type> <size>'. Returns the address or 0xFFFFFFFF if unknown
+WASM_EXPORT u32 findTag() {
+    char name[256];
+    int length = 0;
+    streamRead(name, length, sizeof(name));
+    const TagEntry* tag = runtime.tags.find(name, length);
+    if (tag == nullptr) return 0xFFFFFFFF;
+    Serial.print(tag->address); Serial.print(' '); Serial.print(tag->type); Serial.print(' '); Serial.println(tag->size);
+    return tag->address;
+}
+
+// Read the values of the tags named in the input stream (separated by spaces or new lines), prints one hex group
+// per tag in the memory byte order. Returns the number of tags read, reading stops at the first unknown tag
+WASM_EXPORT u32 readTags() {
+    char names[1024];
+    int length = 0;
+    streamRead(names, length, sizeof(names));
+    u32 count = 0;
+    int start = 0;
+    for (int i = 0; i <= length; i++) {
+        bool separator = i == length || names[i] == ' ' || names[i] == '\n' || names[i] == '\r' || names[i] == ',';
+        if (!separator) continue;
+        if (i > start) {
+            const TagEntry* tag = runtime.tags.find(names + start, i - start);
+            if (tag == nullptr) break;
+            if (count > 0) streamOut(' ');
+            char c1, c2;
+            for (u8 j = 0; j < tag->size; j++) {
+                u8 byte = 0;
+                get_u8(runtime.memory, tag->address + j, byte);
+                byteToHex(byte, c1, c2);
+                streamOut(c1);
+                streamOut(c2);
+            }
+            count++;
+        }
+        start = i + 1;
+    }
+    return count;
+}
+#endif // PLCRUNTIME_TAGS
+
 WASM_EXPORT void runFullProgramDebug() {
     RuntimeError status = UnitTest::fullProgramDebug(runtime);
     const char* status_name = RUNTIME_ERROR_NAME(status);
@@ -1472,6 +2282,161 @@ WASM_EXPORT void external_print(const char* string) {
     Serial.print(string);
 }
 
+#ifdef __RUNTIME_FULL_UNIT_TEST___
+// Constant folding of '.expr', every case must compile to exactly the expected bytecode
+struct AssemblerTestCase {
+    const char* name;
+    const char* source;
+    int (*build)(u8* code);
+};
+
+const AssemblerTestCase assembler_test_cases[] = {
+    { "expr => f32 pow(2, 10) folded", "f32.expr pow(2, 10)", [](u8* code) -> int {
+        return InstructionCompiler::push_f32(code, 1024);
+    } },
+    { "expr => f32 pow(1, 300) not folded", "f32.expr pow(1, 300)", [](u8* code) -> int {
+        int size = InstructionCompiler::push_f32(code, 1);
+        size += InstructionCompiler::push_f32(code + size, 300);
+        return size + InstructionCompiler::push(code + size, POW, type_f32);
+    } },
+    { "expr => f32 pow(4, 0.5) not folded", "f32.expr pow(4, 0.5)", [](u8* code) -> int {
+        int size = InstructionCompiler::push_f32(code, 4);
+        size += InstructionCompiler::push_f32(code + size, 0.5);
+        return size + InstructionCompiler::push(code + size, POW, type_f32);
+    } },
+    { "expr => f32 pow(2, -1) not folded", "f32.expr pow(2, -1)", [](u8* code) -> int {
+        int size = InstructionCompiler::push_f32(code, 2);
+        size += InstructionCompiler::push_f32(code + size, -1);
+        return size + InstructionCompiler::push(code + size, POW, type_f32);
+    } },
+    { "expr => i32 pow(3, 40) wraps", "i32.expr pow(3, 40)", [](u8* code) -> int {
+        return InstructionCompiler::push_i32(code, 689956897);
+    } },
+    { "expr => i32 pow(2, -1) not folded", "i32.expr pow(2, -1)", [](u8* code) -> int {
+        int size = InstructionCompiler::push_i32(code, 2);
+        size += InstructionCompiler::push_i32(code + size, -1);
+        return size + InstructionCompiler::push(code + size, POW, type_i32);
+    } },
+    { "expr => u64 100000 * 100000", "u64.expr 100000 * 100000", [](u8* code) -> int {
+        return InstructionCompiler::push_u64(code, 10000000000ULL);
+    } },
+    { "expr => i64 -65536 * 65536 * 65536", "i64.expr -65536 * 65536 * 65536", [](u8* code) -> int {
+        return InstructionCompiler::push_i64(code, -281474976710656LL);
+    } },
+    { "expr => u32 0 - 1 wraps", "u32.expr 0 - 1", [](u8* code) -> int {
+        return InstructionCompiler::push_u32(code, 0xFFFFFFFF);
+    } },
+};
+
+#ifdef PLCRUNTIME_PROFILER
+// A loop whose conditional jump is taken 8 times out of 10, so the layout moves the taken block behind it.
+// The cells are above the system area, which every scan overwrites
+const char* assembler_layout_source = R"(
+    ptr.const 8
+    u8.const 0
+    u8.move
+    ptr.const 9
+    u8.const 0
+    u8.move
+loop:
+    ptr.const 8
+    u8.load
+    u8.const 8
+    u8.cmp_lt
+    jmp_if hot
+    ptr.const 10
+    u8.const 7
+    u8.move
+    jmp next
+hot:
+    ptr.const 9
+    ptr.const 9
+    u8.load
+    u8.const 2
+    u8.add
+    u8.move
+next:
+    ptr.const 8
+    ptr.const 8
+    u8.load
+    u8.const 1
+    u8.add
+    u8.move_copy
+    u8.const 10
+    u8.cmp_lt
+    jmp_if loop
+    exit
+)";
+
+// Profile, lay out, profile the laid out program and lay out again: the second layout must not change anything
+void assembler_layout_test() {
+    static char source[1024];
+    static u8 plain[256];
+    static u8 laid_out[256];
+    u32 plain_length = 0;
+    u32 laid_out_length = 0;
+    u32 offset = Serial.print(F("Test \"layout => laid out profile\""));
+    u32 t = micros();
+    bool passed = true;
+    for (int pass = 0; pass < 4 && passed; pass++) {
+        string_copy(source, assembler_layout_source);
+        set_assembly_string(source);
+        passed = !compileAssembly(false) && (u32) built_bytecode_length <= sizeof(plain);
+        if (!passed) break;
+        if (pass == 0) {
+            plain_length = built_bytecode_length;
+            memcpy(plain, built_bytecode, plain_length);
+        }
+        if (pass == 1) {
+            passed = layout_count_moved > 0;
+            laid_out_length = built_bytecode_length;
+            memcpy(laid_out, built_bytecode, laid_out_length);
+        }
+        if (pass == 2) passed = (u32) built_bytecode_length == laid_out_length && memcmp(built_bytecode, laid_out, laid_out_length) == 0;
+        // The profile was used up by the previous compilation
+        if (pass == 3) passed = (u32) built_bytecode_length == plain_length && memcmp(built_bytecode, plain, plain_length) == 0;
+        if (pass >= 2) continue;
+        runtime.loadProgram(built_bytecode, built_bytecode_length, built_bytecode_checksum);
+        setProfiling(true);
+        passed = runtime.run() == STATUS_SUCCESS && memory_byte(runtime, 9) == 16 && memory_byte(runtime, 10) == 7;
+        loadRuntimeProfile();
+        setProfiling(false);
+    }
+    t = micros() - t;
+    f32 ms = (f32) t * 0.001;
+    for (; offset < 40; offset++) Serial.print(' ');
+    Serial.print(passed ? F("Passed") : F("FAILED !!!"));
+    Serial.print(F(" - ")); Serial.print(ms, 3); Serial.println(F(" ms"));
+}
+#endif // PLCRUNTIME_PROFILER
+
+void assembler_unit_test() {
+    char source[64];
+    u8 expected[32];
+    for (u32 i = 0; i < sizeof(assembler_test_cases) / sizeof(AssemblerTestCase); i++) {
+        const AssemblerTestCase& test = assembler_test_cases[i];
+        string_copy(source, test.source);
+        set_assembly_string(source);
+        int size = test.build(expected);
+        size += InstructionCompiler::push(expected + size, EXIT); // Appended to every program
+        u32 t = micros();
+        bool passed = !compileAssembly(false);
+        t = micros() - t;
+        passed = passed && built_bytecode_length == size && memcmp(built_bytecode, expected, size) == 0;
+        u32 offset = Serial.print(F("Test \"")) + Serial.print(test.name) + Serial.print(F("\""));
+        f32 ms = (f32) t * 0.001;
+        for (; offset < 40; offset++) Serial.print(' ');
+        Serial.print(passed ? F("Passed") : F("FAILED !!!"));
+        Serial.print(F(" - ")); Serial.print(ms, 3); Serial.println(F(" ms"));
+    }
+#ifdef PLCRUNTIME_PROFILER
+    assembler_layout_test();
+#endif // PLCRUNTIME_PROFILER
+}
+#else // __RUNTIME_FULL_UNIT_TEST___
+void assembler_unit_test() {}
+#endif // __RUNTIME_FULL_UNIT_TEST___
+
 #else
 
 void set_assembly_string(char* new_assembly_string) {}
@@ -1480,5 +2445,6 @@ void runFullProgramDebug() {}
 u32 uploadProgram() { return 0; }
 u32 getMemoryArea(u32 address, u32 size) { return 0; }
 u32 writeMemoryByte(u32 address, u8 byte) { return 0; }
+void assembler_unit_test() {}
 
 #endif // __WASM__
\ No newline at end of file
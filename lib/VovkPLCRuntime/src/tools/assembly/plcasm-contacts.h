@@ -0,0 +1,325 @@
+// plcasm-contacts.h - 1.0.0 - 2022-12-11
+//
+// Copyright (c) 2022 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#ifdef __WASM__
+
+// ################################################################################################
+// Contact network compiler
+// ################################################################################################
+// Usage: u8.contacts <network>
+// Compiles a ladder contact network into code which leaves the state of the rung (0 or 1) on the stack.
+// A contact is a memory bit 'address.bit', prefixed with '!' for a normally closed contact.
+// Contacts in series are joined with '&', parallel branches with '|' and groups are put in parentheses:
+/*
+    u8.contacts 10.0 & !10.1 & (10.2 | 20.0)
+    u8.writeBit 20.0
+*/
+// Series and parallel networks are evaluated with short circuit jumps: as soon as one contact in series is
+// open (or one parallel branch is closed) the remaining contacts are skipped. Every network chooses between
+// branching and straight 'u8.and' / 'u8.or' code by the expected number of executed instructions, where every
+// contact is assumed to be closed half of the time. Two plain contacts are cheaper without jumps, longer
+// interlock chains usually evaluate only their first few contacts.
+
+#define MAX_CONTACT_NODES 128
+#define MAX_CONTACT_LABELS 128
+#define MAX_CONTACT_CODE 1024
+
+enum ContactNodeKind {
+    CONTACT_BIT = 0,
+    CONTACT_SERIES,   // AND
+    CONTACT_PARALLEL, // OR
+};
+
+struct ContactNode {
+    ContactNodeKind kind;
+    bool inverted;      // Normally closed contact
+    int address;
+    int bit;
+    int first;          // First child node
+    int next;           // Next sibling node
+    float p;            // Probability of the network being closed
+    float cost_value;   // Expected instruction count to push the state
+    float cost_cond;    // Expected instruction count to jump on the state
+    bool branch_value;  // Push the state using short circuit jumps
+    bool branch_cond;   // Jump on the state using short circuit jumps
+};
+
+struct ContactPatch {
+    int offset; // Offset of the jump instruction in the contact code
+    int label;
+};
+
+ContactNode contact_nodes[MAX_CONTACT_NODES];
+int contact_node_count = 0;
+int contact_label_offset[MAX_CONTACT_LABELS];
+int contact_label_count = 0;
+ContactPatch contact_patches[MAX_CONTACT_LABELS * 2];
+int contact_patch_count = 0;
+u8 contact_code[MAX_CONTACT_CODE];
+int contact_code_length = 0;
+bool contact_overflow = false;
+
+int contactNode(ContactNodeKind kind) {
+    if (contact_node_count >= MAX_CONTACT_NODES) return -1;
+    ContactNode& n = contact_nodes[contact_node_count];
+    n.kind = kind;
+    n.inverted = false;
+    n.address = 0;
+    n.bit = 0;
+    n.first = -1;
+    n.next = -1;
+    return contact_node_count++;
+}
+
+bool contactsParseParallel(int& output);
+
+bool contactsParseContact(int& output) {
+    if (!exprHasToken()) return exprError("unexpected end of contact network");
+    Token& token = exprToken();
+    if (exprIsOperator(token, "!")) {
+        expr_token_index++;
+        if (contactsParseContact(output)) return true;
+        // Inverting a group inverts its contacts and swaps series with parallel (De Morgan)
+        if (contact_nodes[output].kind == CONTACT_BIT) contact_nodes[output].inverted = !contact_nodes[output].inverted;
+        else {
+            int stack[MAX_CONTACT_NODES];
+            int count = 0;
+            stack[count++] = output;
+            while (count > 0) {
+                ContactNode& n = contact_nodes[stack[--count]];
+                if (n.kind == CONTACT_BIT) n.inverted = !n.inverted;
+                else {
+                    n.kind = n.kind == CONTACT_SERIES ? CONTACT_PARALLEL : CONTACT_SERIES;
+                    for (int c = n.first; c >= 0; c = contact_nodes[c].next) stack[count++] = c;
+                }
+            }
+        }
+        return false;
+    }
+    if (exprIsOperator(token, "(")) {
+        expr_token_index++;
+        if (contactsParseParallel(output)) return true;
+        if (exprExpect(")")) return exprError("expected ')'");
+        return false;
+    }
+    int address, bit;
+    if (memoryBitFromToken(token, address, bit)) return exprError("unexpected token, expected bit representation");
+    if (address < 0 || address > 0xFFFF) return exprError("memory address out of range");
+    expr_token_index++;
+    output = contactNode(CONTACT_BIT);
+    if (output < 0) return exprError("contact network is too complex");
+    contact_nodes[output].address = address;
+    contact_nodes[output].bit = bit;
+    return false;
+}
+
+// Parses operands joined by 'op' into one node with all of them as children, nested groups of the same kind are merged
+bool contactsParseList(int& output, ContactNodeKind kind, const char* op) {
+    int first;
+    if (kind == CONTACT_SERIES ? contactsParseContact(first) : contactsParseList(first, CONTACT_SERIES, "&")) return true;
+    if (!exprHasToken() || !exprIsOperator(exprToken(), op)) {
+        output = first;
+        return false;
+    }
+    output = contactNode(kind);
+    if (output < 0) return exprError("contact network is too complex");
+    int last = -1;
+    int child = first;
+    while (true) {
+        if (contact_nodes[child].kind == kind) { // (a & b) & c => a & b & c
+            if (last < 0) contact_nodes[output].first = contact_nodes[child].first;
+            else contact_nodes[last].next = contact_nodes[child].first;
+            last = contact_nodes[child].first;
+            while (contact_nodes[last].next >= 0) last = contact_nodes[last].next;
+        } else {
+            if (last < 0) contact_nodes[output].first = child;
+            else contact_nodes[last].next = child;
+            last = child;
+        }
+        if (!exprHasToken() || !exprIsOperator(exprToken(), op)) break;
+        expr_token_index++;
+        if (kind == CONTACT_SERIES ? contactsParseContact(child) : contactsParseList(child, CONTACT_SERIES, "&")) return true;
+    }
+    return false;
+}
+
+bool contactsParseParallel(int& output) { return contactsParseList(output, CONTACT_PARALLEL, "|"); }
+
+// Expected instruction counts of both code shapes, bottom up
+void contactsAnalyze(int index) {
+    ContactNode& n = contact_nodes[index];
+    if (n.kind == CONTACT_BIT) {
+        n.p = 0.5;
+        n.cost_value = n.inverted ? 2 : 1; // read (+ not)
+        n.cost_cond = 2;                   // read + jump
+        n.branch_value = false;
+        n.branch_cond = false;
+        return;
+    }
+    bool series = n.kind == CONTACT_SERIES;
+    float reach = 1;         // Probability of the child being evaluated
+    float straight = -1;     // Every child pushed and combined
+    float branch_cond = 0;   // Every child jumps on its deciding state
+    float branch_value = 0;  // All but the last child jump, the last one is pushed
+    float p_continue = 1;
+    for (int c = n.first; c >= 0; c = contact_nodes[c].next) {
+        contactsAnalyze(c);
+        ContactNode& child = contact_nodes[c];
+        straight += child.cost_value + 1;
+        branch_cond += reach * child.cost_cond;
+        if (child.next >= 0) branch_value += reach * child.cost_cond;
+        else branch_value += reach * (child.cost_value + 1) + (1 - reach); // jmp over the constant, or push the constant
+        float q = series ? child.p : 1 - child.p; // Probability of the child not deciding the network
+        reach *= q;
+        p_continue *= q;
+    }
+    n.p = series ? p_continue : 1 - p_continue;
+    n.branch_value = branch_value < straight;
+    n.cost_value = n.branch_value ? branch_value : straight;
+    n.branch_cond = branch_cond < straight + 1;
+    n.cost_cond = n.branch_cond ? branch_cond : straight + 1;
+}
+
+int contactsLabel() {
+    if (contact_label_count >= MAX_CONTACT_LABELS) { contact_overflow = true; return 0; }
+    contact_label_offset[contact_label_count] = -1;
+    return contact_label_count++;
+}
+
+void contactsBind(int label) { contact_label_offset[label] = contact_code_length; }
+
+bool contactsFits(int size) {
+    if (contact_code_length + size > MAX_CONTACT_CODE) contact_overflow = true;
+    return !contact_overflow;
+}
+
+void contactsPush(PLCRuntimeInstructionSet op) {
+    if (!contactsFits(1)) return;
+    contact_code_length += InstructionCompiler::push(contact_code + contact_code_length, op);
+}
+
+void contactsPushState(bool state) {
+    if (!contactsFits(2)) return;
+    contact_code_length += InstructionCompiler::push_u8(contact_code + contact_code_length, state);
+}
+
+void contactsRead(ContactNode& n) {
+    if (!contactsFits(3)) return;
+    PLCRuntimeInstructionSet op = (PLCRuntimeInstructionSet) (READ_X8_B0 + n.bit);
+    contact_code_length += InstructionCompiler::push_InstructionWithU32(contact_code + contact_code_length, op, n.address);
+}
+
+void contactsJump(PLCRuntimeInstructionSet op, int label) {
+    if (!contactsFits(3) || contact_patch_count >= MAX_CONTACT_LABELS * 2) { contact_overflow = true; return; }
+    contact_patches[contact_patch_count].offset = contact_code_length;
+    contact_patches[contact_patch_count].label = label;
+    contact_patch_count++;
+    contact_code_length += InstructionCompiler::push_jmp(contact_code + contact_code_length, 0);
+    contact_code[contact_code_length - 3] = op;
+}
+
+void contactsValue(int index);
+
+// Jumps to 'label' when the network state equals 'when', falls through otherwise
+void contactsCond(int index, bool when, int label) {
+    ContactNode& n = contact_nodes[index];
+    if (n.kind == CONTACT_BIT) {
+        contactsRead(n);
+        contactsJump(when != n.inverted ? JMP_IF : JMP_IF_NOT, label);
+        return;
+    }
+    if (!n.branch_cond) {
+        contactsValue(index);
+        contactsJump(when ? JMP_IF : JMP_IF_NOT, label);
+        return;
+    }
+    bool decisive = n.kind == CONTACT_PARALLEL; // A closed branch closes a parallel network, an open contact opens a series
+    if (when == decisive) {
+        for (int c = n.first; c >= 0; c = contact_nodes[c].next) contactsCond(c, decisive, label);
+        return;
+    }
+    int skip = contactsLabel();
+    for (int c = n.first; c >= 0; c = contact_nodes[c].next) {
+        if (contact_nodes[c].next >= 0) contactsCond(c, decisive, skip);
+        else contactsCond(c, when, label);
+    }
+    contactsBind(skip);
+}
+
+// Pushes the network state to the stack
+void contactsValue(int index) {
+    ContactNode& n = contact_nodes[index];
+    if (n.kind == CONTACT_BIT) {
+        contactsRead(n);
+        if (n.inverted) contactsPush(LOGIC_NOT);
+        return;
+    }
+    PLCRuntimeInstructionSet op = n.kind == CONTACT_SERIES ? LOGIC_AND : LOGIC_OR;
+    if (!n.branch_value) {
+        for (int c = n.first; c >= 0; c = contact_nodes[c].next) {
+            contactsValue(c);
+            if (c != n.first) contactsPush(op);
+        }
+        return;
+    }
+    bool decisive = n.kind == CONTACT_PARALLEL;
+    int decided = contactsLabel();
+    int end = contactsLabel();
+    for (int c = n.first; c >= 0; c = contact_nodes[c].next) {
+        if (contact_nodes[c].next >= 0) contactsCond(c, decisive, decided);
+        else contactsValue(c);
+    }
+    contactsJump(JMP, end);
+    contactsBind(decided);
+    contactsPushState(decisive);
+    contactsBind(end);
+}
+
+// Compiles the network following the 'u8.contacts' token at index 'i' and advances 'i' to its last token
+bool compileContacts(int& i) {
+    Token& token = tokens[i];
+    contact_node_count = 0;
+    contact_label_count = 0;
+    contact_patch_count = 0;
+    contact_code_length = 0;
+    contact_overflow = false;
+    expr_token_index = i + 1;
+    expr_token_end = token_count;
+    int root;
+    if (contactsParseParallel(root)) return true;
+    if (exprHasToken() && exprToken().line == token.line) return exprError("unexpected token in contact network");
+    contactsAnalyze(root);
+    contactsValue(root);
+    if (contact_overflow) return buildError(token, "contact network is too complex");
+    for (int p = 0; p < contact_patch_count; p++) {
+        u32 address = built_bytecode_length + contact_label_offset[contact_patches[p].label];
+        u8* jump = contact_code + contact_patches[p].offset;
+        jump[1] = address >> 8;
+        jump[2] = address & 0xFF;
+    }
+    if (exprEmit(token, contact_code, contact_code_length)) return true;
+    i = expr_token_index - 1;
+    return false;
+}
+
+#endif // __WASM__
@@ -0,0 +1,231 @@
+// plcasm-layout.h - 1.0.0 - 2022-12-11
+//
+// Copyright (c) 2022 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#ifdef __WASM__
+
+// ################################################################################################
+// Profile guided block layout
+// ################################################################################################
+// A profile holds the execution count of every bytecode offset of a previous build of the same source,
+// taken from the runtime profiler (setProfiling, loadRuntimeProfile) or set offset by offset (setProfileCount). The offsets
+// are those of the bytecode before the layout, a profile taken from a laid out program is mapped back to them.
+// A profile is used by the next compilation only. When it is present, the basic blocks are reordered after
+// linking so that the more frequent successor of every block falls through:
+//  - 'jmp_if' / 'jmp_if_not' are inverted when their target becomes the fall through block
+//  - 'jmp' to the next block is removed, a 'jmp' is added where a fall through successor was moved away
+//  - blocks ending with a call stay in front of their return address, the entry block stays first
+
+u32 assembly_profile[PLCRUNTIME_MAX_PROGRAM_SIZE];
+bool assembly_profile_loaded = false;
+
+int layout_block_start[MAX_OPT_INSTRUCTIONS];
+int layout_block_end[MAX_OPT_INSTRUCTIONS];
+int layout_block_next[MAX_OPT_INSTRUCTIONS]; // Forced successor (return address of a call), -1 if none
+bool layout_block_placed[MAX_OPT_INSTRUCTIONS];
+int layout_order[MAX_OPT_INSTRUCTIONS];
+int layout_block_count = 0;
+int layout_count_moved = 0;
+int layout_count_inverted = 0;
+// Instructions of the last laid out program: offset after and before the layout (-1 for inserted jumps)
+int layout_map_offset[MAX_OPT_INSTRUCTIONS];
+int layout_map_origin[MAX_OPT_INSTRUCTIONS];
+int layout_map_count = 0;
+bool layout_applied = false;
+
+WASM_EXPORT void clearProfile() {
+    for (u32 i = 0; i < PLCRUNTIME_MAX_PROGRAM_SIZE; i++) assembly_profile[i] = 0;
+    assembly_profile_loaded = false;
+}
+
+WASM_EXPORT void setProfileCount(u32 offset, u32 count) {
+    if (offset >= PLCRUNTIME_MAX_PROGRAM_SIZE) return;
+    assembly_profile[offset] = count;
+    if (count > 0) assembly_profile_loaded = true;
+}
+
+// Take the execution counts of the program built by the last compilation as the profile for the next one
+void layoutLoadProfile(const u32* counts, u32 size) {
+    clearProfile();
+    if (!layout_applied) {
+        for (u32 i = 0; i < size; i++) setProfileCount(i, counts[i]);
+        return;
+    }
+    for (int i = 0; i < layout_map_count; i++) {
+        if (layout_map_origin[i] >= 0 && (u32) layout_map_offset[i] < size) setProfileCount(layout_map_origin[i], counts[layout_map_offset[i]]);
+    }
+}
+
+u32 layoutCount(int block) {
+    int origin = opt_code[layout_block_start[block]].origin;
+    return origin >= 0 ? assembly_profile[origin] : 0;
+}
+
+int layoutBlockOf(int id) {
+    for (int b = 0; b < layout_block_count; b++)
+        if (opt_code[layout_block_start[b]].id == id) return b;
+    return -1;
+}
+
+// Preferred successor of the block: the more frequent of the jump target and the fall through block
+int layoutPreferred(int block) {
+    if (layout_block_next[block] >= 0) return layout_block_next[block];
+    OptInstruction& last = opt_code[layout_block_end[block] - 1];
+    u8 op = last.code[0];
+    int fallthrough = block + 1 < layout_block_count ? block + 1 : -1;
+    if (op == RET || op == EXIT) return -1;
+    if (op == JMP) return layoutBlockOf(last.target);
+    if (op == JMP_IF || op == JMP_IF_NOT) {
+        int taken = layoutBlockOf(last.target);
+        if (taken < 0) return fallthrough;
+        if (fallthrough < 0) return taken;
+        // Per offset counts don't record edges, the edge count is bounded by both ends
+        u32 count = layoutCount(block);
+        u32 taken_count = layoutCount(taken) < count ? layoutCount(taken) : count;
+        u32 fallthrough_count = layoutCount(fallthrough) < count ? layoutCount(fallthrough) : count;
+        return taken_count > fallthrough_count ? taken : fallthrough;
+    }
+    return fallthrough;
+}
+
+bool layoutAppend(int& n, OptInstruction& instruction) {
+    if (n >= MAX_OPT_INSTRUCTIONS) return false;
+    opt_code_next[n++] = instruction;
+    return true;
+}
+
+// Returns true on error
+bool layoutBytecode() {
+    layout_count_moved = 0;
+    layout_count_inverted = 0;
+    if (!optDecode()) {
+        Serial.println(F("Warning: bytecode can not be decoded, skipping block layout"));
+        return false;
+    }
+    optFindLeaders();
+    layout_block_count = 0;
+    for (int i = 0; i < opt_count; i++) {
+        if (!opt_leader[i]) continue;
+        if (layout_block_count > 0) layout_block_end[layout_block_count - 1] = i;
+        layout_block_start[layout_block_count] = i;
+        layout_block_next[layout_block_count] = -1;
+        layout_block_placed[layout_block_count] = false;
+        layout_block_count++;
+    }
+    if (layout_block_count < 2) return false;
+    layout_block_end[layout_block_count - 1] = opt_count;
+    for (int b = 0; b + 1 < layout_block_count; b++) {
+        u8 op = opt_code[layout_block_end[b] - 1].code[0];
+        // Calls return to the next instruction, so that block has to stay right behind
+        if (op == CALL || op == CALL_IF || op == CALL_IF_NOT) layout_block_next[b] = b + 1;
+    }
+
+    // Greedy chains: follow the preferred successor of every placed block
+    int placed = 0;
+    int current = 0;
+    while (placed < layout_block_count) {
+        layout_order[placed++] = current;
+        layout_block_placed[current] = true;
+        int next = layoutPreferred(current);
+        bool forced = next > 0 && layout_block_next[next - 1] == next && next - 1 != current;
+        if (next >= 0 && !layout_block_placed[next] && !forced) {
+            current = next;
+            continue;
+        }
+        // Keep the original order where possible: the fall through block, then the first unplaced block
+        int previous = current;
+        current = -1;
+        if (previous + 1 < layout_block_count && !layout_block_placed[previous + 1]) current = previous + 1;
+        for (int b = 0; b < layout_block_count && current < 0; b++) {
+            if (layout_block_placed[b]) continue;
+            // A return address block is placed only behind its call
+            bool forced = b > 0 && layout_block_next[b - 1] == b;
+            if (!forced) current = b;
+        }
+        if (current < 0) for (int b = 0; b < layout_block_count && current < 0; b++) if (!layout_block_placed[b]) current = b;
+        if (current < 0) break;
+    }
+
+    // Emit blocks in the new order and fix their terminators
+    int n = 0;
+    u8 code[9];
+    for (int k = 0; k < layout_block_count; k++) {
+        int b = layout_order[k];
+        int next_block = k + 1 < layout_block_count ? layout_order[k + 1] : -1;
+        int next_id = next_block >= 0 ? opt_code[layout_block_start[next_block]].id : -1;
+        int fallthrough = b + 1 < layout_block_count ? b + 1 : -1;
+        int fallthrough_id = fallthrough >= 0 ? opt_code[layout_block_start[fallthrough]].id : -1;
+        if (b != k) layout_count_moved++;
+        int last_index = layout_block_end[b] - 1;
+        for (int i = layout_block_start[b]; i < last_index; i++) if (!layoutAppend(n, opt_code[i])) return true;
+        OptInstruction last = opt_code[last_index];
+        u8 op = last.code[0];
+        bool single = last_index == layout_block_start[b];
+        if (op == JMP) {
+            // A jump to the next block is not needed, unless it is a jump target itself
+            if (last.target != next_id || single) if (!layoutAppend(n, last)) return true;
+            continue;
+        }
+        if (op == RET || op == EXIT) {
+            if (!layoutAppend(n, last)) return true;
+            continue;
+        }
+        if ((op == JMP_IF || op == JMP_IF_NOT) && last.target == next_id && fallthrough_id >= 0 && next_id != fallthrough_id) {
+            last.code[0] = op == JMP_IF ? JMP_IF_NOT : JMP_IF;
+            last.target = fallthrough_id;
+            layout_count_inverted++;
+            if (!layoutAppend(n, last)) return true;
+            continue;
+        }
+        if (!layoutAppend(n, last)) return true;
+        if (fallthrough_id == next_id) continue;
+        // The fall through block was moved away
+        OptInstruction jump;
+        if (fallthrough_id >= 0) {
+            u8 size = InstructionCompiler::push_jmp(code, 0);
+            optSetInstruction(jump, code, size, opt_next_id++, -1);
+            jump.target = fallthrough_id;
+        } else {
+            // Falling off the end of the program
+            u8 size = InstructionCompiler::push(code, EXIT);
+            optSetInstruction(jump, code, size, opt_next_id++, -1);
+        }
+        if (!layoutAppend(n, jump)) return true;
+    }
+    for (int i = 0; i < n; i++) opt_code[i] = opt_code_next[i];
+    opt_count = n;
+    if (!optEncode()) {
+        Serial.println(F("Error: program with the new block layout does not fit into the program memory"));
+        return true;
+    }
+    int offset = 0;
+    for (int i = 0; i < opt_count; i++) {
+        layout_map_offset[i] = offset;
+        layout_map_origin[i] = opt_code[i].origin;
+        offset += opt_code[i].size;
+    }
+    layout_map_count = opt_count;
+    layout_applied = true;
+    return false;
+}
+
+#endif // __WASM__
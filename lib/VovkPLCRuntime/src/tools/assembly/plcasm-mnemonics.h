@@ -0,0 +1,111 @@
+// plcasm-mnemonics.h - 1.0.0 - 2022-12-11
+//
+// Copyright (c) 2022 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+
+#pragma once
+
+#ifdef __WASM__
+
+// ################################################################################################
+// Mnemonic lookup
+// ################################################################################################
+// The opcode names of the instruction table are looked up case insensitively through a hash table built on first use.
+// Typed instructions are written as '<type>.<opcode name>' (u8.add, f32.cmp_lt, i16.move_copy), instructions without
+// operands can be written by their opcode name alone (bw_lshift_x8, get_x8_b3, logic_and).
+
+struct MnemonicEntry {
+    const char* name;
+    u8 opcode;
+};
+
+const MnemonicEntry mnemonic_entries[] = {
+#define PLCASM_MNEMONIC(name, opcode, ...) { #name, opcode },
+    PLCRUNTIME_INSTRUCTION_SET(PLCASM_MNEMONIC)
+#ifdef USE_X64_OPS
+    PLCRUNTIME_INSTRUCTION_SET_X64(PLCASM_MNEMONIC)
+#endif
+#undef PLCASM_MNEMONIC
+};
+const int mnemonic_entry_count = sizeof(mnemonic_entries) / sizeof(mnemonic_entries[0]);
+
+#define MNEMONIC_HASH_SIZE 512 // Power of two, at least twice the number of instructions
+
+short mnemonic_hash[MNEMONIC_HASH_SIZE]; // Entry index + 1, 0 if empty
+bool mnemonic_hash_ready = false;
+
+char mnemonicLower(char c) { return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c; }
+
+// FNV-1a of the lower case name
+u32 mnemonicHash(const char* name, int length) {
+    u32 hash = 2166136261u;
+    for (int i = 0; i < length; i++) {
+        hash ^= (u8) mnemonicLower(name[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+bool mnemonicEquals(const MnemonicEntry& entry, const char* name, int length) {
+    for (int i = 0; i < length; i++) if (entry.name[i] == '\0' || mnemonicLower(entry.name[i]) != mnemonicLower(name[i])) return false;
+    return entry.name[length] == '\0';
+}
+
+void mnemonicBuild() {
+    for (int i = 0; i < MNEMONIC_HASH_SIZE; i++) mnemonic_hash[i] = 0;
+    for (int e = 0; e < mnemonic_entry_count; e++) {
+        const char* name = mnemonic_entries[e].name;
+        u32 slot = mnemonicHash(name, string_len(name)) & (MNEMONIC_HASH_SIZE - 1);
+        while (mnemonic_hash[slot]) slot = (slot + 1) & (MNEMONIC_HASH_SIZE - 1);
+        mnemonic_hash[slot] = e + 1;
+    }
+    mnemonic_hash_ready = true;
+}
+
+// Returns the opcode with the given name, -1 if there is none
+int mnemonicLookup(const char* name, int length) {
+    if (!mnemonic_hash_ready) mnemonicBuild();
+    u32 slot = mnemonicHash(name, length) & (MNEMONIC_HASH_SIZE - 1);
+    while (mnemonic_hash[slot]) {
+        const MnemonicEntry& entry = mnemonic_entries[mnemonic_hash[slot] - 1];
+        if (mnemonicEquals(entry, name, length)) return entry.opcode;
+        slot = (slot + 1) & (MNEMONIC_HASH_SIZE - 1);
+    }
+    return -1;
+}
+
+// Opcode of a typed instruction '<type>.<name>' taking a single data type operand, -1 if there is none
+int mnemonicTyped(Token& token) {
+    int dot = -1;
+    for (int i = 0; i < token.string.length && dot < 0; i++) if (token.string[i] == '.') dot = i;
+    if (dot < 0) return -1;
+    int opcode = mnemonicLookup(token.string.data + dot + 1, token.string.length - dot - 1);
+    if (opcode < 0 || OPCODE_OPERANDS((PLCRuntimeInstructionSet) opcode) != OPERANDS_TYPE) return -1;
+    return opcode;
+}
+
+// Opcode of an instruction without operands written by its name alone, -1 if there is none
+int mnemonicPlain(Token& token) {
+    int opcode = mnemonicLookup(token.string.data, token.string.length);
+    if (opcode < 0 || OPCODE_SIZE((PLCRuntimeInstructionSet) opcode) != 1) return -1;
+    return opcode;
+}
+
+#endif // __WASM__
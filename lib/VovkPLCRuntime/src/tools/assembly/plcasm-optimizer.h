@@ -0,0 +1,782 @@
+// plcasm-optimizer.h - 1.0.0 - 2022-12-11
+//
+// Copyright (c) 2022 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#ifdef __WASM__
+
+// ################################################################################################
+// Bytecode optimizer
+// ################################################################################################
+// Enabled in the assembly source with the 'optimize' directive. Loop invariant code motion additionally
+// needs a reserved memory area for hoisted values: 'scratch <address> <size>'
+/*
+    optimize
+    scratch 200 16
+*/
+// The linked bytecode is decoded into an instruction list and split into basic blocks. Every block is
+// executed symbolically: each stack entry gets a value number, so identical values (same constants, same
+// operations on the same inputs, same memory cell with no aliasing store in between) share one number.
+// Blocks reached only by falling through a conditional jump inherit the symbolic state of their predecessor.
+//  - value numbering:    an expression that recomputes the value already on top of the stack becomes 'copy'
+//  - copy propagation:   a store followed by a load of the same cell becomes 'move_copy'
+//  - loop invariants:    expressions inside 'jmp' loops that only read memory the loop never writes are
+//                        computed once before the loop into the scratch area and loaded inside the loop
+// Memory aliasing: stores through a constant pointer only invalidate the overlapping cells, stores through
+// a computed pointer and calls invalidate everything. Loops containing either are not touched by LICM.
+// Passes are repeated until nothing changes, then jump addresses and labels are relocated.
+
+#define MAX_OPT_INSTRUCTIONS MAX_NUM_OF_TOKENS
+#define MAX_OPT_VALUES 512
+#define MAX_OPT_STACK 128
+#define MAX_OPT_CELLS 64
+#define MAX_OPT_PASSES 256
+
+bool assembly_optimize = false;
+int assembly_scratch_address = -1;
+int assembly_scratch_size = 0;
+
+struct OptInstruction {
+    u8 code[9];
+    u8 size;
+    int id;     // Stable identity used as jump target
+    int origin; // Byte offset in the unoptimized bytecode (-1 for inserted instructions)
+    int target; // Id of the jump target instruction (-1 if none)
+};
+
+OptInstruction opt_code[MAX_OPT_INSTRUCTIONS];
+OptInstruction opt_code_next[MAX_OPT_INSTRUCTIONS];
+int opt_count = 0;
+int opt_next_id = 0;
+bool opt_leader[MAX_OPT_INSTRUCTIONS];
+bool opt_jump_target[MAX_OPT_INSTRUCTIONS];
+
+enum OptValueKind {
+    OPT_VALUE_UNKNOWN = 0,
+    OPT_VALUE_CONST,
+    OPT_VALUE_OP,
+    OPT_VALUE_LOAD,
+};
+
+struct OptValue {
+    OptValueKind kind;
+    u8 op;
+    u8 type;
+    u8 type_2;
+    int a;
+    int b;
+    u32 hi;
+    u32 lo;
+    u8 size;
+    bool invariant;
+};
+
+struct OptEntry {
+    int value;
+    u8 size;
+    int start;           // First instruction of the expression that produced this entry
+    bool self_contained; // The expression does not read stack entries below itself
+};
+
+struct OptCell {
+    u32 address;
+    u8 size;
+    int value;
+};
+
+OptValue opt_values[MAX_OPT_VALUES];
+int opt_value_count = 0;
+OptEntry opt_stack[MAX_OPT_STACK];
+int opt_stack_size = 0;
+OptCell opt_cells[MAX_OPT_CELLS];
+int opt_cell_count = 0;
+int opt_barrier = -1;
+int opt_last_move = -1;
+int opt_last_move_value = -1;
+bool opt_failed = false;
+
+// Loop context for LICM
+bool opt_licm = false;
+u32 opt_written_start[MAX_OPT_CELLS];
+u32 opt_written_end[MAX_OPT_CELLS];
+int opt_written_count = 0;
+bool opt_written_unknown = false;
+
+// Found rewrite
+enum OptRewriteKind {
+    OPT_REWRITE_NONE = 0,
+    OPT_REWRITE_COPY,
+    OPT_REWRITE_FORWARD,
+    OPT_REWRITE_HOIST,
+};
+OptRewriteKind opt_rewrite = OPT_REWRITE_NONE;
+int opt_rewrite_start = 0;
+int opt_rewrite_end = 0;
+u8 opt_rewrite_size = 0;
+
+int opt_count_copy = 0;
+int opt_count_forward = 0;
+int opt_count_hoist = 0;
+
+u8 optTypeSize(u8 type) {
+    switch (type) {
+        case type_pointer: return sizeof(MY_PTR_t);
+        case type_bool: case type_u8: case type_i8: return 1;
+        case type_u16: case type_i16: return 2;
+        case type_u32: case type_i32: case type_f32: return 4;
+        case type_u64: case type_i64: case type_f64: return 8;
+        default: return 0;
+    }
+}
+
+PLCRuntimeInstructionSet optTypeOfSize(u8 size) {
+    switch (size) {
+        case 1: return type_u8;
+        case 2: return type_u16;
+        case 4: return type_u32;
+        default: return type_u64;
+    }
+}
+
+bool optIsJump(u8 op) { return op == JMP || op == JMP_IF || op == JMP_IF_NOT || op == CALL || op == CALL_IF || op == CALL_IF_NOT; }
+bool optEndsBlock(u8 op) { return optIsJump(op) || op == RET || op == RET_IF || op == RET_IF_NOT || op == EXIT; }
+bool optIsUnconditional(u8 op) { return op == JMP || op == RET || op == EXIT; }
+
+int optNewValue(OptValueKind kind, u8 size) {
+    if (opt_value_count >= MAX_OPT_VALUES) { opt_failed = true; return 0; }
+    OptValue& v = opt_values[opt_value_count];
+    v.kind = kind;
+    v.op = 0;
+    v.type = 0;
+    v.type_2 = 0;
+    v.a = -1;
+    v.b = -1;
+    v.hi = 0;
+    v.lo = 0;
+    v.size = size;
+    v.invariant = false;
+    return opt_value_count++;
+}
+
+int optConstValue(u8 size, u32 hi, u32 lo) {
+    for (int i = 0; i < opt_value_count; i++) {
+        OptValue& v = opt_values[i];
+        if (v.kind == OPT_VALUE_CONST && v.size == size && v.hi == hi && v.lo == lo) return i;
+    }
+    int index = optNewValue(OPT_VALUE_CONST, size);
+    opt_values[index].hi = hi;
+    opt_values[index].lo = lo;
+    opt_values[index].invariant = true;
+    return index;
+}
+
+int optOpValue(u8 op, u8 type, u8 type_2, int a, int b, u8 size) {
+    for (int i = 0; i < opt_value_count; i++) {
+        OptValue& v = opt_values[i];
+        if (v.kind == OPT_VALUE_OP && v.op == op && v.type == type && v.type_2 == type_2 && v.a == a && v.b == b) return i;
+    }
+    int index = optNewValue(OPT_VALUE_OP, size);
+    OptValue& v = opt_values[index];
+    v.op = op;
+    v.type = type;
+    v.type_2 = type_2;
+    v.a = a;
+    v.b = b;
+    v.invariant = opt_values[a].invariant && (b < 0 || opt_values[b].invariant);
+    // Integer division is not hoisted, because moving it out of a guarded path could divide by zero
+    bool integer = type != type_f32 && type != type_f64;
+    if ((op == DIV || op == MOD) && integer) v.invariant = false;
+    return index;
+}
+
+bool optOverlaps(u32 a_start, u32 a_size, u32 b_start, u32 b_size) {
+    return a_start < b_start + b_size && b_start < a_start + a_size;
+}
+
+bool optIsWrittenInLoop(u32 address, u8 size) {
+    if (opt_written_unknown) return true;
+    for (int i = 0; i < opt_written_count; i++)
+        if (optOverlaps(address, size, opt_written_start[i], opt_written_end[i] - opt_written_start[i])) return true;
+    return false;
+}
+
+int optLoadValue(u32 address, u8 size) {
+    // Cells written inside the loop can't be read ahead of it
+    if (opt_licm && optIsWrittenInLoop(address, size)) return optNewValue(OPT_VALUE_LOAD, size);
+    for (int i = 0; i < opt_cell_count; i++) {
+        OptCell& c = opt_cells[i];
+        if (c.address == address && c.size == size) return c.value;
+    }
+    int index = optNewValue(OPT_VALUE_LOAD, size);
+    opt_values[index].lo = address;
+    opt_values[index].invariant = opt_licm && address + size <= PLCRUNTIME_MAX_MEMORY_SIZE;
+    bool overlapping = false;
+    for (int i = 0; i < opt_cell_count; i++)
+        if (optOverlaps(address, size, opt_cells[i].address, opt_cells[i].size)) overlapping = true;
+    if (!overlapping && opt_cell_count < MAX_OPT_CELLS) {
+        opt_cells[opt_cell_count].address = address;
+        opt_cells[opt_cell_count].size = size;
+        opt_cells[opt_cell_count].value = index;
+        opt_cell_count++;
+    }
+    return index;
+}
+
+void optStoreValue(u32 address, u8 size, int value) {
+    int j = 0;
+    for (int i = 0; i < opt_cell_count; i++)
+        if (!optOverlaps(address, size, opt_cells[i].address, opt_cells[i].size)) opt_cells[j++] = opt_cells[i];
+    opt_cell_count = j;
+    if (value >= 0 && opt_cell_count < MAX_OPT_CELLS) {
+        opt_cells[opt_cell_count].address = address;
+        opt_cells[opt_cell_count].size = size;
+        opt_cells[opt_cell_count].value = value;
+        opt_cell_count++;
+    }
+}
+
+bool optPointerConst(OptEntry& entry, u32& address) {
+    OptValue& v = opt_values[entry.value];
+    if (v.kind != OPT_VALUE_CONST || entry.size != sizeof(MY_PTR_t)) return false;
+    address = v.lo;
+    return true;
+}
+
+void optPush(int value, u8 size, int start, bool self_contained) {
+    if (opt_stack_size >= MAX_OPT_STACK) { opt_failed = true; return; }
+    OptEntry& e = opt_stack[opt_stack_size++];
+    e.value = value;
+    e.size = size;
+    e.start = start;
+    e.self_contained = self_contained;
+}
+
+// Pops an entry of the expected size. Values from before the block are unknown, mismatched sizes stop the analysis.
+OptEntry optPop(u8 size) {
+    OptEntry e;
+    if (opt_stack_size == 0) {
+        e.value = optNewValue(OPT_VALUE_UNKNOWN, size);
+        e.size = size;
+        e.start = -1;
+        e.self_contained = false;
+        return e;
+    }
+    e = opt_stack[--opt_stack_size];
+    if (e.size != size) opt_failed = true;
+    return e;
+}
+
+void optResetState() {
+    opt_value_count = 0;
+    opt_stack_size = 0;
+    opt_cell_count = 0;
+}
+
+void optRecordRewrite(OptRewriteKind kind, int start, int end, u8 size) {
+    opt_rewrite = kind;
+    opt_rewrite_start = start;
+    opt_rewrite_end = end;
+    opt_rewrite_size = size;
+}
+
+// Checks the entry that instruction 'i' just produced for a rewrite opportunity
+void optCheckEntry(int i) {
+    OptEntry& e = opt_stack[opt_stack_size - 1];
+    if (e.start <= opt_barrier) return;
+    int bytes = 0;
+    for (int j = e.start; j <= i; j++) bytes += opt_code[j].size;
+    if (opt_licm) {
+        // Worth hoisting only if the expression is longer than the 'ptr.const + load' that replaces it
+        if (e.self_contained && opt_values[e.value].invariant && i - e.start + 1 >= 3) optRecordRewrite(OPT_REWRITE_HOIST, e.start, i, e.size);
+        return;
+    }
+    if (!e.self_contained) return;
+    if (opt_last_move >= 0 && e.start == opt_last_move + 1 && e.value == opt_last_move_value) {
+        optRecordRewrite(OPT_REWRITE_FORWARD, e.start, i, e.size);
+        return;
+    }
+    if (opt_stack_size >= 2) {
+        OptEntry& below = opt_stack[opt_stack_size - 2];
+        if (below.value == e.value && below.size == e.size && bytes > 2) optRecordRewrite(OPT_REWRITE_COPY, e.start, i, e.size);
+    }
+}
+
+// Symbolically executes instruction 'i'. Returns true if the instruction produced a checkable stack entry.
+bool optStep(int i) {
+    OptInstruction& ins = opt_code[i];
+    u8 op = ins.code[0];
+    if (op >= type_pointer && op <= type_f64) {
+        u8 size = optTypeSize(op);
+        u32 hi = 0, lo = 0;
+        for (int j = 0; j < size; j++) {
+            hi = (hi << 8) | (lo >> 24);
+            lo = (lo << 8) | ins.code[1 + j];
+        }
+        optPush(optConstValue(size, hi, lo), size, i, true);
+        return true;
+    }
+    if (op >= GET_X8_B0 && op <= RSET_X8_B7) {
+        OptEntry a = optPop(1);
+        optPush(optOpValue(op, 0, 0, a.value, -1, 1), 1, a.start, a.self_contained);
+        return true;
+    }
+    if (op >= READ_X8_B0 && op <= READ_X8_B7) {
+        u32 address = ((u32) ins.code[1] << 8) | ins.code[2];
+        int byte = optLoadValue(address, 1);
+        optPush(optOpValue(GET_X8_B0 + (op - READ_X8_B0), 0, 0, byte, -1, 1), 1, i, true);
+        return true;
+    }
+    if (op >= WRITE_X8_B0 && op <= WRITE_INV_X8_B7) {
+        if (op <= WRITE_X8_B7) optPop(1);
+        u32 address = ((u32) ins.code[1] << 8) | ins.code[2];
+        optStoreValue(address, 1, -1);
+        opt_barrier = i;
+        return false;
+    }
+    u8 type = ins.code[1];
+    u8 size = optTypeSize(type);
+    switch (op) {
+        case NOP: opt_barrier = i; return false;
+        case CVT: {
+            u8 to_size = optTypeSize(ins.code[2]);
+            if (!size || !to_size) { opt_failed = true; return false; }
+            OptEntry a = optPop(size);
+            optPush(optOpValue(op, type, ins.code[2], a.value, -1, to_size), to_size, a.start, a.self_contained);
+            return true;
+        }
+        case LOAD: {
+            if (!size) { opt_failed = true; return false; }
+            OptEntry p = optPop(sizeof(MY_PTR_t));
+            u32 address = 0;
+            if (optPointerConst(p, address)) optPush(optLoadValue(address, size), size, p.start, p.self_contained);
+            else optPush(optNewValue(OPT_VALUE_LOAD, size), size, p.start, false);
+            return true;
+        }
+        case MOVE:
+        case MOVE_COPY: {
+            if (!size) { opt_failed = true; return false; }
+            OptEntry v = optPop(size);
+            OptEntry p = optPop(sizeof(MY_PTR_t));
+            u32 address = 0;
+            if (optPointerConst(p, address)) optStoreValue(address, size, v.value);
+            else opt_cell_count = 0;
+            if (op == MOVE_COPY) optPush(v.value, size, i, false);
+            opt_barrier = i;
+            opt_last_move = op == MOVE ? i : -1;
+            opt_last_move_value = v.value;
+            return false;
+        }
+        case COPY: {
+            if (!size) { opt_failed = true; return false; }
+            OptEntry a = optPop(size);
+            optPush(a.value, a.size, a.start, a.self_contained);
+            optPush(a.value, size, i, false);
+            return true;
+        }
+        case SWAP: {
+            u8 size_b = optTypeSize(ins.code[2]);
+            if (!size || !size_b) { opt_failed = true; return false; }
+            OptEntry b = optPop(size_b);
+            OptEntry a = optPop(size);
+            optPush(b.value, b.size, b.start, false);
+            optPush(a.value, a.size, a.start, false);
+            opt_barrier = i;
+            return false;
+        }
+        case DROP: {
+            if (!size) { opt_failed = true; return false; }
+            optPop(size);
+            opt_barrier = i;
+            return false;
+        }
+        case CLEAR: opt_stack_size = 0; opt_barrier = i; return false;
+        case ADD: case SUB: case MUL: case DIV: case MOD: case POW:
+        case CMP_EQ: case CMP_NEQ: case CMP_GT: case CMP_LT: case CMP_GTE: case CMP_LTE: {
+            if (!size) { opt_failed = true; return false; }
+            OptEntry b = optPop(size);
+            OptEntry a = optPop(size);
+            u8 result_size = op >= CMP_EQ ? 1 : size;
+            optPush(optOpValue(op, type, 0, a.value, b.value, result_size), result_size, a.start < b.start ? a.start : b.start, a.self_contained && b.self_contained);
+            return true;
+        }
+        case SQRT: case NEG: case ABS: case SIN: case COS: {
+            if (!size) { opt_failed = true; return false; }
+            OptEntry a = optPop(size);
+            optPush(optOpValue(op, type, 0, a.value, -1, size), size, a.start, a.self_contained);
+            return true;
+        }
+        default: break;
+    }
+    u8 bw_size = 0;
+    bool unary = false;
+    switch (op) {
+        case BW_AND_X8: case BW_OR_X8: case BW_XOR_X8: case BW_LSHIFT_X8: case BW_RSHIFT_X8: bw_size = 1; break;
+        case BW_AND_X16: case BW_OR_X16: case BW_XOR_X16: case BW_LSHIFT_X16: case BW_RSHIFT_X16: bw_size = 2; break;
+        case BW_AND_X32: case BW_OR_X32: case BW_XOR_X32: case BW_LSHIFT_X32: case BW_RSHIFT_X32: bw_size = 4; break;
+        case BW_AND_X64: case BW_OR_X64: case BW_XOR_X64: case BW_LSHIFT_X64: case BW_RSHIFT_X64: bw_size = 8; break;
+        case BW_NOT_X8: bw_size = 1; unary = true; break;
+        case BW_NOT_X16: bw_size = 2; unary = true; break;
+        case BW_NOT_X32: bw_size = 4; unary = true; break;
+        case BW_NOT_X64: bw_size = 8; unary = true; break;
+        case LOGIC_AND: case LOGIC_OR: case LOGIC_XOR: bw_size = 1; break;
+        case LOGIC_NOT: bw_size = 1; unary = true; break;
+        default: break;
+    }
+    if (bw_size) {
+        OptEntry b = optPop(bw_size);
+        if (unary) {
+            optPush(optOpValue(op, 0, 0, b.value, -1, bw_size), bw_size, b.start, b.self_contained);
+            return true;
+        }
+        OptEntry a = optPop(bw_size);
+        optPush(optOpValue(op, 0, 0, a.value, b.value, bw_size), bw_size, a.start < b.start ? a.start : b.start, a.self_contained && b.self_contained);
+        return true;
+    }
+    if (op == JMP_IF || op == JMP_IF_NOT) { optPop(1); opt_barrier = i; return false; }
+    // Calls, returns and anything unknown: nothing is known about the stack or memory afterwards
+    opt_stack_size = 0;
+    opt_cell_count = 0;
+    opt_barrier = i;
+    return false;
+}
+
+// Simulates instructions [begin, end). Stops at the first rewrite found. Returns false if the block can't be modeled.
+bool optSimulate(int begin, int end) {
+    opt_barrier = begin - 1;
+    opt_last_move = -1;
+    opt_failed = false;
+    for (int i = begin; i < end; i++) {
+        bool produced = optStep(i);
+        if (opt_failed) return false;
+        if (produced) optCheckEntry(i);
+        if (opt_rewrite != OPT_REWRITE_NONE) return true;
+    }
+    return true;
+}
+
+void optFindLeaders() {
+    for (int i = 0; i < opt_count; i++) {
+        opt_leader[i] = i == 0;
+        opt_jump_target[i] = false;
+    }
+    for (int i = 0; i < opt_count; i++) {
+        OptInstruction& ins = opt_code[i];
+        if (optEndsBlock(ins.code[0]) && i + 1 < opt_count) opt_leader[i + 1] = true;
+        if (ins.target >= 0) {
+            for (int j = 0; j < opt_count; j++) {
+                if (opt_code[j].id == ins.target) {
+                    opt_leader[j] = true;
+                    opt_jump_target[j] = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+int optIndexOf(int id) {
+    for (int i = 0; i < opt_count; i++) if (opt_code[i].id == id) return i;
+    return -1;
+}
+
+int optBlockEnd(int begin) {
+    int end = begin + 1;
+    while (end < opt_count && !opt_leader[end]) end++;
+    return end;
+}
+
+// Finds a local rewrite (value numbering or copy propagation) in any basic block
+bool optFindLocalRewrite() {
+    opt_licm = false;
+    int begin = 0;
+    bool carry = false;
+    while (begin < opt_count) {
+        int end = optBlockEnd(begin);
+        // Keep the symbolic state when the block is only reached by falling through a conditional jump
+        if (!carry) optResetState();
+        optSimulate(begin, end);
+        if (opt_rewrite != OPT_REWRITE_NONE) return true;
+        u8 last = opt_code[end - 1].code[0];
+        carry = !opt_failed && end < opt_count && !opt_jump_target[end] && (last == JMP_IF || last == JMP_IF_NOT);
+        begin = end;
+    }
+    return false;
+}
+
+// Collects the memory written by instructions [begin, end]. Returns false if a write can not be resolved.
+bool optCollectLoopWrites(int begin, int end) {
+    opt_written_count = 0;
+    opt_written_unknown = false;
+    opt_licm = false;
+    int i = begin;
+    while (i <= end) {
+        int block_end = optBlockEnd(i);
+        if (block_end > end + 1) block_end = end + 1;
+        optResetState();
+        opt_barrier = i - 1;
+        opt_failed = false;
+        for (int j = i; j < block_end; j++) {
+            OptInstruction& ins = opt_code[j];
+            u8 op = ins.code[0];
+            if (op == CALL || op == CALL_IF || op == CALL_IF_NOT) return false;
+            // Runtime instructions act outside the stack like a call: the chart runs its action segments, a recipe request
+            // schedules a write of its parameter block
+            if (op == SFC || op == RECIPE) return false;
+            // String writes go through computed pointers
+            if (op == STR_COPY_UNTIL || op == STR_ITOA) return false;
+            u32 address = 0;
+            u8 size = 0;
+            bool write = false;
+            if (op == MOVE || op == MOVE_COPY) {
+                size = optTypeSize(ins.code[1]);
+                if (opt_stack_size < 2 || !optPointerConst(opt_stack[opt_stack_size - 2], address)) return false;
+                write = true;
+            }
+            if (op >= WRITE_X8_B0 && op <= WRITE_INV_X8_B7) {
+                address = ((u32) ins.code[1] << 8) | ins.code[2];
+                size = 1;
+                write = true;
+            }
+            if (write) {
+                if (opt_written_count >= MAX_OPT_CELLS) return false;
+                opt_written_start[opt_written_count] = address;
+                opt_written_end[opt_written_count] = address + size;
+                opt_written_count++;
+            }
+            optStep(j);
+            if (opt_failed) return false;
+        }
+        i = block_end;
+    }
+    return true;
+}
+
+// Finds a loop invariant expression in a loop built from a backward jump
+bool optFindHoist(int& header) {
+    if (assembly_scratch_address < 0) return false;
+    for (int l = 0; l < opt_count; l++) {
+        OptInstruction& jump = opt_code[l];
+        u8 op = jump.code[0];
+        if (op != JMP && op != JMP_IF && op != JMP_IF_NOT) continue;
+        int h = optIndexOf(jump.target);
+        if (h < 0 || h > l) continue;
+        // The loop must be entered by falling into its header, and only left or repeated from inside
+        if (h > 0 && optIsUnconditional(opt_code[h - 1].code[0])) continue;
+        bool valid = true;
+        for (int j = 0; j < opt_count && valid; j++) {
+            if (j >= h && j <= l) continue;
+            int t = opt_code[j].target >= 0 ? optIndexOf(opt_code[j].target) : -1;
+            if (t >= h && t <= l) valid = false;
+        }
+        if (!valid) continue;
+        if (!optCollectLoopWrites(h, l)) continue;
+        opt_licm = true;
+        int begin = h;
+        while (begin <= l) {
+            int end = optBlockEnd(begin);
+            if (end > l + 1) end = l + 1;
+            optResetState();
+            optSimulate(begin, end);
+            if (opt_rewrite != OPT_REWRITE_NONE) {
+                if (assembly_scratch_size < opt_rewrite_size) {
+                    opt_rewrite = OPT_REWRITE_NONE;
+                    opt_licm = false;
+                    return false;
+                }
+                opt_licm = false;
+                header = h;
+                return true;
+            }
+            begin = end;
+        }
+        opt_licm = false;
+    }
+    return false;
+}
+
+void optSetInstruction(OptInstruction& ins, u8* code, u8 size, int id, int origin) {
+    for (int j = 0; j < size; j++) ins.code[j] = code[j];
+    ins.size = size;
+    ins.id = id;
+    ins.origin = origin;
+    ins.target = -1;
+}
+
+// Replaces instructions [start, end] with the given instructions, inserting 'pre' instructions before 'header'
+bool optReplace(int start, int end, OptInstruction* with, int with_count, int header, OptInstruction* pre, int pre_count) {
+    int count = opt_count - (end - start + 1) + with_count + pre_count;
+    if (count > MAX_OPT_INSTRUCTIONS) return false;
+    int n = 0;
+    for (int i = 0; i < opt_count; i++) {
+        if (i == header) for (int j = 0; j < pre_count; j++) opt_code_next[n++] = pre[j];
+        if (i == start) for (int j = 0; j < with_count; j++) opt_code_next[n++] = with[j];
+        if (i >= start && i <= end) continue;
+        opt_code_next[n++] = opt_code[i];
+    }
+    for (int i = 0; i < n; i++) opt_code[i] = opt_code_next[i];
+    opt_count = n;
+    return true;
+}
+
+bool optApplyRewrite(int header) {
+    int start = opt_rewrite_start;
+    int end = opt_rewrite_end;
+    PLCRuntimeInstructionSet type = optTypeOfSize(opt_rewrite_size);
+    OptInstruction with[2];
+    u8 code[9];
+    bool ok = false;
+    if (opt_rewrite == OPT_REWRITE_COPY) {
+        u8 size = InstructionCompiler::push_copy(code, type);
+        optSetInstruction(with[0], code, size, opt_code[start].id, opt_code[start].origin);
+        ok = optReplace(start, end, with, 1, -1, 0, 0);
+        if (ok) opt_count_copy++;
+    }
+    if (opt_rewrite == OPT_REWRITE_FORWARD) {
+        // The preceding 'move' becomes 'move_copy' and the reload disappears
+        OptInstruction& move = opt_code[start - 1];
+        move.code[0] = MOVE_COPY;
+        ok = optReplace(start, end, with, 0, -1, 0, 0);
+        if (ok) opt_count_forward++;
+    }
+    if (opt_rewrite == OPT_REWRITE_HOIST) {
+        static OptInstruction pre[MAX_OPT_INSTRUCTIONS];
+        int pre_count = 0;
+        u32 slot = assembly_scratch_address;
+        u8 size = InstructionCompiler::push_pointer(code, slot);
+        optSetInstruction(pre[pre_count++], code, size, opt_next_id++, -1);
+        for (int i = start; i <= end; i++) {
+            pre[pre_count] = opt_code[i];
+            pre[pre_count].id = opt_next_id++;
+            pre[pre_count].origin = -1;
+            pre_count++;
+        }
+        size = InstructionCompiler::push_move(code, type);
+        optSetInstruction(pre[pre_count++], code, size, opt_next_id++, -1);
+        size = InstructionCompiler::push_pointer(code, slot);
+        optSetInstruction(with[0], code, size, opt_code[start].id, opt_code[start].origin);
+        size = InstructionCompiler::push_load(code, type);
+        optSetInstruction(with[1], code, size, opt_next_id++, -1);
+        ok = optReplace(start, end, with, 2, header, pre, pre_count);
+        if (ok) {
+            assembly_scratch_address += opt_rewrite_size;
+            assembly_scratch_size -= opt_rewrite_size;
+            opt_count_hoist++;
+        }
+    }
+    opt_rewrite = OPT_REWRITE_NONE;
+    return ok;
+}
+
+bool optDecode() {
+    static int index_at[PLCRUNTIME_MAX_PROGRAM_SIZE];
+    opt_count = 0;
+    int offset = 0;
+    while (offset < built_bytecode_length) {
+        index_at[offset] = -1;
+        u8 size = OPCODE_SIZE((PLCRuntimeInstructionSet) built_bytecode[offset]);
+        if (size == 0 || size > 9 || offset + size > built_bytecode_length) return false;
+        if (opt_count >= MAX_OPT_INSTRUCTIONS) return false;
+        OptInstruction& ins = opt_code[opt_count];
+        optSetInstruction(ins, built_bytecode + offset, size, opt_count, offset);
+        for (int j = 1; j < size; j++) index_at[offset + j] = -1;
+        index_at[offset] = opt_count;
+        opt_count++;
+        offset += size;
+    }
+    opt_next_id = opt_count;
+    for (int i = 0; i < opt_count; i++) {
+        OptInstruction& ins = opt_code[i];
+        if (!optIsJump(ins.code[0])) continue;
+        int address = (ins.code[1] << 8) | ins.code[2];
+        if (address >= built_bytecode_length || index_at[address] < 0) return false;
+        ins.target = opt_code[index_at[address]].id;
+    }
+    return true;
+}
+
+bool optEncode() {
+    static int offset_of[MAX_OPT_INSTRUCTIONS * 2];
+    int length = 0;
+    for (int i = 0; i < opt_count; i++) {
+        if (opt_code[i].id >= MAX_OPT_INSTRUCTIONS * 2) return false;
+        offset_of[opt_code[i].id] = length;
+        length += opt_code[i].size;
+    }
+    if (length >= PLCRUNTIME_MAX_PROGRAM_SIZE) return false;
+    // Labels follow their instruction, or the first remaining instruction after their original address
+    for (int l = 0; l < LUT_label_count; l++) {
+        LUT_label& label = LUT_labels[l];
+        int address = -1;
+        for (int i = 0; i < opt_count && address < 0; i++)
+            if (opt_code[i].origin == label.address) address = offset_of[opt_code[i].id];
+        for (int i = 0; i < opt_count && address < 0; i++)
+            if (opt_code[i].origin >= label.address) address = offset_of[opt_code[i].id];
+        label.address = address < 0 ? length : address;
+    }
+    built_bytecode_length = 0;
+    built_bytecode_checksum = 0;
+    for (int i = 0; i < opt_count; i++) {
+        OptInstruction& ins = opt_code[i];
+        if (ins.target >= 0) {
+            int address = offset_of[ins.target];
+            ins.code[1] = address >> 8;
+            ins.code[2] = address & 0xFF;
+        }
+        for (int j = 0; j < ins.size; j++) {
+            built_bytecode[built_bytecode_length++] = ins.code[j];
+            crc8_simple(built_bytecode_checksum, ins.code[j]);
+        }
+    }
+    return true;
+}
+
+// Returns true on error
+bool optimizeBytecode() {
+    opt_count_copy = 0;
+    opt_count_forward = 0;
+    opt_count_hoist = 0;
+    if (!optDecode()) {
+        Serial.println(F("Warning: bytecode can not be optimized, skipping optimization"));
+        return false;
+    }
+    opt_rewrite = OPT_REWRITE_NONE;
+    for (int pass = 0; pass < MAX_OPT_PASSES; pass++) {
+        optFindLeaders();
+        int header = -1;
+        if (optFindLocalRewrite()) {
+            if (!optApplyRewrite(-1)) break;
+            continue;
+        }
+        if (optFindHoist(header)) {
+            if (!optApplyRewrite(header)) break;
+            continue;
+        }
+        break;
+    }
+    opt_rewrite = OPT_REWRITE_NONE;
+    if (!optEncode()) {
+        Serial.println(F("Error: optimized program does not fit into the program memory"));
+        return true;
+    }
+    return false;
+}
+
+#endif // __WASM__
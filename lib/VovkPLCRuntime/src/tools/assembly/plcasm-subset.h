@@ -0,0 +1,70 @@
+// plcasm-subset.h - 1.0.0 - 2022-12-11
+//
+// Copyright (c) 2022 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+
+#pragma once
+
+#ifdef __WASM__
+
+// ################################################################################################
+// Instruction subset
+// ################################################################################################
+// Prints the instructions and data types used by the built program as defines for a firmware which runs only this
+// program (see the instruction subset in runtime-instruction-table.h). Constant data types are pushed by their own
+// instruction ('type_u8'), data types given as operands are listed separately ('PLCRUNTIME_USE_DATA_type_u8').
+
+bool subset_opcode[256];
+bool subset_data_type[256];
+
+const char* subsetName(u8 opcode) {
+    for (int e = 0; e < mnemonic_entry_count; e++) if (mnemonic_entries[e].opcode == opcode) return mnemonic_entries[e].name;
+    return 0;
+}
+
+WASM_EXPORT void printInstructionSubset() {
+    for (int i = 0; i < 256; i++) subset_opcode[i] = subset_data_type[i] = false;
+    int index = 0;
+    while (index < built_bytecode_length) {
+        u8* code = built_bytecode + index;
+        u8 size = OPCODE_SIZE((PLCRuntimeInstructionSet) code[0]);
+        if (size == 0 || index + size > built_bytecode_length) {
+            Serial.print(F("Error: invalid instruction at offset ")); Serial.println(index);
+            return;
+        }
+        subset_opcode[code[0]] = true;
+        PLCRuntimeOperandLayout operands = OPCODE_OPERANDS((PLCRuntimeInstructionSet) code[0]);
+        if (operands == OPERANDS_TYPE || operands == OPERANDS_TYPE_TYPE || operands == OPERANDS_TYPE_LOCAL) subset_data_type[code[1]] = true;
+        if (operands == OPERANDS_TYPE_TYPE) subset_data_type[code[2]] = true;
+        index += size;
+    }
+    Serial.println(F("// Instruction subset of the program, define before including the runtime"));
+    Serial.println(F("#define PLCRUNTIME_INSTRUCTION_SUBSET"));
+    for (int i = 0; i < 256; i++) {
+        if (!subset_opcode[i] || !subsetName(i)) continue;
+        Serial.print(F("#define PLCRUNTIME_USE_")); Serial.print(subsetName(i)); Serial.println(F(" 1"));
+    }
+    for (int i = 0; i < 256; i++) {
+        if (!subset_data_type[i] || !subsetName(i)) continue;
+        Serial.print(F("#define PLCRUNTIME_USE_DATA_")); Serial.print(subsetName(i)); Serial.println(F(" 1"));
+    }
+}
+
+#endif // __WASM__
@@ -0,0 +1,97 @@
+// plcasm-tags.h - 1.0.0 - 2022-12-11
+//
+// Copyright (c) 2022 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+
+#pragma once
+
+#if defined(__WASM__) && defined(PLCRUNTIME_TAGS)
+
+// ################################################################################################
+// Tag table
+// ################################################################################################
+// The 'tag' directive declares a named memory value for the HMI and the tools:
+//
+//    tag motor_speed u16 16
+//    tag valve_open bool 20
+//
+// The assembler collects the tags into the table format of the runtime tag database (tags/runtime-tags.h),
+// which is loaded into the runtime together with the program. Names are only kept as their hash, so two names
+// with the same hash are rejected here instead of shadowing each other in the runtime.
+
+TagEntry assembly_tags[PLCRUNTIME_TAG_MAX_COUNT];
+StringView assembly_tag_names[PLCRUNTIME_TAG_MAX_COUNT];
+int assembly_tag_count = 0;
+
+bool addAssemblyTag(Token& name, u8 type, int address) {
+    u32 hash = tagNameHash(name.string.data, name.string.length);
+    for (int i = 0; i < assembly_tag_count; i++) {
+        if (str_cmp(assembly_tag_names[i], name.string)) return buildError(name, "duplicate tag");
+        if (assembly_tags[i].hash == hash) return buildError(name, "tag name hash collides with another tag");
+    }
+    if (assembly_tag_count >= PLCRUNTIME_TAG_MAX_COUNT) return buildError(name, "too many tags");
+    int size = typeSize(type) / 8;
+    if (address < 0 || address + size > PLCRUNTIME_MAX_MEMORY_SIZE) return buildError(name, "tag out of memory bounds");
+    TagEntry& tag = assembly_tags[assembly_tag_count];
+    tag.hash = hash;
+    tag.address = address;
+    tag.type = type;
+    tag.size = size;
+    assembly_tag_names[assembly_tag_count] = name.string;
+    assembly_tag_count++;
+    return false;
+}
+
+void printAssemblyTags() {
+    if (assembly_tag_count == 0) {
+        Serial.println(F("No tags"));
+        return;
+    }
+    Serial.print(F("Tags ")); Serial.print(assembly_tag_count); Serial.println(F(":"));
+    for (int i = 0; i < assembly_tag_count; i++) {
+        TagEntry& tag = assembly_tags[i];
+        Serial.print(F("    ")); assembly_tag_names[i].print();
+        Serial.print(F(" = ")); Serial.print(tag.address); Serial.print(F(" (")); Serial.print(tag.size);
+        Serial.print(F(" bytes, hash 0x")); Serial.print(tag.hash, HEX); Serial.println(F(")"));
+    }
+}
+
+void printTagHex(u32 value, u8 size) {
+    char c1, c2;
+    for (u8 i = size; i > 0; i--) {
+        byteToHex((value >> ((i - 1) * 8)) & 0xFF, c1, c2);
+        streamOut(c1);
+        streamOut(c2);
+    }
+}
+
+// Print the assembled tag table in the table format as hex, returns the number of tags
+WASM_EXPORT u32 uploadTagTable() {
+    printTagHex(assembly_tag_count, 2);
+    for (int i = 0; i < assembly_tag_count; i++) {
+        printTagHex(assembly_tags[i].hash, 4);
+        printTagHex(assembly_tags[i].address, 4);
+        printTagHex(assembly_tags[i].type, 1);
+        printTagHex(assembly_tags[i].size, 1);
+    }
+    return assembly_tag_count;
+}
+
+#endif // __WASM__ && PLCRUNTIME_TAGS
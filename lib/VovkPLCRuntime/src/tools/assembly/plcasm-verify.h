@@ -0,0 +1,154 @@
+// plcasm-verify.h - 1.0.0 - 2022-12-11
+//
+// Copyright (c) 2022 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+
+#pragma once
+
+#ifdef __WASM__
+
+// ################################################################################################
+// Stack verifier
+// ################################################################################################
+// Follows every path through the built bytecode with the stack effects from the instruction table and warns when:
+//  - an instruction takes more from the stack than there is on it
+//  - an instruction is reached with a different stack size on different paths
+//  - the stack grows over PLCRUNTIME_MAX_STACK_SIZE
+// Every function is followed once from its entry with an empty stack, it may take values left by its caller.
+// A call applies the stack size change of the function returns to the caller.
+// The runtime checks the stack while running as well, so these are warnings and the program is still built.
+
+#define VERIFY_UNSEEN -0x7FFFFFFF
+#define MAX_VERIFY_WARNINGS 8
+
+int verify_depth[MAX_OPT_INSTRUCTIONS];
+int verify_owner[MAX_OPT_INSTRUCTIONS];         // Entry of the function the depth belongs to
+u8 verify_function_state[MAX_OPT_INSTRUCTIONS]; // 0 = not verified, 1 = in progress, 2 = done
+int verify_function_net[MAX_OPT_INSTRUCTIONS];  // Stack size at return relative to the entry, VERIFY_UNSEEN if it never returns
+int verify_function_min[MAX_OPT_INSTRUCTIONS];  // Lowest stack size relative to the entry
+int verify_function_max[MAX_OPT_INSTRUCTIONS];  // Highest stack size relative to the entry
+int verify_work[MAX_OPT_INSTRUCTIONS * 2];
+int verify_work_top = 0;
+int verify_warnings = 0;
+int verify_stack_size = 0;                      // Highest stack size of the program
+bool verify_incomplete = false;
+
+void verifyWarning(int i, const char* message) {
+    if (verify_warnings++ >= MAX_VERIFY_WARNINGS) return;
+    Serial.println();
+    Serial.print(F("Warning: ")); Serial.print(message);
+    if (i < 0) return;
+    int line = opt_code[i].origin >= 0 ? wcetLine(opt_code[i].origin) : 0;
+    if (line > 0) { Serial.print(F(" at line ")); Serial.print(line); }
+    else { Serial.print(F(" at offset ")); Serial.print(opt_code[i].origin); }
+}
+
+void verifyReach(int entry, int i, int depth) {
+    if (i < 0 || i >= opt_count) return;
+    if (verify_owner[i] != entry) {
+        if (verify_work_top >= MAX_OPT_INSTRUCTIONS * 2) { verify_incomplete = true; return; }
+        verify_owner[i] = entry;
+        verify_depth[i] = depth;
+        verify_work[verify_work_top++] = i;
+        return;
+    }
+    if (verify_depth[i] != depth) {
+        verifyWarning(i, "stack size differs between paths");
+        verify_depth[i] = depth > verify_depth[i] ? depth : verify_depth[i];
+    }
+}
+
+void verifyFunction(int entry) {
+    bool main = entry == 0;
+    verify_function_state[entry] = 1;
+    verify_function_net[entry] = VERIFY_UNSEEN;
+    verify_function_min[entry] = 0;
+    verify_function_max[entry] = 0;
+    int base = verify_work_top;
+    verifyReach(entry, entry, 0);
+    while (verify_work_top > base) {
+        int i = verify_work[--verify_work_top];
+        OptInstruction& ins = opt_code[i];
+        u8 op = ins.code[0];
+        int depth = verify_depth[i];
+        u16 pop = 0, push = 0;
+        if (OPCODE_STACK_EFFECT(ins.code, pop, push) != STATUS_SUCCESS) { verifyWarning(i, "invalid instruction"); continue; }
+        if (pop == STACK_EFFECT_ALL) depth = 0;
+        else {
+            depth -= pop;
+            if (main && depth < 0) { verifyWarning(i, "stack underflow"); continue; }
+            if (depth < verify_function_min[entry]) verify_function_min[entry] = depth;
+            depth += push;
+        }
+        if (depth > verify_function_max[entry]) verify_function_max[entry] = depth;
+        int next = i + 1;
+        if (op == JMP) { verifyReach(entry, ins.target, depth); continue; }
+        if (op == JMP_IF || op == JMP_IF_NOT) { verifyReach(entry, ins.target, depth); verifyReach(entry, next, depth); continue; }
+        if (op == CALL || op == CALL_IF || op == CALL_IF_NOT) {
+            int callee = ins.target;
+            if (verify_function_state[callee] == 1) { verify_incomplete = true; continue; } // Recursion
+            if (verify_function_state[callee] == 0) {
+                // The callee shares the owner marks, instructions reached from both are followed again afterwards
+                verifyFunction(callee);
+            }
+            if (main && depth + verify_function_min[callee] < 0) { verifyWarning(i, "stack underflow in the called function"); continue; }
+            if (depth + verify_function_min[callee] < verify_function_min[entry]) verify_function_min[entry] = depth + verify_function_min[callee];
+            if (depth + verify_function_max[callee] > verify_function_max[entry]) verify_function_max[entry] = depth + verify_function_max[callee];
+            if (op != CALL) verifyReach(entry, next, depth);
+            if (verify_function_net[callee] != VERIFY_UNSEEN) verifyReach(entry, next, depth + verify_function_net[callee]);
+            continue;
+        }
+        if (op == RET || op == RET_IF || op == RET_IF_NOT) {
+            if (!main) {
+                if (verify_function_net[entry] == VERIFY_UNSEEN) verify_function_net[entry] = depth;
+                else if (verify_function_net[entry] != depth) verifyWarning(i, "function returns with different stack sizes");
+            }
+            if (op != RET) verifyReach(entry, next, depth);
+            continue;
+        }
+        if (op == EXIT) continue;
+        verifyReach(entry, next, depth);
+    }
+    verify_function_state[entry] = 2;
+}
+
+// Returns true if the bytecode can not be verified
+bool verifyBytecode() {
+    verify_warnings = 0;
+    verify_stack_size = 0;
+    verify_incomplete = false;
+    verify_work_top = 0;
+    if (built_bytecode_length == 0) return false;
+    if (!optDecode()) return true;
+    for (int i = 0; i < opt_count; i++) {
+        verify_owner[i] = -1;
+        verify_function_state[i] = 0;
+    }
+    verifyFunction(0);
+    verify_stack_size = verify_function_max[0];
+    if (verify_stack_size > PLCRUNTIME_MAX_STACK_SIZE) verifyWarning(-1, "the program needs more stack than PLCRUNTIME_MAX_STACK_SIZE");
+    if (verify_warnings > MAX_VERIFY_WARNINGS) {
+        Serial.println();
+        Serial.print(F("Warning: ")); Serial.print(verify_warnings - MAX_VERIFY_WARNINGS); Serial.print(F(" more stack warnings"));
+    }
+    return false;
+}
+
+#endif // __WASM__
@@ -0,0 +1,502 @@
+// plcasm-wcet.h - 1.0.0 - 2022-12-11
+//
+// Copyright (c) 2022 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#ifdef __WASM__
+
+// ################################################################################################
+// Worst case execution time analysis
+// ################################################################################################
+// Computes an upper bound of the execution time of one program cycle for a target platform:
+//  - the bytecode is decoded into basic blocks and a control flow graph
+//  - every block costs the sum of its instruction costs from the target cost table, plus the bound of every called function
+//  - loops are collapsed innermost first into their header: (bound - 1) * longest iteration + longest exiting iteration
+//  - the bound of the program is the longest path through the remaining acyclic graph
+// Every loop needs an iteration bound, given with the 'bound <label> <count>' directive where the label marks the loop header
+// and the count is the maximum number of times the header executes each time the loop is entered.
+// Directives:
+//    target avr | stm32 | esp32     - Select the cost table (default: avr)
+//    deadline <us>                  - Reject the program when its bound exceeds the cycle time
+//    bound <label> <count>          - Iteration bound of the loop starting at <label>
+// The default cost tables are estimates, calibrate them on the device with the runtime benchmark and setWcetCost().
+
+enum WcetCostClass {
+    WCET_STACK = 0,     // Constants, stack manipulation
+    WCET_MEMORY,        // Load and move
+    WCET_BIT,           // Bit get / set / read / write
+    WCET_INTEGER,       // Integer add, sub, compare, bitwise and logic
+    WCET_MULTIPLY,      // Integer multiply
+    WCET_DIVIDE,        // Integer divide and modulo
+    WCET_FLOAT,         // Float add, sub, multiply, compare and conversion
+    WCET_FLOAT_DIVIDE,  // Float divide
+    WCET_MATH,          // Power, square root, sine, cosine
+    WCET_JUMP,          // Jumps, returns and exit
+    WCET_CALL,          // Calls
+    WCET_STRING,        // Byte string instructions, estimated for a 32 byte telegram
+    WCET_CLASS_COUNT
+};
+
+struct WcetTarget {
+    const char* name;
+    u32 clock_mhz;
+    u32 cost[WCET_CLASS_COUNT]; // Cycles per instruction including the dispatch
+    u32 wide_percent;           // Cost of an instruction with 64-bit operands relative to the base cost
+};
+
+WcetTarget wcet_targets[] = {
+    { "avr", 16, { 45, 70, 60, 55, 90, 650, 160, 520, 2400, 40, 60, 540 }, 300 },
+    { "stm32", 72, { 30, 40, 35, 30, 34, 50, 130, 320, 2200, 28, 40, 230 }, 200 },
+    { "esp32", 240, { 25, 30, 28, 25, 28, 60, 45, 90, 450, 22, 30, 150 }, 150 },
+};
+const int wcet_target_count = sizeof(wcet_targets) / sizeof(wcet_targets[0]);
+
+#define MAX_WCET_BOUNDS 64
+#define MAX_WCET_EDGES (MAX_OPT_INSTRUCTIONS * 2)
+#define WCET_NONE 0xFFFFFFFF
+
+int wcet_target = 0;
+u32 wcet_deadline_us = 0;
+int wcet_bound_label[MAX_WCET_BOUNDS];
+u32 wcet_bound_count[MAX_WCET_BOUNDS];
+int wcet_bound_total = 0;
+
+struct WcetEdge {
+    int from;
+    int to;
+    bool alive;
+    bool back;  // Jumps back to a loop header
+};
+
+int wcet_block_start[MAX_OPT_INSTRUCTIONS];
+int wcet_block_end[MAX_OPT_INSTRUCTIONS];
+u32 wcet_block_cost[MAX_OPT_INSTRUCTIONS];
+u32 wcet_block_iterations[MAX_OPT_INSTRUCTIONS]; // Bound of the loop collapsed into the block, 0 if none
+u32 wcet_block_call[MAX_OPT_INSTRUCTIONS];       // Bound of the function called at the end of the block
+bool wcet_block_alive[MAX_OPT_INSTRUCTIONS];
+u8 wcet_function_state[MAX_OPT_INSTRUCTIONS];    // 0 = not analyzed, 1 = in progress, 2 = done
+u32 wcet_function_cost[MAX_OPT_INSTRUCTIONS];
+int wcet_block_count = 0;
+WcetEdge wcet_edges[MAX_WCET_EDGES];
+int wcet_edge_count = 0;
+
+// Per analysis scratch
+int wcet_mark[MAX_OPT_INSTRUCTIONS];
+int wcet_mark_stamp = 0;
+int wcet_forward[MAX_OPT_INSTRUCTIONS];
+int wcet_forward_stamp = 0;
+int wcet_order[MAX_OPT_INSTRUCTIONS];
+int wcet_degree[MAX_OPT_INSTRUCTIONS];
+u32 wcet_dist[MAX_OPT_INSTRUCTIONS];
+u32 wcet_dist_exit[MAX_OPT_INSTRUCTIONS];
+int wcet_pred[MAX_OPT_INSTRUCTIONS];
+
+u32 wcet_cycles = 0;
+int wcet_path_end = -1;
+
+WASM_EXPORT void setWcetCost(u32 cost_class, u32 cycles) {
+    if (cost_class < WCET_CLASS_COUNT) wcet_targets[wcet_target].cost[cost_class] = cycles;
+}
+
+WASM_EXPORT void setWcetClock(u32 mhz) {
+    if (mhz > 0) wcet_targets[wcet_target].clock_mhz = mhz;
+}
+
+u32 wcetAdd(u32 a, u32 b) { return a > WCET_NONE - b ? WCET_NONE : a + b; }
+u32 wcetMul(u32 a, u32 b) { return b > 0 && a > WCET_NONE / b ? WCET_NONE : a * b; }
+
+u32 wcetMicros(u32 cycles) {
+    u32 mhz = wcet_targets[wcet_target].clock_mhz;
+    return cycles / mhz + (cycles % mhz ? 1 : 0);
+}
+
+bool wcetIsWide(u8 type) { return type == type_u64 || type == type_i64 || type == type_f64; }
+bool wcetIsReal(u8 type) { return type == type_f32 || type == type_f64; }
+
+// The cost class comes from the instruction table, typed instructions on real numbers use the float classes
+u32 wcetInstructionCost(OptInstruction& ins) {
+    PLCRuntimeInstructionSet op = (PLCRuntimeInstructionSet) ins.code[0];
+    PLCRuntimeOperandLayout operands = OPCODE_OPERANDS(op);
+    bool typed = operands == OPERANDS_TYPE || operands == OPERANDS_TYPE_TYPE || operands == OPERANDS_TYPE_LOCAL;
+    bool real = typed && (wcetIsReal(ins.code[1]) || (operands == OPERANDS_TYPE_TYPE && wcetIsReal(ins.code[2])));
+    bool wide = false;
+    if (operands == OPERANDS_CONSTANT) wide = wcetIsWide(op);
+    else if (typed) wide = wcetIsWide(ins.code[1]) || (operands == OPERANDS_TYPE_TYPE && wcetIsWide(ins.code[2]));
+    else {
+        u16 pop = 0, push = 0;
+        wide = OPCODE_STACK_EFFECT(ins.code, pop, push) == STATUS_SUCCESS && push >= 8;
+    }
+    WcetCostClass cost_class = WCET_STACK;
+    switch (OPCODE_COST_CLASS(op)) {
+        case COST_STACK: cost_class = WCET_STACK; break;
+        case COST_MEMORY: cost_class = WCET_MEMORY; break;
+        case COST_BIT: cost_class = WCET_BIT; break;
+        case COST_INTEGER: cost_class = real ? WCET_FLOAT : WCET_INTEGER; break;
+        case COST_MULTIPLY: cost_class = real ? WCET_FLOAT : WCET_MULTIPLY; break;
+        case COST_DIVIDE: cost_class = real ? WCET_FLOAT_DIVIDE : WCET_DIVIDE; break;
+        case COST_MATH: cost_class = WCET_MATH; break;
+        case COST_JUMP: cost_class = WCET_JUMP; break;
+        case COST_CALL: cost_class = WCET_CALL; break;
+        case COST_STRING: cost_class = WCET_STRING; break;
+    }
+    WcetTarget& target = wcet_targets[wcet_target];
+    u32 cost = target.cost[cost_class];
+    return wide ? cost * target.wide_percent / 100 : cost;
+}
+
+// Source line of the bytecode offset, 0 if unknown (the optimizer and the block layout rewrite the bytecode)
+int wcetLine(int offset) {
+    int line = 0;
+    for (int i = 0; i < programLineCount; i++) {
+        if (programLines[i].index > offset) break;
+        line = programLines[i].refToken->line;
+    }
+    return line;
+}
+
+int wcetBlockOf(int index) {
+    for (int b = 0; b < wcet_block_count; b++)
+        if (wcet_block_start[b] <= index && index < wcet_block_end[b]) return b;
+    return -1;
+}
+
+u8 wcetLastOp(int block) { return opt_code[wcet_block_end[block] - 1].code[0]; }
+
+bool wcetReturns(int block) {
+    u8 op = wcetLastOp(block);
+    if (op == RET || op == RET_IF || op == RET_IF_NOT || op == EXIT) return true;
+    for (int e = 0; e < wcet_edge_count; e++) if (wcet_edges[e].alive && wcet_edges[e].from == block) return false;
+    return true;
+}
+
+bool wcetAddEdge(int from, int to) {
+    if (wcet_edge_count >= MAX_WCET_EDGES) return false;
+    wcet_edges[wcet_edge_count].from = from;
+    wcet_edges[wcet_edge_count].to = to;
+    wcet_edges[wcet_edge_count].alive = true;
+    wcet_edges[wcet_edge_count].back = false;
+    wcet_edge_count++;
+    return true;
+}
+
+bool wcetError(int block, const char* message) {
+    int offset = opt_code[wcet_block_start[block]].origin;
+    Serial.print(F(" ERROR: ")); Serial.print(F(message)); Serial.print(F(" at offset ")); Serial.print(offset);
+    int line = wcetLine(offset);
+    if (line > 0) { Serial.print(F(", line ")); Serial.print(line); }
+    Serial.println();
+    return true;
+}
+
+// Marks the blocks reachable from 'entry' with a new stamp
+int wcetReach(int entry) {
+    int stamp = ++wcet_mark_stamp;
+    int count = 0;
+    wcet_order[count++] = entry;
+    wcet_mark[entry] = stamp;
+    for (int k = 0; k < count; k++) {
+        for (int e = 0; e < wcet_edge_count; e++) {
+            WcetEdge& edge = wcet_edges[e];
+            if (!edge.alive || edge.from != wcet_order[k] || wcet_mark[edge.to] == stamp) continue;
+            wcet_mark[edge.to] = stamp;
+            wcet_order[count++] = edge.to;
+        }
+    }
+    return stamp;
+}
+
+// Topological order of the marked blocks over the edges not entering 'skip', returns false when a cycle remains
+bool wcetTopological(int stamp, int skip, int& count) {
+    for (int b = 0; b < wcet_block_count; b++) wcet_degree[b] = 0;
+    for (int e = 0; e < wcet_edge_count; e++) {
+        WcetEdge& edge = wcet_edges[e];
+        if (edge.alive && edge.to != skip && wcet_mark[edge.from] == stamp && wcet_mark[edge.to] == stamp) wcet_degree[edge.to]++;
+    }
+    int total = 0;
+    count = 0;
+    for (int b = 0; b < wcet_block_count; b++) {
+        if (wcet_mark[b] != stamp) continue;
+        total++;
+        if (wcet_degree[b] == 0) wcet_order[count++] = b;
+    }
+    for (int k = 0; k < count; k++) {
+        for (int e = 0; e < wcet_edge_count; e++) {
+            WcetEdge& edge = wcet_edges[e];
+            if (!edge.alive || edge.from != wcet_order[k] || edge.to == skip || wcet_mark[edge.to] != stamp) continue;
+            if (--wcet_degree[edge.to] == 0) wcet_order[count++] = edge.to;
+        }
+    }
+    return count == total;
+}
+
+// Finds the innermost loop header and marks the back edges (depth first search), returns -1 when the graph is acyclic
+int wcetFindLoop(int entry, int reach_stamp) {
+    static int stack_block[MAX_OPT_INSTRUCTIONS];
+    static int stack_edge[MAX_OPT_INSTRUCTIONS];
+    for (int b = 0; b < wcet_block_count; b++) wcet_degree[b] = 0; // 0 = new, 1 = on stack, 2 = done
+    for (int e = 0; e < wcet_edge_count; e++) wcet_edges[e].back = false;
+    int best = -1;
+    int best_size = 0;
+    int depth = 0;
+    stack_block[depth] = entry;
+    stack_edge[depth] = 0;
+    wcet_degree[entry] = 1;
+    while (depth >= 0) {
+        int block = stack_block[depth];
+        int e = stack_edge[depth];
+        while (e < wcet_edge_count && !(wcet_edges[e].alive && wcet_edges[e].from == block)) e++;
+        if (e >= wcet_edge_count) {
+            wcet_degree[block] = 2;
+            depth--;
+            continue;
+        }
+        stack_edge[depth] = e + 1;
+        int to = wcet_edges[e].to;
+        if (wcet_mark[to] != reach_stamp) continue;
+        if (wcet_degree[to] == 1) {
+            // Back edge: the loop size is the distance on the depth first stack, prefer the innermost loop
+            wcet_edges[e].back = true;
+            int size = 0;
+            for (int d = depth; d >= 0 && stack_block[d] != to; d--) size++;
+            if (best < 0 || size < best_size) { best = to; best_size = size; }
+        } else if (wcet_degree[to] == 0) {
+            wcet_degree[to] = 1;
+            depth++;
+            stack_block[depth] = to;
+            stack_edge[depth] = 0;
+        }
+    }
+    return best;
+}
+
+u32 wcetLoopBound(int header) {
+    int offset = opt_code[wcet_block_start[header]].origin;
+    for (int i = 0; i < wcet_bound_total; i++)
+        if (LUT_labels[wcet_bound_label[i]].address == offset) return wcet_bound_count[i];
+    return 0;
+}
+
+// Collapses the loop at 'header' into the header block, returns true on error
+bool wcetCollapseLoop(int header, int reach_stamp) {
+    // Blocks reachable from the header, the latches are the ones jumping back to it
+    int forward = ++wcet_forward_stamp;
+    int count = 0;
+    wcet_forward[header] = forward;
+    wcet_order[count++] = header;
+    for (int k = 0; k < count; k++) {
+        for (int e = 0; e < wcet_edge_count; e++) {
+            WcetEdge& edge = wcet_edges[e];
+            if (!edge.alive || edge.from != wcet_order[k] || wcet_mark[edge.to] != reach_stamp || wcet_forward[edge.to] == forward) continue;
+            wcet_forward[edge.to] = forward;
+            wcet_order[count++] = edge.to;
+        }
+    }
+    // Natural loop: the header and every block reaching a latch without passing the header
+    int stamp = ++wcet_mark_stamp;
+    count = 0;
+    wcet_mark[header] = stamp;
+    for (int e = 0; e < wcet_edge_count; e++) {
+        WcetEdge& edge = wcet_edges[e];
+        if (!edge.alive || !edge.back || edge.to != header || wcet_mark[edge.from] == stamp) continue;
+        wcet_mark[edge.from] = stamp;
+        wcet_order[count++] = edge.from;
+    }
+    for (int k = 0; k < count; k++) {
+        for (int e = 0; e < wcet_edge_count; e++) {
+            WcetEdge& edge = wcet_edges[e];
+            if (!edge.alive || edge.to != wcet_order[k] || wcet_forward[edge.from] != forward || wcet_mark[edge.from] != reach_stamp) continue;
+            wcet_mark[edge.from] = stamp;
+            wcet_order[count++] = edge.from;
+        }
+    }
+    // A loop entered other than through its header has no single iteration count
+    for (int e = 0; e < wcet_edge_count; e++) {
+        WcetEdge& edge = wcet_edges[e];
+        if (edge.alive && wcet_mark[edge.to] == stamp && edge.to != header && wcet_mark[edge.from] == reach_stamp) return wcetError(edge.to, "loop with multiple entries");
+    }
+    u32 bound = wcetLoopBound(header);
+    if (bound == 0) return wcetError(header, "loop without an iteration bound, use 'bound <label> <count>'");
+
+    // Longest paths from every block to a latch (next iteration) and out of the loop (last iteration)
+    int order_count;
+    if (!wcetTopological(stamp, header, order_count)) return wcetError(header, "irreducible loop");
+    for (int k = order_count - 1; k >= 0; k--) {
+        int block = wcet_order[k];
+        u32 iteration = WCET_NONE;
+        u32 exit = wcetReturns(block) ? 0 : WCET_NONE;
+        for (int e = 0; e < wcet_edge_count; e++) {
+            WcetEdge& edge = wcet_edges[e];
+            if (!edge.alive || edge.from != block) continue;
+            if (edge.to == header) { if (iteration == WCET_NONE) iteration = 0; }
+            else if (wcet_mark[edge.to] != stamp) { if (exit == WCET_NONE) exit = 0; }
+            else {
+                if (wcet_dist[edge.to] != WCET_NONE && (iteration == WCET_NONE || wcet_dist[edge.to] > iteration)) iteration = wcet_dist[edge.to];
+                if (wcet_dist_exit[edge.to] != WCET_NONE && (exit == WCET_NONE || wcet_dist_exit[edge.to] > exit)) exit = wcet_dist_exit[edge.to];
+            }
+        }
+        wcet_dist[block] = iteration == WCET_NONE ? WCET_NONE : wcetAdd(iteration, wcet_block_cost[block]);
+        wcet_dist_exit[block] = exit == WCET_NONE ? WCET_NONE : wcetAdd(exit, wcet_block_cost[block]);
+    }
+    if (wcet_dist_exit[header] == WCET_NONE) return wcetError(header, "loop without an exit");
+    u32 iteration = wcet_dist[header] == WCET_NONE ? 0 : wcet_dist[header];
+    wcet_block_cost[header] = wcetAdd(wcetMul(iteration, bound - 1), wcet_dist_exit[header]);
+    wcet_block_iterations[header] = bound;
+
+    // Exits of the loop leave from the header, the rest of the loop is gone
+    for (int e = 0; e < wcet_edge_count; e++) {
+        WcetEdge& edge = wcet_edges[e];
+        if (!edge.alive || wcet_mark[edge.from] != stamp) continue;
+        if (wcet_mark[edge.to] == stamp) edge.alive = false;
+        else edge.from = header;
+    }
+    for (int b = 0; b < wcet_block_count; b++) if (wcet_mark[b] == stamp && b != header) wcet_block_alive[b] = false;
+    return false;
+}
+
+// Bound of the function (or program) starting at block 'entry', returns true on error
+bool wcetFunction(int entry) {
+    if (wcet_function_state[entry] == 2) return false;
+    if (wcet_function_state[entry] == 1) return wcetError(entry, "recursive call");
+    wcet_function_state[entry] = 1;
+
+    // Called functions first
+    int stamp = wcetReach(entry);
+    for (int b = 0; b < wcet_block_count; b++) {
+        if (wcet_mark[b] != stamp || !wcet_block_alive[b]) continue;
+        u8 op = wcetLastOp(b);
+        if (op != CALL && op != CALL_IF && op != CALL_IF_NOT) continue;
+        if (wcet_block_call[b] != WCET_NONE) continue;
+        int callee = wcetBlockOf(optIndexOf(opt_code[wcet_block_end[b] - 1].target));
+        if (callee < 0) return wcetError(b, "call target not found");
+        if (wcetFunction(callee)) return true;
+        wcet_block_call[b] = wcet_function_cost[callee];
+        wcet_block_cost[b] = wcetAdd(wcet_block_cost[b], wcet_block_call[b]);
+        stamp = wcetReach(entry); // Marks were reused by the callee
+    }
+
+    // Collapse the loops innermost first
+    while (true) {
+        int header = wcetFindLoop(entry, stamp);
+        if (header < 0) break;
+        if (wcetCollapseLoop(header, stamp)) return true;
+        stamp = wcetReach(entry);
+    }
+
+    // Longest path through the acyclic graph
+    int order_count;
+    if (!wcetTopological(stamp, -1, order_count)) return wcetError(entry, "irreducible control flow");
+    for (int k = 0; k < order_count; k++) { wcet_dist[wcet_order[k]] = 0; wcet_pred[wcet_order[k]] = -1; }
+    wcet_dist[entry] = wcet_block_cost[entry];
+    u32 cost = 0;
+    int end = entry;
+    for (int k = 0; k < order_count; k++) {
+        int block = wcet_order[k];
+        for (int e = 0; e < wcet_edge_count; e++) {
+            WcetEdge& edge = wcet_edges[e];
+            if (!edge.alive || edge.from != block) continue;
+            u32 dist = wcetAdd(wcet_dist[block], wcet_block_cost[edge.to]);
+            if (dist > wcet_dist[edge.to]) { wcet_dist[edge.to] = dist; wcet_pred[edge.to] = block; }
+        }
+        if (wcetReturns(block) && wcet_dist[block] >= cost) { cost = wcet_dist[block]; end = block; }
+    }
+    wcet_function_cost[entry] = cost;
+    wcet_function_state[entry] = 2;
+    wcet_path_end = end;
+    return false;
+}
+
+// Analyzes the built bytecode, the bound is stored in 'wcet_cycles'. Returns true on error
+bool wcetAnalyze() {
+    wcet_cycles = 0;
+    wcet_path_end = -1;
+    if (!optDecode()) {
+        Serial.println(F(" ERROR: bytecode can not be decoded for timing analysis"));
+        return true;
+    }
+    optFindLeaders();
+    wcet_block_count = 0;
+    for (int i = 0; i < opt_count; i++) {
+        if (!opt_leader[i]) continue;
+        if (wcet_block_count > 0) wcet_block_end[wcet_block_count - 1] = i;
+        int b = wcet_block_count++;
+        wcet_block_start[b] = i;
+        wcet_block_cost[b] = 0;
+        wcet_block_iterations[b] = 0;
+        wcet_block_call[b] = WCET_NONE;
+        wcet_block_alive[b] = true;
+        wcet_function_state[b] = 0;
+        wcet_mark[b] = 0;
+        wcet_forward[b] = 0;
+    }
+    if (wcet_block_count == 0) return false;
+    wcet_block_end[wcet_block_count - 1] = opt_count;
+    wcet_mark_stamp = 0;
+    wcet_forward_stamp = 0;
+    wcet_edge_count = 0;
+    for (int b = 0; b < wcet_block_count; b++) {
+        for (int i = wcet_block_start[b]; i < wcet_block_end[b]; i++) wcet_block_cost[b] = wcetAdd(wcet_block_cost[b], wcetInstructionCost(opt_code[i]));
+        OptInstruction& last = opt_code[wcet_block_end[b] - 1];
+        u8 op = last.code[0];
+        bool ok = true;
+        if (op == JMP || op == JMP_IF || op == JMP_IF_NOT) {
+            int target = wcetBlockOf(optIndexOf(last.target));
+            if (target < 0) return wcetError(b, "jump target not found");
+            ok = wcetAddEdge(b, target);
+        }
+        bool falls_through = op != JMP && op != RET && op != EXIT;
+        if (ok && falls_through && b + 1 < wcet_block_count) ok = wcetAddEdge(b, b + 1);
+        if (!ok) return wcetError(b, "program is too large for timing analysis");
+    }
+    if (wcetFunction(0)) return true;
+    wcet_cycles = wcet_function_cost[0];
+    return false;
+}
+
+void wcetReport() {
+    WcetTarget& target = wcet_targets[wcet_target];
+    Serial.print(F("Worst case execution time on ")); Serial.print(target.name); Serial.print(F(" @ ")); Serial.print(target.clock_mhz); Serial.print(F(" MHz: "));
+    Serial.print(wcet_cycles); Serial.print(F(" cycles, ")); Serial.print(wcetMicros(wcet_cycles)); Serial.println(F(" us"));
+    if (wcet_path_end < 0) return;
+    // The critical path is stored backwards in the predecessor links
+    int count = 0;
+    for (int b = wcet_path_end; b >= 0; b = wcet_pred[b]) wcet_order[count++] = b;
+    Serial.println(F("Critical path:"));
+    for (int k = count - 1; k >= 0; k--) {
+        int block = wcet_order[k];
+        int offset = opt_code[wcet_block_start[block]].origin;
+        int line = wcetLine(offset);
+        Serial.print(F("    offset ")); fill(' ', 6 - Serial.print(offset));
+        Serial.print(F(" line ")); fill(' ', 6 - (line > 0 ? Serial.print(line) : Serial.print('-')));
+        Serial.print(wcet_block_cost[block]); Serial.print(F(" cycles"));
+        if (wcet_block_iterations[block] > 0) { Serial.print(F("  loop x")); Serial.print(wcet_block_iterations[block]); }
+        if (wcet_block_call[block] != WCET_NONE) { Serial.print(F("  call ")); Serial.print(wcet_block_call[block]); Serial.print(F(" cycles")); }
+        Serial.println();
+    }
+}
+
+// Prints the timing analysis of the last compiled program and returns its bound in microseconds (0 on error)
+WASM_EXPORT u32 analyzeTiming() {
+    if (wcetAnalyze()) return 0;
+    wcetReport();
+    return wcetMicros(wcet_cycles);
+}
+
+#endif // __WASM__
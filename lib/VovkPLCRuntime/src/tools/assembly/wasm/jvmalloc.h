@@ -90,6 +90,20 @@ extern "C" {
         return dest;
     }
 
+    // memmove implementation
+    void* memmove(void* dest, const void* src, int num) {
+        char* char_dest = (char*) dest;
+        char* char_src = (char*) src;
+        if (char_dest < char_src) {
+            for (int i = 0; i < num; i++)
+                char_dest[i] = char_src[i];
+        } else {
+            for (int i = num; i > 0; i--)
+                char_dest[i - 1] = char_src[i - 1];
+        }
+        return dest;
+    }
+
     // memcmp implementation
     int memcmp(const void* ptr1, const void* ptr2, int num) {
         char* char_ptr1 = (char*) ptr1;
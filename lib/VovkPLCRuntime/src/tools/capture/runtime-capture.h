@@ -0,0 +1,277 @@
+// runtime-capture.h - 1.0.0 - 2022-12-11
+//
+// Copyright (c) 2022 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+// Triggered capture
+// The selected tags are copied into a circular buffer at the end of every scan while the capture is armed.
+// The trigger condition is evaluated on the same scan. Once it fires, the capture keeps recording the
+// requested number of post-trigger scans and then freezes, holding the pre-trigger window, the trigger scan
+// and the post-trigger window until it is armed again.
+//
+// Trigger modes:
+//  - rising / falling / change: edge of the bit 'address.bit'
+//  - above / below: the value of the given data type at 'address' crosses the threshold
+//  - manual: only trigger() fires the capture
+//
+// Upload format (all numbers are big-endian, tag values are the memory bytes as stored, like a memory read):
+//   <u8 tag_count> { <u32 address> <u8 type> } <u8 state> <u16 pre_trigger> <u16 post_trigger>
+//   <u32 trigger_time> <u32 sample_count> <u32 trigger_index> { <u8[] tag values> } oldest sample first
+
+#ifndef PLCRUNTIME_CAPTURE_MAX_TAGS
+#define PLCRUNTIME_CAPTURE_MAX_TAGS 4
+#endif // PLCRUNTIME_CAPTURE_MAX_TAGS
+
+#ifndef PLCRUNTIME_CAPTURE_BUFFER_SIZE
+#define PLCRUNTIME_CAPTURE_BUFFER_SIZE 128
+#endif // PLCRUNTIME_CAPTURE_BUFFER_SIZE
+
+enum CaptureTriggerMode {
+    CAPTURE_TRIGGER_MANUAL = 0,
+    CAPTURE_TRIGGER_RISING,
+    CAPTURE_TRIGGER_FALLING,
+    CAPTURE_TRIGGER_CHANGE,
+    CAPTURE_TRIGGER_ABOVE,
+    CAPTURE_TRIGGER_BELOW,
+};
+
+enum CaptureState {
+    CAPTURE_IDLE = 0,  // Not armed, nothing is recorded
+    CAPTURE_ARMED,     // Recording the pre-trigger window, waiting for the trigger
+    CAPTURE_TRIGGERED, // Recording the post-trigger window
+    CAPTURE_COMPLETE,  // Frozen, the buffer is ready for upload
+};
+
+struct CaptureTag {
+    u32 address;
+    u8 type;
+    u8 size;
+    u16 offset; // Offset of the value in a sample
+};
+
+class RuntimeCapture {
+public:
+    CaptureTag tags[PLCRUNTIME_CAPTURE_MAX_TAGS];
+    u8 tag_count = 0;
+    u16 sample_size = 0;    // Bytes per sample, sum of the tag sizes
+    u8 state = CAPTURE_IDLE;
+    u16 pre_trigger = 0;    // Requested scans before the trigger scan
+    u16 post_trigger = 0;   // Requested scans after the trigger scan
+    u32 sample_count = 0;   // Held samples
+    u32 trigger_index = 0;  // Index of the trigger scan in the held samples
+    u32 trigger_time = 0;   // Timestamp of the trigger scan in milliseconds
+
+    RuntimeCapture() {}
+
+    // Add a tag to the captured list, disarms the capture, returns true on error
+    bool addTag(u32 address, u8 type) {
+        u8 size = DATA_TYPE_SIZE(type);
+        if (tag_count >= PLCRUNTIME_CAPTURE_MAX_TAGS) return true;
+        if (size == 0 || sample_size + size > PLCRUNTIME_CAPTURE_BUFFER_SIZE) return true;
+        if (address + size > PLCRUNTIME_MAX_MEMORY_SIZE) return true;
+        tags[tag_count].address = address;
+        tags[tag_count].type = type;
+        tags[tag_count].size = size;
+        tags[tag_count].offset = sample_size;
+        sample_size += size;
+        tag_count++;
+        disarm();
+        return false;
+    }
+
+    void clearTags() {
+        tag_count = 0;
+        sample_size = 0;
+        disarm();
+    }
+
+    // Configure the trigger, 'parameter' is the bit index for edge modes and the data type for threshold modes,
+    // the threshold is given as memory bytes of that data type. Disarms the capture, returns true on error
+    bool setTrigger(u8 mode, u32 address, u8 parameter, const u8* threshold = nullptr) {
+        disarm();
+        if (mode > CAPTURE_TRIGGER_BELOW) return true;
+        u8 size = 1;
+        if (mode == CAPTURE_TRIGGER_ABOVE || mode == CAPTURE_TRIGGER_BELOW) {
+            size = DATA_TYPE_SIZE(parameter);
+            if (size == 0 || size > sizeof(trigger_threshold) || threshold == nullptr) return true;
+            memcpy(trigger_threshold, threshold, size);
+        } else if (mode != CAPTURE_TRIGGER_MANUAL && parameter > 7) return true;
+        if (mode != CAPTURE_TRIGGER_MANUAL && address + size > PLCRUNTIME_MAX_MEMORY_SIZE) return true;
+        trigger_mode = mode;
+        trigger_address = address;
+        trigger_parameter = parameter;
+        return false;
+    }
+
+    // Start recording, the pre-trigger, trigger and post-trigger samples must fit into the buffer. Returns true on error
+    bool arm(u16 pre, u16 post) {
+        disarm();
+        if (tag_count == 0) return true;
+        u32 window = (u32) pre + 1 + post;
+        if (window * sample_size > PLCRUNTIME_CAPTURE_BUFFER_SIZE) return true;
+        pre_trigger = pre;
+        post_trigger = post;
+        window_size = window;
+        state = CAPTURE_ARMED;
+        return false;
+    }
+
+    // Stop recording and drop the held samples
+    void disarm() {
+        state = CAPTURE_IDLE;
+        head = 0;
+        sample_count = 0;
+        trigger_index = 0;
+        remaining = 0;
+        primed = false;
+        force = false;
+    }
+
+    // Fire the trigger on the next sampled scan
+    void trigger() {
+        if (state == CAPTURE_ARMED) force = true;
+    }
+
+    // Record the tags and evaluate the trigger, called at the end of every scan
+    void sample(plc_memory_t memory) {
+        if (state != CAPTURE_ARMED && state != CAPTURE_TRIGGERED) return;
+        u8* slot = buffer + head * sample_size;
+        for (u8 i = 0; i < tag_count; i++) readArea_u8(memory, tags[i].address, slot + tags[i].offset, tags[i].size);
+        head = head + 1 < window_size ? head + 1 : 0;
+        if (state == CAPTURE_TRIGGERED) {
+            sample_count++;
+            if (--remaining == 0) state = CAPTURE_COMPLETE;
+            return;
+        }
+        bool level = evaluate(memory);
+        bool fired = force || (primed && fires(level));
+        primed = true;
+        last_level = level;
+        if (!fired) {
+            // Only the last 'pre_trigger' scans are kept before the trigger
+            if (sample_count < pre_trigger) sample_count++;
+            return;
+        }
+        trigger_index = sample_count;
+        trigger_time = millis();
+        sample_count++;
+        remaining = post_trigger;
+        state = remaining > 0 ? CAPTURE_TRIGGERED : CAPTURE_COMPLETE;
+    }
+
+    // Sample data of the held sample 'index', 0 is the oldest one. Returns nullptr if out of range
+    const u8* at(u32 index) const {
+        if (index >= sample_count) return nullptr;
+        u32 slot = (head + window_size - sample_count + index) % window_size;
+        return buffer + slot * sample_size;
+    }
+
+    // Print the capture in the upload format as hex
+    void upload() {
+        printHex(tag_count, 1);
+        for (u8 i = 0; i < tag_count; i++) {
+            printHex(tags[i].address, 4);
+            printHex(tags[i].type, 1);
+        }
+        printHex(state, 1);
+        printHex(pre_trigger, 2);
+        printHex(post_trigger, 2);
+        printHex(trigger_time, 4);
+        printHex(sample_count, 4);
+        printHex(trigger_index, 4);
+        char c1, c2;
+        for (u32 i = 0; i < sample_count; i++) {
+            const u8* data = at(i);
+            for (u16 j = 0; j < sample_size; j++) {
+                byteToHex(data[j], c1, c2);
+                Serial.print(c1);
+                Serial.print(c2);
+            }
+        }
+        Serial.println();
+    }
+
+private:
+    u8 buffer[PLCRUNTIME_CAPTURE_BUFFER_SIZE];
+    u32 window_size = 1; // Samples in the circular window, pre + 1 + post
+    u32 head = 0;        // Slot of the next sample
+    u32 remaining = 0;   // Post-trigger samples left to record
+    u8 trigger_mode = CAPTURE_TRIGGER_MANUAL;
+    u32 trigger_address = 0;
+    u8 trigger_parameter = 0;
+    u8 trigger_threshold[8];
+    bool primed = false;     // The previous trigger level is valid
+    bool last_level = false;
+    bool force = false;
+
+    // Trigger level of this scan, the bit state or the threshold condition
+    bool evaluate(plc_memory_t memory) {
+        u8 location[8] = { 0 };
+        readArea_u8(memory, trigger_address, location, trigger_mode >= CAPTURE_TRIGGER_ABOVE ? DATA_TYPE_SIZE(trigger_parameter) : 1);
+        switch (trigger_mode) {
+            case CAPTURE_TRIGGER_RISING:
+            case CAPTURE_TRIGGER_FALLING:
+            case CAPTURE_TRIGGER_CHANGE: return (location[0] >> trigger_parameter) & 1;
+            case CAPTURE_TRIGGER_ABOVE: return compare(location) > 0;
+            case CAPTURE_TRIGGER_BELOW: return compare(location) < 0;
+            default: return false;
+        }
+    }
+
+    // The edge modes fire on a level change, the threshold modes when the condition becomes true
+    bool fires(bool level) const {
+        switch (trigger_mode) {
+            case CAPTURE_TRIGGER_FALLING: return last_level && !level;
+            case CAPTURE_TRIGGER_CHANGE: return last_level != level;
+            case CAPTURE_TRIGGER_RISING:
+            case CAPTURE_TRIGGER_ABOVE:
+            case CAPTURE_TRIGGER_BELOW: return !last_level && level;
+            default: return false;
+        }
+    }
+
+    template <typename T> static i8 compareAs(const u8* a, const u8* b) {
+        T x, y;
+        memcpy(&x, a, sizeof(T));
+        memcpy(&y, b, sizeof(T));
+        return x > y ? 1 : x < y ? -1 : 0;
+    }
+
+    // Compare the value at 'location' with the threshold
+    i8 compare(const u8* location) const {
+        switch (trigger_parameter) {
+            case type_bool:
+            case type_u8: return compareAs<u8>(location, trigger_threshold);
+            case type_u16: return compareAs<u16>(location, trigger_threshold);
+            case type_u32: return compareAs<u32>(location, trigger_threshold);
+            case type_i8: return compareAs<i8>(location, trigger_threshold);
+            case type_i16: return compareAs<i16>(location, trigger_threshold);
+            case type_i32: return compareAs<i32>(location, trigger_threshold);
+            case type_f32: return compareAs<f32>(location, trigger_threshold);
+#ifdef USE_X64_OPS
+            case type_u64: return compareAs<u64>(location, trigger_threshold);
+            case type_i64: return compareAs<i64>(location, trigger_threshold);
+            case type_f64: return compareAs<f64>(location, trigger_threshold);
+#endif // USE_X64_OPS
+            default: return 0;
+        }
+    }
+};
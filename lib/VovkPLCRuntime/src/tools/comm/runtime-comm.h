@@ -0,0 +1,185 @@
+// runtime-comm.h - 1.0.0 - 2022-12-11
+//
+// Copyright (c) 2022 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+// Communication ring buffers
+// Every auxiliary port has a receive and a transmit ring that live in the PLC memory, so the program reads and
+// writes the telegram bytes in place with LOAD, MOVE and the STR_ instructions. A ring of 'size' data bytes at
+// 'address' is laid out as:
+//
+//    u16 head          - next write position, only moved by the producer
+//    u16 tail          - next read position, only moved by the consumer
+//    u8 data[size]     - the ring holds up to size - 1 bytes, head == tail when it is empty
+//
+// The indices are stored in the memory byte order (like a u16 MOVE). The I/O layer is the producer of the receive
+// ring and the consumer of the transmit ring: it fills the receive rings from the attached streams before a scan and
+// drains the transmit rings after it. The host can feed and empty the rings itself with receive() and transmit().
+
+#ifndef PLCRUNTIME_COMM_MAX_PORTS
+#define PLCRUNTIME_COMM_MAX_PORTS 2
+#endif // PLCRUNTIME_COMM_MAX_PORTS
+
+#define PLCRUNTIME_COMM_HEADER 4 // u16 head + u16 tail
+
+struct CommRing {
+    u32 address = 0; // Address of the ring header in the memory
+    u16 size = 0;    // Data bytes, 0 if the ring is not used
+
+    // Read the indices from the memory, returns true if the ring is not used or the program broke them
+    bool load(plc_memory_t memory, u16& head, u16& tail) const {
+        if (size == 0) return true;
+        if (readArea_u8(memory, address, (u8*) &head, 2) || readArea_u8(memory, address + 2, (u8*) &tail, 2)) return true;
+        return head >= size || tail >= size;
+    }
+
+    u16 used(u16 head, u16 tail) const { return head >= tail ? head - tail : size - tail + head; }
+};
+
+struct CommPort {
+    CommRing rx; // Filled by the I/O layer, read by the program
+    CommRing tx; // Written by the program, drained by the I/O layer
+#ifndef __SIMULATOR__
+    Stream* stream = nullptr;
+#endif // __SIMULATOR__
+};
+
+class RuntimeComm {
+public:
+    CommPort ports[PLCRUNTIME_COMM_MAX_PORTS];
+
+    // Place the rings of the port in the memory and empty them, a size of 0 disables the direction. Returns true on error
+    bool configure(plc_memory_t memory, u8 port, u32 rx_address, u16 rx_size, u32 tx_address, u16 tx_size) {
+        if (port >= PLCRUNTIME_COMM_MAX_PORTS) return true;
+        if (rx_size == 1 || tx_size == 1) return true;
+        if (rx_size && rx_address + PLCRUNTIME_COMM_HEADER + rx_size > PLCRUNTIME_MAX_MEMORY_SIZE) return true;
+        if (tx_size && tx_address + PLCRUNTIME_COMM_HEADER + tx_size > PLCRUNTIME_MAX_MEMORY_SIZE) return true;
+        CommPort& p = ports[port];
+        p.rx.address = rx_address;
+        p.rx.size = rx_size;
+        p.tx.address = tx_address;
+        p.tx.size = tx_size;
+        u8 empty[PLCRUNTIME_COMM_HEADER] = { 0 };
+        if (rx_size) writeArea_u8(memory, rx_address, empty, PLCRUNTIME_COMM_HEADER);
+        if (tx_size) writeArea_u8(memory, tx_address, empty, PLCRUNTIME_COMM_HEADER);
+        return false;
+    }
+
+    void clear() {
+        for (u8 i = 0; i < PLCRUNTIME_COMM_MAX_PORTS; i++) ports[i] = CommPort();
+    }
+
+    // Free bytes in the receive ring of the port
+    u16 space(plc_memory_t memory, u8 port) const {
+        if (port >= PLCRUNTIME_COMM_MAX_PORTS) return 0;
+        const CommRing& ring = ports[port].rx;
+        u16 head, tail;
+        if (ring.load(memory, head, tail)) return 0;
+        return ring.size - 1 - ring.used(head, tail);
+    }
+
+    // Bytes waiting in the transmit ring of the port
+    u16 pending(plc_memory_t memory, u8 port) const {
+        if (port >= PLCRUNTIME_COMM_MAX_PORTS) return 0;
+        const CommRing& ring = ports[port].tx;
+        u16 head, tail;
+        if (ring.load(memory, head, tail)) return 0;
+        return ring.used(head, tail);
+    }
+
+    // Append received bytes to the receive ring, returns the number of bytes that fit
+    u16 receive(plc_memory_t memory, u8 port, const u8* data, u16 size) {
+        if (port >= PLCRUNTIME_COMM_MAX_PORTS) return 0;
+        const CommRing& ring = ports[port].rx;
+        u16 head, tail;
+        if (ring.load(memory, head, tail)) return 0;
+        u16 free = ring.size - 1 - ring.used(head, tail);
+        u16 count = size < free ? size : free;
+        // At most two spans, up to the end of the ring and from its start
+        u16 first = ring.size - head < count ? ring.size - head : count;
+        writeArea_u8(memory, ring.address + PLCRUNTIME_COMM_HEADER + head, (u8*) data, first);
+        writeArea_u8(memory, ring.address + PLCRUNTIME_COMM_HEADER, (u8*) data + first, count - first);
+        head = (head + count) % ring.size;
+        writeArea_u8(memory, ring.address, (u8*) &head, 2);
+        return count;
+    }
+
+    // Take bytes to send from the transmit ring, returns the number of bytes taken
+    u16 transmit(plc_memory_t memory, u8 port, u8* data, u16 size) {
+        if (port >= PLCRUNTIME_COMM_MAX_PORTS) return 0;
+        const CommRing& ring = ports[port].tx;
+        u16 head, tail;
+        if (ring.load(memory, head, tail)) return 0;
+        u16 available = ring.used(head, tail);
+        u16 count = size < available ? size : available;
+        u16 first = ring.size - tail < count ? ring.size - tail : count;
+        readArea_u8(memory, ring.address + PLCRUNTIME_COMM_HEADER + tail, data, first);
+        readArea_u8(memory, ring.address + PLCRUNTIME_COMM_HEADER, data + first, count - first);
+        tail = (tail + count) % ring.size;
+        writeArea_u8(memory, ring.address + 2, (u8*) &tail, 2);
+        return count;
+    }
+
+#ifndef __SIMULATOR__
+    // Bind the port to a serial device, nullptr detaches it
+    bool attach(u8 port, Stream* stream) {
+        if (port >= PLCRUNTIME_COMM_MAX_PORTS) return true;
+        ports[port].stream = stream;
+        return false;
+    }
+
+    // Move the bytes waiting in the attached streams into the receive rings, called at the start of every scan
+    void fill(plc_memory_t memory) {
+        u8 chunk[16];
+        for (u8 port = 0; port < PLCRUNTIME_COMM_MAX_PORTS; port++) {
+            Stream* stream = ports[port].stream;
+            if (stream == nullptr) continue;
+            // Only what fits is read, the rest waits in the device buffer for the next scan
+            u16 room = space(memory, port);
+            while (room > 0 && stream->available() > 0) {
+                u16 count = 0;
+                while (count < sizeof(chunk) && count < room && stream->available() > 0) chunk[count++] = stream->read();
+                receive(memory, port, chunk, count);
+                room -= count;
+            }
+        }
+    }
+
+    // Send the transmit rings to the attached streams without blocking, called at the end of every scan
+    void drain(plc_memory_t memory) {
+        u8 chunk[16];
+        for (u8 port = 0; port < PLCRUNTIME_COMM_MAX_PORTS; port++) {
+            Stream* stream = ports[port].stream;
+            if (stream == nullptr) continue;
+            int room = stream->availableForWrite();
+            while (room > 0) {
+                u16 count = transmit(memory, port, chunk, room < (int) sizeof(chunk) ? room : sizeof(chunk));
+                if (count == 0) break;
+                stream->write(chunk, count);
+                room -= count;
+            }
+        }
+    }
+#else
+    void fill(plc_memory_t memory) {}
+    void drain(plc_memory_t memory) {}
+#endif // __SIMULATOR__
+};
@@ -0,0 +1,118 @@
+// runtime-math-cache.h - 1.0.0 - 2022-12-11
+//
+// Copyright (c) 2022 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+// Math result cache
+// Every call site (program offset) of a math instruction that only works on the stack (POW, SQRT, SIN, COS) keeps
+// its last input bytes and result. When the same site runs with bit identical input again, the cached result is
+// pushed instead of computing it, which saves most of the time of the transcendental functions on setpoints that
+// rarely change. The sites share a small direct mapped table indexed by the program offset. The cache is enabled
+// per program and starts disabled and empty when a program is loaded.
+
+#ifndef PLCRUNTIME_MATH_CACHE_SIZE
+#define PLCRUNTIME_MATH_CACHE_SIZE 8 // Power of two
+#endif // PLCRUNTIME_MATH_CACHE_SIZE
+
+#ifdef USE_X64_OPS
+#define PLCRUNTIME_MATH_CACHE_VALUE_SIZE 8
+#else
+#define PLCRUNTIME_MATH_CACHE_VALUE_SIZE 4
+#endif // USE_X64_OPS
+
+#define PLCRUNTIME_MATH_CACHE_EMPTY 0xFFFFFFFF
+
+struct MathCacheEntry {
+    u32 site;                                       // Program offset of the instruction
+    u8 input[2 * PLCRUNTIME_MATH_CACHE_VALUE_SIZE]; // Operand bytes as they were on the stack
+    u8 result[PLCRUNTIME_MATH_CACHE_VALUE_SIZE];    // Result bytes as they were pushed
+#ifdef PLCRUNTIME_PROFILER
+    u32 hits;
+    u32 misses;
+#endif // PLCRUNTIME_PROFILER
+};
+
+class RuntimeMathCache {
+public:
+    MathCacheEntry entries[PLCRUNTIME_MATH_CACHE_SIZE];
+    bool enabled = false;
+    u32 hits = 0;
+    u32 misses = 0;
+
+    RuntimeMathCache() { clear(); }
+
+    void clear() {
+        for (u32 i = 0; i < PLCRUNTIME_MATH_CACHE_SIZE; i++) {
+            entries[i].site = PLCRUNTIME_MATH_CACHE_EMPTY;
+#ifdef PLCRUNTIME_PROFILER
+            entries[i].hits = 0;
+            entries[i].misses = 0;
+#endif // PLCRUNTIME_PROFILER
+        }
+        hits = 0;
+        misses = 0;
+        pending = nullptr;
+    }
+
+    // Replace the operands on top of the stack with the cached result if the site has seen them last time.
+    // Returns true on a hit. On a miss the operands are kept until store() records the result.
+    bool lookup(Stack<u8>& stack, u32 site, u16 input_size, u16 result_size) {
+        pending = nullptr;
+        if (result_size == 0 || result_size > PLCRUNTIME_MATH_CACHE_VALUE_SIZE || input_size > 2 * PLCRUNTIME_MATH_CACHE_VALUE_SIZE || stack.size() < input_size) return false;
+        const u8* input = stack._data + stack.size() - input_size;
+        MathCacheEntry& entry = entries[site & (PLCRUNTIME_MATH_CACHE_SIZE - 1)];
+        if (entry.site == site && memcmp(entry.input, input, input_size) == 0) {
+            stack.pop(input_size);
+            for (u16 i = 0; i < result_size; i++) stack.push(entry.result[i]);
+            hits++;
+#ifdef PLCRUNTIME_PROFILER
+            entry.hits++;
+#endif // PLCRUNTIME_PROFILER
+            return true;
+        }
+#ifdef PLCRUNTIME_PROFILER
+        if (entry.site != site) {
+            entry.hits = 0;
+            entry.misses = 0;
+        }
+        entry.misses++;
+#endif // PLCRUNTIME_PROFILER
+        entry.site = PLCRUNTIME_MATH_CACHE_EMPTY; // Valid again once the result is stored
+        memcpy(entry.input, input, input_size);
+        misses++;
+        pending = &entry;
+        pending_site = site;
+        pending_size = result_size;
+        return false;
+    }
+
+    // Record the result of the instruction that missed in lookup()
+    void store(Stack<u8>& stack) {
+        if (pending == nullptr || stack.size() < pending_size) return;
+        memcpy(pending->result, stack._data + stack.size() - pending_size, pending_size);
+        pending->site = pending_site;
+        pending = nullptr;
+    }
+
+private:
+    MathCacheEntry* pending = nullptr;
+    u32 pending_site = 0;
+    u8 pending_size = 0;
+};
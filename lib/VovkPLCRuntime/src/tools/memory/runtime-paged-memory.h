@@ -0,0 +1,136 @@
+// runtime-paged-memory.h - 1.0.0 - 2022-12-11
+//
+// Copyright (c) 2022 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+// Sparse paged memory
+// With PLCRUNTIME_PAGED_MEMORY the runtime memory is not a flat array but a two-level page table over a fixed pool of
+// pages, for simulated plants with a large address space of which only a small part is used. The address is split into
+// a directory index, a table index and the offset in the page:
+//
+//    | directory | table | offset |      table = PLCRUNTIME_PAGE_TABLE_SIZE pages, page = PLCRUNTIME_PAGE_SIZE bytes
+//
+// Tables and pages are taken from their pools on the first write, a read of a page that was never written returns
+// zeros without allocating it. The last page accessed is cached, so runs of accesses to the same page skip the table
+// walk. Writes fail when the page pool is exhausted.
+
+#ifndef PLCRUNTIME_PAGE_SIZE
+#define PLCRUNTIME_PAGE_SIZE 64
+#endif // PLCRUNTIME_PAGE_SIZE
+
+#ifndef PLCRUNTIME_PAGE_TABLE_SIZE
+#define PLCRUNTIME_PAGE_TABLE_SIZE 64
+#endif // PLCRUNTIME_PAGE_TABLE_SIZE
+
+// Pages that can be allocated
+#ifndef PLCRUNTIME_PAGE_POOL_SIZE
+#define PLCRUNTIME_PAGE_POOL_SIZE 16
+#endif // PLCRUNTIME_PAGE_POOL_SIZE
+
+// Tables that can be allocated
+#ifndef PLCRUNTIME_PAGE_TABLE_POOL_SIZE
+#define PLCRUNTIME_PAGE_TABLE_POOL_SIZE 4
+#endif // PLCRUNTIME_PAGE_TABLE_POOL_SIZE
+
+static_assert((PLCRUNTIME_PAGE_SIZE & (PLCRUNTIME_PAGE_SIZE - 1)) == 0, "The page size must be a power of two");
+static_assert((PLCRUNTIME_PAGE_TABLE_SIZE & (PLCRUNTIME_PAGE_TABLE_SIZE - 1)) == 0, "The page table size must be a power of two");
+static_assert(PLCRUNTIME_PAGE_POOL_SIZE < 0xFFFF && PLCRUNTIME_PAGE_TABLE_POOL_SIZE < 0xFFFF, "Pool entries are indexed by u16");
+
+#define PLCRUNTIME_PAGE_SPAN ((u32) PLCRUNTIME_PAGE_SIZE * PLCRUNTIME_PAGE_TABLE_SIZE) // Bytes covered by one table
+#define PLCRUNTIME_PAGE_DIRECTORY_SIZE (((u32) PLCRUNTIME_MAX_MEMORY_SIZE + PLCRUNTIME_PAGE_SPAN - 1) / PLCRUNTIME_PAGE_SPAN)
+#define PLCRUNTIME_PAGE_NONE 0xFFFFFFFF
+
+class RuntimePagedMemory {
+public:
+    u16 pages_used = 0;
+    u16 tables_used = 0;
+
+    RuntimePagedMemory() { clear(); }
+
+    // Release all pages, the whole memory reads as zeros again
+    void clear() {
+        for (u32 i = 0; i < PLCRUNTIME_PAGE_DIRECTORY_SIZE; i++) directory[i] = 0;
+        pages_used = 0;
+        tables_used = 0;
+        cached_page = PLCRUNTIME_PAGE_NONE;
+        cached_data = nullptr;
+    }
+
+    // Data of the page holding the address, nullptr if it was never written and 'allocate' is false or the pool is empty
+    u8* page(u32 address, bool allocate) {
+        u32 number = address / PLCRUNTIME_PAGE_SIZE;
+        if (number == cached_page) return cached_data;
+        u16& table = directory[number / PLCRUNTIME_PAGE_TABLE_SIZE];
+        if (table == 0) {
+            if (!allocate || tables_used >= PLCRUNTIME_PAGE_TABLE_POOL_SIZE) return nullptr;
+            for (u32 i = 0; i < PLCRUNTIME_PAGE_TABLE_SIZE; i++) tables[tables_used][i] = 0;
+            table = ++tables_used;
+        }
+        u16& entry = tables[table - 1][number % PLCRUNTIME_PAGE_TABLE_SIZE];
+        if (entry == 0) {
+            if (!allocate || pages_used >= PLCRUNTIME_PAGE_POOL_SIZE) return nullptr;
+            memset(pages[pages_used], 0, PLCRUNTIME_PAGE_SIZE);
+            entry = ++pages_used;
+        }
+        cached_page = number;
+        cached_data = pages[entry - 1];
+        return cached_data;
+    }
+
+    // Read 'size' bytes at the address, returns true on error
+    bool read(u32 address, u8* data, u32 size) {
+        if (address + size > PLCRUNTIME_MAX_MEMORY_SIZE) return true;
+        while (size > 0) {
+            u32 offset = address % PLCRUNTIME_PAGE_SIZE;
+            u32 length = PLCRUNTIME_PAGE_SIZE - offset < size ? PLCRUNTIME_PAGE_SIZE - offset : size;
+            u8* source = page(address, false);
+            if (source) memcpy(data, source + offset, length);
+            else memset(data, 0, length);
+            address += length;
+            data += length;
+            size -= length;
+        }
+        return false;
+    }
+
+    // Write 'size' bytes at the address, returns true on error
+    bool write(u32 address, const u8* data, u32 size) {
+        if (address + size > PLCRUNTIME_MAX_MEMORY_SIZE) return true;
+        while (size > 0) {
+            u32 offset = address % PLCRUNTIME_PAGE_SIZE;
+            u32 length = PLCRUNTIME_PAGE_SIZE - offset < size ? PLCRUNTIME_PAGE_SIZE - offset : size;
+            u8* target = page(address, true);
+            if (target == nullptr) return true;
+            memcpy(target + offset, data, length);
+            address += length;
+            data += length;
+            size -= length;
+        }
+        return false;
+    }
+
+private:
+    u16 directory[PLCRUNTIME_PAGE_DIRECTORY_SIZE]; // Table index + 1 by directory index, 0 if not allocated
+    u16 tables[PLCRUNTIME_PAGE_TABLE_POOL_SIZE][PLCRUNTIME_PAGE_TABLE_SIZE]; // Page index + 1, 0 if not allocated
+    u8 pages[PLCRUNTIME_PAGE_POOL_SIZE][PLCRUNTIME_PAGE_SIZE];
+    u32 cached_page; // Number of the last page accessed
+    u8* cached_data;
+};
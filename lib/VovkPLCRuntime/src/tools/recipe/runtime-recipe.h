@@ -0,0 +1,163 @@
+// runtime-recipe.h - 1.0.0 - 2022-12-11
+//
+// Copyright (c) 2022 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+// Recipe manager
+// A recipe is a named block of parameter bytes for a memory range. The names and the data of all recipes are
+// packed back to back into one byte pool, the recipe table only holds the offsets. Applying a recipe only
+// marks it as pending, the block is copied into the memory with a single copy at the start of the next scan,
+// so the program never sees a half applied parameter set. Recipes are applied by name from the host or by
+// index from the program (RECIPE instruction).
+
+#ifndef PLCRUNTIME_RECIPE_MAX_COUNT
+#define PLCRUNTIME_RECIPE_MAX_COUNT 4
+#endif // PLCRUNTIME_RECIPE_MAX_COUNT
+
+#ifndef PLCRUNTIME_RECIPE_POOL_SIZE
+#define PLCRUNTIME_RECIPE_POOL_SIZE 64
+#endif // PLCRUNTIME_RECIPE_POOL_SIZE
+
+#ifndef PLCRUNTIME_RECIPE_MAX_NAME
+#define PLCRUNTIME_RECIPE_MAX_NAME 16
+#endif // PLCRUNTIME_RECIPE_MAX_NAME
+
+#define PLCRUNTIME_RECIPE_NONE 0xFF
+
+struct RecipeEntry {
+    u32 address;     // Memory address the block is copied to
+    u32 offset;      // Pool offset of the name, the data follows the name
+    u16 size;        // Data size in bytes
+    u8 name_length;
+};
+
+class RuntimeRecipes {
+public:
+    RecipeEntry recipes[PLCRUNTIME_RECIPE_MAX_COUNT];
+    u8 count = 0;
+    u32 pool_used = 0;
+    u8 pending = PLCRUNTIME_RECIPE_NONE; // Recipe applied at the start of the next scan
+
+    RuntimeRecipes() {}
+
+    // Index of the recipe with the given name, PLCRUNTIME_RECIPE_NONE if there is none
+    u8 find(const char* name, u8 name_length) const {
+        for (u8 i = 0; i < count; i++) {
+            if (recipes[i].name_length != name_length) continue;
+            if (memcmp(pool + recipes[i].offset, name, name_length) == 0) return i;
+        }
+        return PLCRUNTIME_RECIPE_NONE;
+    }
+
+    // Store a recipe, a recipe with the same name is replaced in place and keeps its index. Returns true on error
+    bool store(const char* name, u8 name_length, u32 address, const u8* data, u16 size) {
+        u8* values = reserve(name, name_length, address, size);
+        if (values == nullptr) return true;
+        memcpy(values, data, size);
+        return false;
+    }
+
+    // Store the current values of the memory range as a recipe. Returns true on error
+    bool snapshot(const char* name, u8 name_length, plc_memory_t memory, u32 address, u16 size) {
+        u8* values = reserve(name, name_length, address, size);
+        if (values == nullptr) return true;
+        return readArea_u8(memory, address, values, size);
+    }
+
+    // Remove a recipe and close the gap in the pool. Returns true on error
+    bool remove(u8 index) {
+        if (index >= count) return true;
+        u32 start = recipes[index].offset;
+        u32 length = recipes[index].name_length + recipes[index].size;
+        memmove(pool + start, pool + start + length, pool_used - start - length);
+        pool_used -= length;
+        for (u8 i = index; i + 1 < count; i++) recipes[i] = recipes[i + 1];
+        count--;
+        for (u8 i = 0; i < count; i++) {
+            if (recipes[i].offset > start) recipes[i].offset -= length;
+        }
+        // The indices after the removed recipe moved down
+        if (pending == index) pending = PLCRUNTIME_RECIPE_NONE;
+        else if (pending != PLCRUNTIME_RECIPE_NONE && pending > index) pending--;
+        return false;
+    }
+
+    void clear() {
+        count = 0;
+        pool_used = 0;
+        pending = PLCRUNTIME_RECIPE_NONE;
+    }
+
+    // Schedule the recipe for the next scan boundary, a later request replaces an earlier one. Returns true on error
+    bool request(u8 index) {
+        if (index >= count) return true;
+        pending = index;
+        return false;
+    }
+
+    // Copy the pending recipe into the memory, called at the start of every scan
+    void apply(plc_memory_t memory) {
+        if (pending == PLCRUNTIME_RECIPE_NONE) return;
+        const RecipeEntry& entry = recipes[pending];
+        writeArea_u8(memory, entry.address, pool + entry.offset + entry.name_length, entry.size);
+        pending = PLCRUNTIME_RECIPE_NONE;
+    }
+
+    const u8* data(u8 index) const { return index < count ? pool + recipes[index].offset + recipes[index].name_length : nullptr; }
+    const char* name(u8 index) const { return index < count ? (const char*) pool + recipes[index].offset : nullptr; }
+
+private:
+    u8 pool[PLCRUNTIME_RECIPE_POOL_SIZE];
+
+    // Add the entry for a recipe, replacing the one with the same name, and return where its values go in the pool
+    u8* reserve(const char* name, u8 name_length, u32 address, u16 size) {
+        if (name_length == 0 || name_length > PLCRUNTIME_RECIPE_MAX_NAME || size == 0) return nullptr;
+        if (address + size > PLCRUNTIME_MAX_MEMORY_SIZE) return nullptr;
+        u8 existing = find(name, name_length);
+        u32 freed = existing == PLCRUNTIME_RECIPE_NONE ? 0 : recipes[existing].size;
+        if (existing == PLCRUNTIME_RECIPE_NONE && count >= PLCRUNTIME_RECIPE_MAX_COUNT) return nullptr;
+        if (pool_used - freed + (existing == PLCRUNTIME_RECIPE_NONE ? name_length : 0) + size > PLCRUNTIME_RECIPE_POOL_SIZE) return nullptr;
+        if (existing != PLCRUNTIME_RECIPE_NONE) {
+            // Resized in place, the index used by the RECIPE instructions and a pending request stay valid
+            RecipeEntry& entry = recipes[existing];
+            u32 values = entry.offset + name_length;
+            u32 end = values + entry.size;
+            memmove(pool + values + size, pool + end, pool_used - end);
+            for (u8 i = 0; i < count; i++) {
+                if (recipes[i].offset > entry.offset) recipes[i].offset = recipes[i].offset - entry.size + size;
+            }
+            pool_used = pool_used - entry.size + size;
+            entry.address = address;
+            entry.size = size;
+            return pool + values;
+        }
+        RecipeEntry& entry = recipes[count];
+        entry.address = address;
+        entry.offset = pool_used;
+        entry.size = size;
+        entry.name_length = name_length;
+        memcpy(pool + pool_used, name, name_length);
+        u8* values = pool + pool_used + name_length;
+        pool_used += name_length + size;
+        count++;
+        return values;
+    }
+};
@@ -0,0 +1,647 @@
+// runtime-register-impl.h - 1.0.0 - 2022-12-11
+//
+// Copyright (c) 2022 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "runtime-register.h"
+
+// Register values are stored in the host byte order, the same way as in the PLC memory
+template <typename T> inline T register_read(const u8* location) {
+    T value;
+    memcpy(&value, location, sizeof(T));
+    return value;
+}
+
+template <typename T> inline void register_write(u8* location, T value) {
+    memcpy(location, &value, sizeof(T));
+}
+
+// Size of the value of the given type on the stack, 0 for types without a register form
+u8 register_type_size(u8 type) {
+    switch (type) {
+        case type_pointer: return sizeof(MY_PTR_t);
+        case type_bool: case type_u8: case type_i8: return 1;
+        case type_u16: case type_i16: return 2;
+        case type_u32: case type_i32: case type_f32: return 4;
+#ifdef USE_X64_OPS
+        case type_u64: case type_i64: case type_f64: return 8;
+#endif // USE_X64_OPS
+        default: return 0;
+    }
+}
+
+template <typename T> void register_arithmetic(u8 code, u8* dst, u8* a, u8* b) {
+    T x = register_read<T>(a);
+    T y = register_read<T>(b);
+    switch (code) {
+        case ADD: register_write<T>(dst, x + y); break;
+        case SUB: register_write<T>(dst, x - y); break;
+        case MUL: register_write<T>(dst, x * y); break;
+        case DIV: register_write<T>(dst, x / y); break;
+        case CMP_EQ: register_write<u8>(dst, x == y); break;
+        case CMP_NEQ: register_write<u8>(dst, x != y); break;
+        case CMP_GT: register_write<u8>(dst, x > y); break;
+        case CMP_GTE: register_write<u8>(dst, x >= y); break;
+        case CMP_LT: register_write<u8>(dst, x < y); break;
+        case CMP_LTE: register_write<u8>(dst, x <= y); break;
+        default: break;
+    }
+}
+
+template <typename T> void register_bitwise(u8 code, u8* dst, u8* a, u8* b) {
+    T x = register_read<T>(a);
+    switch (code) {
+        case BW_AND_X8: case BW_AND_X16: case BW_AND_X32: case BW_AND_X64: register_write<T>(dst, x & register_read<T>(b)); break;
+        case BW_OR_X8: case BW_OR_X16: case BW_OR_X32: case BW_OR_X64: register_write<T>(dst, x | register_read<T>(b)); break;
+        case BW_XOR_X8: case BW_XOR_X16: case BW_XOR_X32: case BW_XOR_X64: register_write<T>(dst, x ^ register_read<T>(b)); break;
+        case BW_NOT_X8: case BW_NOT_X16: case BW_NOT_X32: case BW_NOT_X64: register_write<T>(dst, ~x); break;
+        default: break;
+    }
+}
+
+RuntimeError register_arithmetic(u8 code, u8 type, u8* dst, u8* a, u8* b) {
+    switch (type) {
+        case type_bool:
+        case type_u8: register_arithmetic<u8>(code, dst, a, b); break;
+        case type_u16: register_arithmetic<u16>(code, dst, a, b); break;
+        case type_u32: register_arithmetic<u32>(code, dst, a, b); break;
+        case type_i8: register_arithmetic<i8>(code, dst, a, b); break;
+        case type_i16: register_arithmetic<i16>(code, dst, a, b); break;
+        case type_i32: register_arithmetic<i32>(code, dst, a, b); break;
+        case type_f32: register_arithmetic<f32>(code, dst, a, b); break;
+#ifdef USE_X64_OPS
+        case type_u64: register_arithmetic<u64>(code, dst, a, b); break;
+        case type_i64: register_arithmetic<i64>(code, dst, a, b); break;
+        case type_f64: register_arithmetic<f64>(code, dst, a, b); break;
+#endif // USE_X64_OPS
+        default: return INVALID_DATA_TYPE;
+    }
+    return STATUS_SUCCESS;
+}
+
+RuntimeError register_modulo(u8 type, u8* dst, u8* a, u8* b) {
+    switch (type) {
+        case type_bool:
+        case type_u8: register_write<u8>(dst, register_read<u8>(a) % register_read<u8>(b)); break;
+        case type_u16: register_write<u16>(dst, register_read<u16>(a) % register_read<u16>(b)); break;
+        case type_u32: register_write<u32>(dst, register_read<u32>(a) % register_read<u32>(b)); break;
+        case type_i8: register_write<i8>(dst, register_read<i8>(a) % register_read<i8>(b)); break;
+        case type_i16: register_write<i16>(dst, register_read<i16>(a) % register_read<i16>(b)); break;
+        case type_i32: register_write<i32>(dst, register_read<i32>(a) % register_read<i32>(b)); break;
+#ifdef USE_X64_OPS
+        case type_u64: register_write<u64>(dst, register_read<u64>(a) % register_read<u64>(b)); break;
+        case type_i64: register_write<i64>(dst, register_read<i64>(a) % register_read<i64>(b)); break;
+#endif // USE_X64_OPS
+        default: return INVALID_DATA_TYPE;
+    }
+    return STATUS_SUCCESS;
+}
+
+RuntimeError register_push(RuntimeStack& stack, u8 size, u8* a) {
+    switch (size) {
+        case 1: return stack.push_u8(register_read<u8>(a));
+        case 2: return stack.push_u16(register_read<u16>(a));
+        case 4: return stack.push_u32(register_read<u32>(a));
+#ifdef USE_X64_OPS
+        case 8: return stack.push_u64(register_read<u64>(a));
+#endif // USE_X64_OPS
+        default: return INVALID_DATA_TYPE;
+    }
+}
+
+RuntimeError register_pop(RuntimeStack& stack, u8 size, u8* dst) {
+    switch (size) {
+        case 1: register_write<u8>(dst, stack.pop_u8()); break;
+        case 2: register_write<u16>(dst, stack.pop_u16()); break;
+        case 4: register_write<u32>(dst, stack.pop_u32()); break;
+#ifdef USE_X64_OPS
+        case 8: register_write<u64>(dst, stack.pop_u64()); break;
+#endif // USE_X64_OPS
+        default: return INVALID_DATA_TYPE;
+    }
+    return STATUS_SUCCESS;
+}
+
+RegisterInstruction& RuntimeRegisterEngine::emit(u8 op, u8 size, u8* dst, u8* a, u8* b) {
+    static RegisterInstruction dummy;
+    if (code_count >= PLCRUNTIME_REGISTER_MAX_INSTRUCTIONS) {
+        overflow = true;
+        return dummy;
+    }
+    RegisterInstruction& instruction = code[code_count++];
+    instruction.op = op;
+    instruction.code = 0;
+    instruction.type = 0;
+    instruction.size = size;
+    instruction.dst = dst;
+    instruction.a = a;
+    instruction.b = b;
+    instruction.origin = origin;
+    instruction.target = 0;
+    return instruction;
+}
+
+u32 RuntimeRegisterEngine::nextPosition() {
+    if (operand_count == 0) return 0;
+    RegisterOperand& top = operands[operand_count - 1];
+    return top.position + top.size;
+}
+
+// Returns the register for a new value on top of the stack
+u8* RuntimeRegisterEngine::allocate(u8 size) {
+    if (operand_count >= PLCRUNTIME_MAX_STACK_SIZE || nextPosition() + size > PLCRUNTIME_REGISTER_FRAME_SIZE) {
+        // Out of registers, keep the older values on the runtime stack
+        flush();
+    }
+    return frame + nextPosition();
+}
+
+void RuntimeRegisterEngine::pushOperand(u8* ptr, u8 size, u8 kind) {
+    u32 count = operand_count;
+    u8* location = allocate(size);
+    if (count != operand_count && (kind == OPERAND_FRAME || kind == OPERAND_SPILL)) {
+        // The register was flushed together with the rest, keep a copy of it
+        emit(REG_COPY, size, location, ptr);
+        ptr = location;
+        kind = OPERAND_FRAME;
+    }
+    RegisterOperand& operand = operands[operand_count++];
+    operand.ptr = ptr;
+    operand.position = location - frame;
+    operand.size = size;
+    operand.kind = kind;
+}
+
+RegisterOperand RuntimeRegisterEngine::popOperand() {
+    return operands[--operand_count];
+}
+
+// Make sure the top operands exist with the given sizes, values missing in registers are popped from the runtime stack
+bool RuntimeRegisterEngine::require(u8 count, u8 size_top, u8 size_below) {
+    u8 sizes[2] = { size_top, size_below };
+    for (u8 i = 0; i < count && i < operand_count; i++)
+        if (operands[operand_count - 1 - i].size != sizes[i]) return false;
+    if (operand_count >= count) return true;
+    u8 missing = count - operand_count;
+    u32 needed = 0;
+    for (u8 i = operand_count; i < count; i++) needed += sizes[i];
+    if (spill_offset + needed > PLCRUNTIME_REGISTER_SPILL_SIZE) return false;
+    for (u32 i = operand_count; i > 0; i--) operands[i - 1 + missing] = operands[i - 1];
+    for (u8 i = 0; i < missing; i++) {
+        // Popped in order: the first one is directly below the values held in registers
+        u8 size = sizes[count - missing + i];
+        u8* spill = frame + PLCRUNTIME_REGISTER_FRAME_SIZE + spill_offset;
+        spill_offset += size;
+        emit(REG_POP, size, spill);
+        RegisterOperand& operand = operands[missing - 1 - i];
+        operand.ptr = spill;
+        operand.position = 0;
+        operand.size = size;
+        operand.kind = OPERAND_SPILL;
+    }
+    operand_count += missing;
+    return true;
+}
+
+// Push all values held in registers to the runtime stack
+void RuntimeRegisterEngine::flush() {
+    for (u32 i = 0; i < operand_count; i++)
+        emit(REG_PUSH, operands[i].size, nullptr, operands[i].ptr);
+    operand_count = 0;
+    spill_offset = 0;
+}
+
+// Copy pending memory reads into registers before the memory gets written
+void RuntimeRegisterEngine::materialize(u32 address, u32 size, bool all) {
+    u8* memory = target_runtime->memory;
+    for (u32 i = 0; i < operand_count; i++) {
+        RegisterOperand& operand = operands[i];
+        if (operand.kind != OPERAND_MEMORY) continue;
+        u32 start = operand.ptr - memory;
+        if (!all && (start >= address + size || address >= start + operand.size)) continue;
+        u8* location = frame + operand.position;
+        emit(REG_COPY, operand.size, location, operand.ptr);
+        operand.ptr = location;
+        operand.kind = OPERAND_FRAME;
+    }
+}
+
+// Let the stack engine execute the instruction at the given address
+void RuntimeRegisterEngine::escape(u32 address, u32 next) {
+    flush();
+    RegisterInstruction& instruction = emit(REG_STEP);
+    instruction.origin = address;
+    instruction.target = next;
+}
+
+// Store the big endian constant from the bytecode into the constant pool in the host byte order
+u8* RuntimeRegisterEngine::constant(u8* bytecode, u8 size) {
+    if (constants_size + size > PLCRUNTIME_REGISTER_MAX_CONSTANTS) {
+        overflow = true;
+        return constants;
+    }
+    u8* location = constants + constants_size;
+    constants_size += size;
+    switch (size) {
+        case 1: register_write<u8>(location, bytecode[0]); break;
+        case 2: register_write<u16>(location, ((u16) bytecode[0] << 8) | bytecode[1]); break;
+        case 4: register_write<u32>(location, ((u32) bytecode[0] << 24) | ((u32) bytecode[1] << 16) | ((u32) bytecode[2] << 8) | bytecode[3]); break;
+#ifdef USE_X64_OPS
+        case 8: {
+            u64 value = 0;
+            for (u8 i = 0; i < 8; i++) value = (value << 8) | bytecode[i];
+            register_write<u64>(location, value);
+            break;
+        }
+#endif // USE_X64_OPS
+        default: overflow = true; break;
+    }
+    return location;
+}
+
+u32 RuntimeRegisterEngine::findBlock(u32 address) {
+    u32 low = 0;
+    u32 high = block_count;
+    while (low < high) {
+        u32 middle = (low + high) / 2;
+        if (block_origin[middle] < address) low = middle + 1;
+        else high = middle;
+    }
+    if (low < block_count && block_origin[low] == address) return block_index[low];
+    return PLCRUNTIME_REGISTER_MAX_INSTRUCTIONS;
+}
+
+RuntimeError RuntimeRegisterEngine::translate(VovkPLCRuntime& runtime) {
+    static u8 marks[PLCRUNTIME_MAX_PROGRAM_SIZE / 4 + 1];
+    const u8 MARK_INSTRUCTION = 1;
+    const u8 MARK_LEADER = 2;
+#define REGISTER_MARK(address) ((marks[(address) >> 2] >> (((address) & 3) << 1)) & 3)
+#define REGISTER_SET_MARK(address, mark) marks[(address) >> 2] |= (mark) << (((address) & 3) << 1)
+    translated = false;
+    target_runtime = &runtime;
+    program_generation = runtime.program.generation;
+    program_size = runtime.program.prog_size;
+    code_count = 0;
+    block_count = 0;
+    constants_size = 0;
+    operand_count = 0;
+    spill_offset = 0;
+    overflow = false;
+    u8* program = runtime.program.program;
+    u32 prog_size = runtime.program.prog_size;
+    if (prog_size == 0) return EMPTY_PROGRAM;
+
+    // Find instruction boundaries and the leaders of basic blocks
+    for (u32 i = 0; i <= prog_size / 4; i++) marks[i] = 0;
+    u32 index = 0;
+    while (index < prog_size) {
+        u8 opcode = program[index];
+        u8 size = OPCODE_SIZE((PLCRuntimeInstructionSet) opcode);
+        if (size == 0 || index + size > prog_size) break; // The stack engine reports the error when it gets there
+        REGISTER_SET_MARK(index, MARK_INSTRUCTION);
+        bool jump = opcode == JMP || opcode == JMP_IF || opcode == JMP_IF_NOT || opcode == CALL || opcode == CALL_IF || opcode == CALL_IF_NOT;
+        bool ends = jump || opcode == RET || opcode == RET_IF || opcode == RET_IF_NOT || opcode == EXIT;
+        if (jump) {
+            u32 address = ((u32) program[index + 1] << 8) | program[index + 2];
+            if (address < prog_size) REGISTER_SET_MARK(address, MARK_LEADER);
+        }
+        index += size;
+        if (ends && index < prog_size) REGISTER_SET_MARK(index, MARK_LEADER);
+    }
+    u32 decoded_size = index;
+
+    // Translate
+    index = 0;
+    while (index < decoded_size && !overflow) {
+        origin = index;
+        u8 opcode = program[index];
+        u8 size = OPCODE_SIZE((PLCRuntimeInstructionSet) opcode);
+        u32 next = index + size;
+        if (index == 0 || (REGISTER_MARK(index) & MARK_LEADER)) {
+            flush();
+            if (block_count >= PLCRUNTIME_REGISTER_MAX_BLOCKS) { overflow = true; break; }
+            block_origin[block_count] = index;
+            block_index[block_count] = code_count;
+            block_count++;
+        }
+        u8 type = size > 1 ? program[index + 1] : 0;
+        u8 type_size = register_type_size(type);
+        bool handled = true;
+        switch (opcode) {
+            case NOP: break;
+            case type_pointer: case type_bool: case type_u8: case type_i8: case type_u16: case type_i16:
+            case type_u32: case type_i32: case type_f32:
+#ifdef USE_X64_OPS
+            case type_u64: case type_i64: case type_f64:
+#endif // USE_X64_OPS
+                pushOperand(constant(program + index + 1, size - 1), size - 1, OPERAND_CONSTANT);
+                break;
+            case COPY: {
+                if (!type_size || !require(1, type_size, 0)) { handled = false; break; }
+                RegisterOperand value = operands[operand_count - 1];
+                pushOperand(value.ptr, value.size, value.kind);
+                break;
+            }
+            case DROP: {
+                if (!type_size || operand_count == 0 || operands[operand_count - 1].size != type_size) { handled = false; break; }
+                popOperand();
+                break;
+            }
+            case LOAD: {
+                if (!type_size || !require(1, sizeof(MY_PTR_t), 0)) { handled = false; break; }
+                RegisterOperand pointer = operands[operand_count - 1];
+                if (pointer.kind == OPERAND_CONSTANT) {
+                    u32 address = register_read<MY_PTR_t>(pointer.ptr);
+                    if (address + type_size > PLCRUNTIME_MAX_MEMORY_SIZE) { handled = false; break; }
+                    popOperand();
+                    pushOperand(runtime.memory + address, type_size, OPERAND_MEMORY);
+                    break;
+                }
+                popOperand();
+                u8* dst = allocate(type_size);
+                emit(REG_LOAD, type_size, dst, pointer.ptr);
+                pushOperand(dst, type_size, OPERAND_FRAME);
+                break;
+            }
+            case MOVE:
+            case MOVE_COPY: {
+                if (!type_size || !require(2, type_size, sizeof(MY_PTR_t))) { handled = false; break; }
+                RegisterOperand pointer = operands[operand_count - 2];
+                u32 address = pointer.kind == OPERAND_CONSTANT ? register_read<MY_PTR_t>(pointer.ptr) : 0;
+                if (pointer.kind == OPERAND_CONSTANT && address + type_size > PLCRUNTIME_MAX_MEMORY_SIZE) { handled = false; break; }
+                RegisterOperand value = popOperand();
+                popOperand();
+                if (opcode == MOVE_COPY && value.kind == OPERAND_MEMORY) {
+                    // The value is used again after the store, keep the original in a spill register
+                    if (spill_offset + value.size > PLCRUNTIME_REGISTER_SPILL_SIZE) { handled = false; break; }
+                    u8* spill = frame + PLCRUNTIME_REGISTER_FRAME_SIZE + spill_offset;
+                    spill_offset += value.size;
+                    emit(REG_COPY, value.size, spill, value.ptr);
+                    value.ptr = spill;
+                    value.kind = OPERAND_SPILL;
+                }
+                if (pointer.kind != OPERAND_CONSTANT) {
+                    materialize(0, 0, true);
+                    emit(REG_STORE, type_size, nullptr, pointer.ptr, value.ptr);
+                } else {
+                    bool pending = false;
+                    for (u32 i = 0; i < operand_count; i++) if (operands[i].kind == OPERAND_MEMORY) pending = true;
+                    materialize(address, type_size, false);
+                    // Write the result of the previous instruction directly into the memory if nothing else refers to it
+                    RegisterInstruction* last = code_count > 0 ? &code[code_count - 1] : nullptr;
+                    bool direct = opcode == MOVE && !pending && last && last->dst == value.ptr && value.kind == OPERAND_FRAME;
+                    if (direct) for (u32 i = 0; i < operand_count; i++) if (operands[i].ptr == value.ptr) direct = false;
+                    if (direct && (last->op == REG_ARITHMETIC || last->op == REG_MODULO || last->op == REG_BITWISE || last->op == REG_LOGIC || last->op == REG_LOAD || last->op == REG_COPY)) {
+                        last->dst = runtime.memory + address;
+                    } else emit(REG_COPY, type_size, runtime.memory + address, value.ptr);
+                }
+                if (opcode == MOVE_COPY) {
+                    if (value.kind == OPERAND_FRAME) {
+                        // The value moves down to the position of the pointer
+                        u8* location = allocate(value.size);
+                        if (location != value.ptr) emit(REG_COPY, value.size, location, value.ptr);
+                        value.ptr = location;
+                    }
+                    pushOperand(value.ptr, value.size, value.kind);
+                }
+                break;
+            }
+            case ADD: case SUB: case MUL: case DIV: case MOD:
+            case CMP_EQ: case CMP_NEQ: case CMP_GT: case CMP_GTE: case CMP_LT: case CMP_LTE: {
+                if (!type_size || type == type_pointer) { handled = false; break; }
+                bool real = type == type_f32 || type == type_f64;
+                if (opcode == MOD && real) { handled = false; break; }
+                if (!require(2, type_size, type_size)) { handled = false; break; }
+                RegisterOperand b = popOperand();
+                RegisterOperand a = popOperand();
+                u8 result_size = opcode >= CMP_EQ ? 1 : type_size;
+                u8* dst = allocate(result_size);
+                RegisterInstruction& instruction = emit(opcode == MOD ? REG_MODULO : REG_ARITHMETIC, type_size, dst, a.ptr, b.ptr);
+                instruction.code = opcode;
+                instruction.type = type;
+                pushOperand(dst, result_size, OPERAND_FRAME);
+                break;
+            }
+            case BW_AND_X8: case BW_AND_X16: case BW_AND_X32:
+            case BW_OR_X8: case BW_OR_X16: case BW_OR_X32:
+            case BW_XOR_X8: case BW_XOR_X16: case BW_XOR_X32:
+            case BW_NOT_X8: case BW_NOT_X16: case BW_NOT_X32:
+#ifdef USE_X64_OPS
+            case BW_AND_X64: case BW_OR_X64: case BW_XOR_X64: case BW_NOT_X64:
+#endif // USE_X64_OPS
+            case LOGIC_AND: case LOGIC_OR: case LOGIC_XOR: case LOGIC_NOT: {
+                bool logic = opcode >= LOGIC_AND;
+                bool unary = opcode == LOGIC_NOT || (opcode >= BW_NOT_X8 && opcode <= BW_NOT_X64);
+                u8 width = logic ? 1 : 1 << ((opcode - BW_AND_X8) & 3);
+                if (!require(unary ? 1 : 2, width, width)) { handled = false; break; }
+                RegisterOperand b = popOperand();
+                RegisterOperand a = unary ? b : popOperand();
+                u8* dst = allocate(width);
+                RegisterInstruction& instruction = emit(logic ? REG_LOGIC : REG_BITWISE, width, dst, a.ptr, b.ptr);
+                instruction.code = opcode;
+                pushOperand(dst, width, OPERAND_FRAME);
+                break;
+            }
+            case JMP:
+            case JMP_IF:
+            case JMP_IF_NOT: {
+                u32 address = ((u32) program[index + 1] << 8) | program[index + 2];
+                if (address >= prog_size || !(REGISTER_MARK(address) & MARK_INSTRUCTION)) { handled = false; break; }
+                if (opcode != JMP && !require(1, 1, 0)) { handled = false; break; }
+                RegisterOperand condition;
+                if (opcode != JMP) condition = popOperand();
+                flush();
+                RegisterInstruction& instruction = emit(opcode == JMP ? REG_JMP : opcode == JMP_IF ? REG_JMP_IF : REG_JMP_IF_NOT, 1, nullptr, opcode == JMP ? nullptr : condition.ptr);
+                instruction.target = address; // Linked after translation
+                break;
+            }
+            case EXIT: {
+                flush();
+                emit(REG_EXIT);
+                break;
+            }
+            default: handled = false; break;
+        }
+        if (!handled) escape(index, next);
+        index = next;
+    }
+    if (decoded_size < prog_size) {
+        // Leave the rest to the stack engine so the error is reported the same way
+        origin = decoded_size;
+        escape(decoded_size, prog_size);
+    }
+    flush();
+    emit(REG_EXIT);
+#undef REGISTER_MARK
+#undef REGISTER_SET_MARK
+    if (overflow) return PROGRAM_SIZE_EXCEEDED;
+
+    // Link jumps to the register instructions
+    for (u32 i = 0; i < code_count; i++) {
+        RegisterInstruction& instruction = code[i];
+        if (instruction.op != REG_JMP && instruction.op != REG_JMP_IF && instruction.op != REG_JMP_IF_NOT) continue;
+        instruction.target = findBlock(instruction.target);
+        if (instruction.target >= code_count) return PROGRAM_POINTER_OUT_OF_BOUNDS;
+    }
+    translated = true;
+    return STATUS_SUCCESS;
+}
+
+RuntimeError RuntimeRegisterEngine::run(VovkPLCRuntime& runtime) {
+    dispatch_count = 0;
+    // A program loaded or modified since the translation is translated again, it runs on the stack engine if that fails
+    if (target_runtime == &runtime && (program_generation != runtime.program.generation || program_size != runtime.program.prog_size)) translate(runtime);
+    if (!translated || target_runtime != &runtime) return runtime.run();
+    RuntimeError status = execute(runtime);
+    if (status == STATUS_SUCCESS) runtime.scanComplete();
+    return status;
+}
+
+RuntimeError RuntimeRegisterEngine::execute(VovkPLCRuntime& runtime) {
+    runtime.clear();
+    runtime.scanStart();
+    RuntimeStack& stack = runtime.stack;
+    u8* program = runtime.program.program;
+    u32 prog_size = runtime.program.prog_size;
+    u32 i = 0;
+    while (true) {
+        RegisterInstruction& instruction = code[i];
+        dispatch_count++;
+        switch (instruction.op) {
+            case REG_ARITHMETIC: register_arithmetic(instruction.code, instruction.type, instruction.dst, instruction.a, instruction.b); i++; break;
+            case REG_MODULO: register_modulo(instruction.type, instruction.dst, instruction.a, instruction.b); i++; break;
+            case REG_BITWISE: {
+                switch (instruction.size) {
+                    case 1: register_bitwise<u8>(instruction.code, instruction.dst, instruction.a, instruction.b); break;
+                    case 2: register_bitwise<u16>(instruction.code, instruction.dst, instruction.a, instruction.b); break;
+                    case 4: register_bitwise<u32>(instruction.code, instruction.dst, instruction.a, instruction.b); break;
+#ifdef USE_X64_OPS
+                    case 8: register_bitwise<u64>(instruction.code, instruction.dst, instruction.a, instruction.b); break;
+#endif // USE_X64_OPS
+                    default: break;
+                }
+                i++;
+                break;
+            }
+            case REG_LOGIC: {
+                u8 a = *instruction.a != 0;
+                u8 b = *instruction.b != 0;
+                switch (instruction.code) {
+                    case LOGIC_AND: *instruction.dst = a && b; break;
+                    case LOGIC_OR: *instruction.dst = a || b; break;
+                    case LOGIC_XOR: *instruction.dst = a ^ b; break;
+                    case LOGIC_NOT: *instruction.dst = !a; break;
+                    default: break;
+                }
+                i++;
+                break;
+            }
+            case REG_COPY: {
+                for (u8 j = 0; j < instruction.size; j++) instruction.dst[j] = instruction.a[j];
+                i++;
+                break;
+            }
+            case REG_LOAD: {
+                u32 address = register_read<MY_PTR_t>(instruction.a);
+                if (address + instruction.size > PLCRUNTIME_MAX_MEMORY_SIZE) return INVALID_MEMORY_ADDRESS;
+                for (u8 j = 0; j < instruction.size; j++) instruction.dst[j] = runtime.memory[address + j];
+                i++;
+                break;
+            }
+            case REG_STORE: {
+                u32 address = register_read<MY_PTR_t>(instruction.a);
+                if (address + instruction.size > PLCRUNTIME_MAX_MEMORY_SIZE) return INVALID_MEMORY_ADDRESS;
+                for (u8 j = 0; j < instruction.size; j++) runtime.memory[address + j] = instruction.b[j];
+                i++;
+                break;
+            }
+            case REG_PUSH: {
+                RuntimeError status = register_push(stack, instruction.size, instruction.a);
+                if (status != STATUS_SUCCESS) return status;
+                i++;
+                break;
+            }
+            case REG_POP: register_pop(stack, instruction.size, instruction.dst); i++; break;
+            case REG_JMP:
+            case REG_JMP_IF:
+            case REG_JMP_IF_NOT: {
+                bool taken = instruction.op == REG_JMP || (*instruction.a != 0) == (instruction.op == REG_JMP_IF);
+                if (!taken) { i++; break; }
+                // Backward jumps draw from the loop budget like in the stack engine
+                if (instruction.target <= i && runtime.loop_limit && --runtime.loop_budget == 0) return runtime.loopLimitExceeded(instruction.origin);
+                i = instruction.target;
+                break;
+            }
+            case REG_STEP: {
+                u32 index = instruction.origin;
+                RuntimeError status = runtime.step(program, prog_size, index);
+                if (status != STATUS_SUCCESS) return status == PROGRAM_EXITED ? STATUS_SUCCESS : status;
+                if (index == instruction.target) { i++; break; }
+                // Calls and returns continue at a block start
+                i = findBlock(index);
+                if (i < code_count) break;
+                // Not a translated address, continue with the stack engine
+                while (index < prog_size) {
+                    status = runtime.step(program, prog_size, index);
+                    if (status != STATUS_SUCCESS) return status == PROGRAM_EXITED ? STATUS_SUCCESS : status;
+                }
+                return STATUS_SUCCESS;
+            }
+            case REG_EXIT: return STATUS_SUCCESS;
+            default: return UNKNOWN_INSTRUCTION;
+        }
+    }
+}
+
+void RuntimeRegisterEngine::explain() {
+    Serial.println(F("#### Register Program Explanation:"));
+    if (!translated) {
+        Serial.println(F("Program is not translated."));
+        return;
+    }
+    for (u32 i = 0; i < code_count; i++) {
+        RegisterInstruction& instruction = code[i];
+        Serial.print(F("    "));
+        print_number_padStart(i, 4);
+        Serial.print(F(" <- "));
+        print_number_padStart(instruction.origin, 4);
+        Serial.print(F(": "));
+        switch (instruction.op) {
+            case REG_ARITHMETIC:
+            case REG_MODULO:
+            case REG_BITWISE:
+            case REG_LOGIC: Serial.print(OPCODE_NAME((PLCRuntimeInstructionSet) instruction.code)); break;
+            case REG_COPY: Serial.print(F("COPY")); break;
+            case REG_LOAD: Serial.print(F("LOAD")); break;
+            case REG_STORE: Serial.print(F("STORE")); break;
+            case REG_PUSH: Serial.print(F("PUSH")); break;
+            case REG_POP: Serial.print(F("POP")); break;
+            case REG_JMP: Serial.print(F("JMP ")); Serial.print(instruction.target); break;
+            case REG_JMP_IF: Serial.print(F("JMP_IF ")); Serial.print(instruction.target); break;
+            case REG_JMP_IF_NOT: Serial.print(F("JMP_IF_NOT ")); Serial.print(instruction.target); break;
+            case REG_STEP: Serial.print(F("STEP ")); Serial.print(OPCODE_NAME((PLCRuntimeInstructionSet) target_runtime->program.program[instruction.origin])); break;
+            case REG_EXIT: Serial.print(F("EXIT")); break;
+            default: Serial.print(F("UNKNOWN")); break;
+        }
+        if (instruction.size) { Serial.print(F(" x")); Serial.print(instruction.size); }
+        Serial.println();
+    }
+}
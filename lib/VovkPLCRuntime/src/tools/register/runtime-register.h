@@ -0,0 +1,140 @@
+// runtime-register.h - 1.0.0 - 2022-12-11
+//
+// Copyright (c) 2022 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+// Register execution engine
+// The loaded stack bytecode is translated block by block into three-address instructions that operate
+// directly on a register frame, a constant pool and the PLC memory. Constants, constant address loads and
+// stores and stack copies are folded into the operands of the instruction that consumes them, so they cost
+// no dispatch at all. At block boundaries the values still held in registers are pushed to the runtime stack,
+// which keeps the stack as the only state shared between blocks. Instructions without a register form are
+// executed by the stack engine in place.
+
+#ifdef PLCRUNTIME_PAGED_MEMORY
+#error "The register engine operates on pointers into the flat memory and can not be used with PLCRUNTIME_PAGED_MEMORY"
+#endif // PLCRUNTIME_PAGED_MEMORY
+
+#ifndef PLCRUNTIME_REGISTER_MAX_INSTRUCTIONS
+#define PLCRUNTIME_REGISTER_MAX_INSTRUCTIONS (PLCRUNTIME_MAX_PROGRAM_SIZE / 2)
+#endif // PLCRUNTIME_REGISTER_MAX_INSTRUCTIONS
+
+#ifndef PLCRUNTIME_REGISTER_MAX_BLOCKS
+#define PLCRUNTIME_REGISTER_MAX_BLOCKS (PLCRUNTIME_MAX_PROGRAM_SIZE / 8)
+#endif // PLCRUNTIME_REGISTER_MAX_BLOCKS
+
+#ifndef PLCRUNTIME_REGISTER_MAX_CONSTANTS
+#define PLCRUNTIME_REGISTER_MAX_CONSTANTS (PLCRUNTIME_MAX_PROGRAM_SIZE / 2)
+#endif // PLCRUNTIME_REGISTER_MAX_CONSTANTS
+
+#define PLCRUNTIME_REGISTER_FRAME_SIZE PLCRUNTIME_MAX_STACK_SIZE
+#define PLCRUNTIME_REGISTER_SPILL_SIZE PLCRUNTIME_MAX_STACK_SIZE
+
+enum RegisterOpcode {
+    REG_ARITHMETIC = 0, // dst = a (ADD, SUB, MUL, DIV, CMP_*) b
+    REG_MODULO,         // dst = a % b for integer types
+    REG_BITWISE,        // dst = a (BW_AND, BW_OR, BW_XOR, BW_NOT) b
+    REG_LOGIC,          // dst = a (LOGIC_AND, LOGIC_OR, LOGIC_XOR, LOGIC_NOT) b
+    REG_COPY,           // dst = a
+    REG_LOAD,           // dst = memory[a]
+    REG_STORE,          // memory[a] = b
+    REG_PUSH,           // Push a to the runtime stack
+    REG_POP,            // Pop dst from the runtime stack
+    REG_JMP,            // Jump to target
+    REG_JMP_IF,         // Jump to target if a
+    REG_JMP_IF_NOT,     // Jump to target if not a
+    REG_STEP,           // Execute the stack instruction at origin
+    REG_EXIT,           // End of program
+};
+
+struct RegisterInstruction {
+    u8 op;       // RegisterOpcode
+    u8 code;     // PLCRuntimeInstructionSet opcode of the operation
+    u8 type;     // Operand data type
+    u8 size;     // Operand size in bytes
+    u8* dst;
+    u8* a;
+    u8* b;
+    u32 origin;  // Bytecode address of the translated instruction
+    u32 target;  // Register instruction index for jumps, next bytecode address for REG_STEP
+};
+
+enum RegisterOperandKind {
+    OPERAND_FRAME = 0,
+    OPERAND_SPILL,
+    OPERAND_CONSTANT,
+    OPERAND_MEMORY,
+};
+
+struct RegisterOperand {
+    u8* ptr;
+    u32 position; // Reserved frame offset of the stack entry
+    u8 size;
+    u8 kind;      // RegisterOperandKind
+};
+
+class RuntimeRegisterEngine {
+public:
+    RegisterInstruction code[PLCRUNTIME_REGISTER_MAX_INSTRUCTIONS];
+    u32 code_count = 0;
+    u32 block_origin[PLCRUNTIME_REGISTER_MAX_BLOCKS];
+    u32 block_index[PLCRUNTIME_REGISTER_MAX_BLOCKS];
+    u32 block_count = 0;
+    u8 frame[PLCRUNTIME_REGISTER_FRAME_SIZE + PLCRUNTIME_REGISTER_SPILL_SIZE];
+    u8 constants[PLCRUNTIME_REGISTER_MAX_CONSTANTS];
+    u32 constants_size = 0;
+    bool translated = false;
+    u32 dispatch_count = 0; // Number of instructions dispatched during the last run
+
+    RuntimeRegisterEngine() {}
+
+    // Translate the program loaded into the runtime, returns an error code (0 on success)
+    RuntimeError translate(VovkPLCRuntime& runtime);
+    // Execute the translated program from the beginning, returns an error code (0 on success)
+    RuntimeError run(VovkPLCRuntime& runtime);
+    // Print the translated program to the serial port
+    void explain();
+
+private:
+    VovkPLCRuntime* target_runtime = nullptr;
+    u32 program_generation = 0; // RuntimeProgram::generation of the translated bytecode
+    u32 program_size = 0; // Size of the translated bytecode
+    RegisterOperand operands[PLCRUNTIME_MAX_STACK_SIZE];
+    u32 operand_count = 0;
+    u32 spill_offset = 0;
+    u32 origin = 0;
+    bool overflow = false;
+
+    RegisterInstruction& emit(u8 op, u8 size = 0, u8* dst = nullptr, u8* a = nullptr, u8* b = nullptr);
+    u32 nextPosition();
+    u8* allocate(u8 size);
+    void pushOperand(u8* ptr, u8 size, u8 kind);
+    RegisterOperand popOperand();
+    bool require(u8 count, u8 size_top, u8 size_below);
+    void flush();
+    void materialize(u32 address, u32 size, bool all);
+    void escape(u32 address, u32 next);
+    u8* constant(u8* bytecode, u8 size);
+    u32 findBlock(u32 address);
+    RuntimeError execute(VovkPLCRuntime& runtime);
+};
+
+#include "runtime-register-impl.h"
@@ -0,0 +1,268 @@
+// runtime-instruction-table.h - 1.0.0 - 2022-12-11
+//
+// Copyright (c) 2022 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+// ################################################################################################
+// Instruction table
+// ################################################################################################
+// Every bytecode instruction is described by one row of the table below. The opcode enum, OPCODE_EXISTS, OPCODE_NAME,
+// OPCODE_SIZE, OPCODE_OPERANDS, OPCODE_STACK_EFFECT, OPCODE_COST_CLASS, the dispatch in VovkPLCRuntime::step()
+// and the mnemonic lookup of the assembler are all generated from it, so a new instruction is added by adding a row.
+//
+//    X(name, opcode, mnemonic, size, operands, pop, push, cost, handler, arguments)
+//
+//    name       - opcode name in PLCRuntimeInstructionSet
+//    opcode     - bytecode value
+//    mnemonic   - name printed by the disassembler
+//    size       - instruction size in bytes including the opcode
+//    operands   - layout of the operand bytes
+//    pop, push  - stack bytes taken and left by the instruction, in terms of t1 and t2 (size of the first and second
+//                 data type operand) and ptr (size of a pointer)
+//    cost       - cost class for the execution time analysis
+//    handler    - PLCMethods function executing the instruction
+//    arguments  - handler parameters: STACK (stack), PROGRAM (stack, program, prog_size, index),
+//                 MEMORY (stack, memory, program, prog_size, index) or RUNTIME (runtime) for the runtime services
+//
+// The 64-bit instructions have their own list, they are only available with USE_X64_OPS.
+
+enum PLCRuntimeOperandLayout {
+    OPERANDS_NONE = 0,      // No operands
+    OPERANDS_CONSTANT,      // Big endian value of the pushed type
+    OPERANDS_TYPE,          // u8 data type
+    OPERANDS_TYPE_TYPE,     // u8 data type, u8 data type
+    OPERANDS_ADDRESS,       // u16 memory address
+    OPERANDS_JUMP,          // u16 program address
+    OPERANDS_FRAME,         // u8 frame size
+    OPERANDS_TYPE_LOCAL,    // u8 data type, u8 frame offset
+};
+
+enum PLCRuntimeCostClass {
+    COST_STACK = 0,         // Constants and stack manipulation
+    COST_MEMORY,            // Load and move
+    COST_BIT,               // Bit get / set / read / write
+    COST_INTEGER,           // Add, subtract, negate, compare, convert, bitwise and logic
+    COST_MULTIPLY,          // Multiply
+    COST_DIVIDE,            // Divide and modulo
+    COST_MATH,              // Power, square root, sine, cosine
+    COST_JUMP,              // Jumps, returns and exit
+    COST_CALL,              // Calls
+    COST_STRING,            // Byte string search, compare, copy and conversion, the time grows with the length
+};
+
+#define STACK_EFFECT_ALL 0xFFFF // The instruction removes everything from the stack
+
+#define PLCRUNTIME_INSTRUCTION_SET(X) \
+    X(NOP,              0x00,  "NOP",              1,                     OPERANDS_NONE,       0,                 0,                 COST_STACK,     handle_NOP,              STACK) /* NOP - no operation */ \
+    X(type_pointer,     0x01,  "PUSH pointer",     1 + sizeof(MY_PTR_t),  OPERANDS_CONSTANT,   0,                 sizeof(MY_PTR_t),  COST_STACK,     PUSH_pointer,            PROGRAM) /* Pointer to a memory location */ \
+    X(type_bool,        0x02,  "PUSH boolean",     2,                     OPERANDS_CONSTANT,   0,                 1,                 COST_STACK,     PUSH_bool,               PROGRAM) /* Constant boolean value */ \
+    X(type_u8,          0x03,  "PUSH u8",          2,                     OPERANDS_CONSTANT,   0,                 1,                 COST_STACK,     push_u8,                 PROGRAM) /* Constant u8 value */ \
+    X(type_u16,         0x04,  "PUSH u16",         3,                     OPERANDS_CONSTANT,   0,                 2,                 COST_STACK,     push_u16,                PROGRAM) /* Constant u16 value */ \
+    X(type_u32,         0x05,  "PUSH u32",         5,                     OPERANDS_CONSTANT,   0,                 4,                 COST_STACK,     push_u32,                PROGRAM) /* Constant u32 value */ \
+    X(type_i8,          0x07,  "PUSH i8",          2,                     OPERANDS_CONSTANT,   0,                 1,                 COST_STACK,     push_i8,                 PROGRAM) /* Constant i8 value */ \
+    X(type_i16,         0x08,  "PUSH i16",         3,                     OPERANDS_CONSTANT,   0,                 2,                 COST_STACK,     push_i16,                PROGRAM) /* Constant i16 value */ \
+    X(type_i32,         0x09,  "PUSH i32",         5,                     OPERANDS_CONSTANT,   0,                 4,                 COST_STACK,     push_i32,                PROGRAM) /* Constant i32 value */ \
+    X(type_f32,         0x0B,  "PUSH f32",         5,                     OPERANDS_CONSTANT,   0,                 4,                 COST_STACK,     push_f32,                PROGRAM) /* Constant f32 value */ \
+    X(CVT,              0x10,  "CVT",              3,                     OPERANDS_TYPE_TYPE,  t1,                t2,                COST_INTEGER,   CVT,                     PROGRAM) /* Convert value from one type to another. Example: [ u8 CVT, u8 source_type, u8 destination_type ] */ \
+    X(LOAD,             0x11,  "LOAD",             2,                     OPERANDS_TYPE,       ptr,               t1,                COST_MEMORY,    LOAD,                    MEMORY) /* Load value from memory to stack, the pointer is taken from the stack. Example: [ u8 LOAD, u8 type ] */ \
+    X(MOVE,             0x12,  "MOVE",             2,                     OPERANDS_TYPE,       ptr + t1,          0,                 COST_MEMORY,    MOVE,                    MEMORY) /* Move value from stack to memory, the pointer is below the value. Example: [ u8 MOVE, u8 type ] */ \
+    X(MOVE_COPY,        0x13,  "MOVE_COPY",        2,                     OPERANDS_TYPE,       ptr + t1,          t1,                COST_MEMORY,    MOVE_COPY,               MEMORY) /* Move value from stack to memory and keep the value on the stack. Example: [ u8 MOVE_COPY, u8 type ] */ \
+    X(COPY,             0x14,  "COPY",             2,                     OPERANDS_TYPE,       t1,                2 * t1,            COST_STACK,     COPY,                    PROGRAM) /* Make a duplicate of the top of the stack */ \
+    X(SWAP,             0x15,  "SWAP",             3,                     OPERANDS_TYPE_TYPE,  t1 + t2,           t1 + t2,           COST_STACK,     SWAP,                    PROGRAM) /* Swap the top two values on the stack */ \
+    X(DROP,             0x16,  "DROP",             2,                     OPERANDS_TYPE,       t1,                0,                 COST_STACK,     DROP,                    PROGRAM) /* Remove the top of the stack */ \
+    X(CLEAR,            0x17,  "CLEAR",            1,                     OPERANDS_NONE,       STACK_EFFECT_ALL,  0,                 COST_STACK,     CLEAR,                   STACK) /* Clear the stack */ \
+    X(ENTER,            0x18,  "ENTER",            2,                     OPERANDS_FRAME,      0,                 0,                 COST_STACK,     handle_ENTER,            PROGRAM) /* Save the frame pointer on the frame stack and open a zeroed frame of u8 bytes for the local variables */ \
+    X(LEAVE,            0x19,  "LEAVE",            1,                     OPERANDS_NONE,       0,                 0,                 COST_STACK,     handle_LEAVE,            PROGRAM) /* Close the frame of this call and restore the saved frame pointer, before RET */ \
+    X(LOCAL_LOAD,       0x1A,  "LOCAL_LOAD",       3,                     OPERANDS_TYPE_LOCAL, 0,                 t1,                COST_MEMORY,    LOCAL_LOAD,              PROGRAM) /* Push the value at the u8 offset of the frame */ \
+    X(LOCAL_STORE,      0x1B,  "LOCAL_STORE",      3,                     OPERANDS_TYPE_LOCAL, t1,                0,                 COST_MEMORY,    LOCAL_STORE,             PROGRAM) /* Pop the value into the u8 offset of the frame */ \
+    X(ADD,              0x20,  "ADD",              2,                     OPERANDS_TYPE,       2 * t1,            t1,                COST_INTEGER,   handle_ADD,              PROGRAM) /* Addition, requires data type as argument */ \
+    X(SUB,              0x21,  "SUB",              2,                     OPERANDS_TYPE,       2 * t1,            t1,                COST_INTEGER,   handle_SUB,              PROGRAM) /* Subtraction, requires data type as argument */ \
+    X(MUL,              0x22,  "MUL",              2,                     OPERANDS_TYPE,       2 * t1,            t1,                COST_MULTIPLY,  handle_MUL,              PROGRAM) /* Multiplication, requires data type as argument */ \
+    X(DIV,              0x23,  "DIV",              2,                     OPERANDS_TYPE,       2 * t1,            t1,                COST_DIVIDE,    handle_DIV,              PROGRAM) /* Division, requires data type as argument */ \
+    X(MOD,              0x24,  "MOD",              2,                     OPERANDS_TYPE,       2 * t1,            t1,                COST_DIVIDE,    handle_MOD,              PROGRAM) /* Modulo, requires data type as argument */ \
+    X(POW,              0x25,  "POW",              2,                     OPERANDS_TYPE,       2 * t1,            t1,                COST_MATH,      handle_POW,              PROGRAM) /* Power for given type. Example: POW u8 */ \
+    X(SQRT,             0x26,  "SQRT",             2,                     OPERANDS_TYPE,       t1,                t1,                COST_MATH,      handle_SQRT,             PROGRAM) /* Square root */ \
+    X(NEG,              0x27,  "NEG",              2,                     OPERANDS_TYPE,       t1,                t1,                COST_INTEGER,   handle_NEG,              PROGRAM) /* Negate for signed types including f32 and f64 */ \
+    X(ABS,              0x28,  "ABS",              2,                     OPERANDS_TYPE,       t1,                t1,                COST_INTEGER,   handle_ABS,              PROGRAM) /* Absolute value for i8 */ \
+    X(SIN,              0x29,  "SIN",              2,                     OPERANDS_TYPE,       t1,                t1,                COST_MATH,      handle_SIN,              PROGRAM) /* Sine */ \
+    X(COS,              0x2A,  "COS",              2,                     OPERANDS_TYPE,       t1,                t1,                COST_MATH,      handle_COS,              PROGRAM) /* Cosine */ \
+    X(LUT_INTERP,       0x2B,  "LUT_INTERP",       2,                     OPERANDS_TYPE,       ptr + t1,          t1,                COST_MATH,      handle_LUT_INTERP,       MEMORY) /* Piecewise linear interpolation of the table at the pointer below x, i16 or f32. Example: [ u8 LUT_INTERP, u8 type ] */ \
+    X(STR_FIND_BYTE,    0x30,  "STR_FIND_BYTE",    1,                     OPERANDS_NONE,       ptr + 3,           2,                 COST_STRING,    handle_STR_FIND_BYTE,    MEMORY) /* Position of the u8 byte in the buffer (ptr, u16 length), 0xFFFF if not found */ \
+    X(STR_FIND,         0x31,  "STR_FIND",         1,                     OPERANDS_NONE,       2 * ptr + 4,       2,                 COST_STRING,    handle_STR_FIND,         MEMORY) /* Position of the pattern (ptr, u16 length) in the buffer (ptr, u16 length), 0xFFFF if not found */ \
+    X(STR_CMP,          0x32,  "STR_CMP",          1,                     OPERANDS_NONE,       2 * ptr + 2,       1,                 COST_STRING,    handle_STR_CMP,          MEMORY) /* Compare two byte strings (ptr a, ptr b, u16 length), pushes i8 -1, 0 or 1 */ \
+    X(STR_COPY_UNTIL,   0x33,  "STR_COPY_UNTIL",   1,                     OPERANDS_NONE,       2 * ptr + 3,       2,                 COST_STRING,    handle_STR_COPY_UNTIL,   MEMORY) /* Copy (ptr destination, ptr source, u16 length) up to the u8 delimiter, pushes the u16 count */ \
+    X(STR_ATOI,         0x34,  "STR_ATOI",         1,                     OPERANDS_NONE,       ptr + 2,           6,                 COST_STRING,    handle_STR_ATOI,         MEMORY) /* Parse a decimal number from (ptr, u16 length), pushes the i32 value and the u16 bytes used */ \
+    X(STR_ITOA,         0x35,  "STR_ITOA",         1,                     OPERANDS_NONE,       ptr + 6,           2,                 COST_STRING,    handle_STR_ITOA,         MEMORY) /* Write the i32 value as decimal text to (ptr, u16 length), pushes the u16 bytes written */ \
+    X(GET_X8_B0,        0x40,  "GET_X8_B0",        1,                     OPERANDS_NONE,       1,                 1,                 COST_BIT,       handle_GET_X8_B0,        STACK) /* Get the first bit of the 1 byte size value (x) */ \
+    X(GET_X8_B1,        0x41,  "GET_X8_B1",        1,                     OPERANDS_NONE,       1,                 1,                 COST_BIT,       handle_GET_X8_B1,        STACK) /* Get the second bit of the 1 byte size value (x) */ \
+    X(GET_X8_B2,        0x42,  "GET_X8_B2",        1,                     OPERANDS_NONE,       1,                 1,                 COST_BIT,       handle_GET_X8_B2,        STACK) /* Get the third bit of the 1 byte size value (x) */ \
+    X(GET_X8_B3,        0x43,  "GET_X8_B3",        1,                     OPERANDS_NONE,       1,                 1,                 COST_BIT,       handle_GET_X8_B3,        STACK) /* Get the fourth bit of the 1 byte size value (x) */ \
+    X(GET_X8_B4,        0x44,  "GET_X8_B4",        1,                     OPERANDS_NONE,       1,                 1,                 COST_BIT,       handle_GET_X8_B4,        STACK) /* Get the fifth bit of the 1 byte size value (x) */ \
+    X(GET_X8_B5,        0x45,  "GET_X8_B5",        1,                     OPERANDS_NONE,       1,                 1,                 COST_BIT,       handle_GET_X8_B5,        STACK) /* Get the sixth bit of the 1 byte size value (x) */ \
+    X(GET_X8_B6,        0x46,  "GET_X8_B6",        1,                     OPERANDS_NONE,       1,                 1,                 COST_BIT,       handle_GET_X8_B6,        STACK) /* Get the seventh bit of the 1 byte size value (x) */ \
+    X(GET_X8_B7,        0x47,  "GET_X8_B7",        1,                     OPERANDS_NONE,       1,                 1,                 COST_BIT,       handle_GET_X8_B7,        STACK) /* Get the eighth bit of the 1 byte size value (x) */ \
+    X(SET_X8_B0,        0x48,  "SET_X8_B0",        1,                     OPERANDS_NONE,       1,                 1,                 COST_BIT,       handle_SET_X8_B0,        STACK) /* Set the first bit of the 1 byte size value (x) */ \
+    X(SET_X8_B1,        0x49,  "SET_X8_B1",        1,                     OPERANDS_NONE,       1,                 1,                 COST_BIT,       handle_SET_X8_B1,        STACK) /* Set the second bit of the 1 byte size value (x) */ \
+    X(SET_X8_B2,        0x4A,  "SET_X8_B2",        1,                     OPERANDS_NONE,       1,                 1,                 COST_BIT,       handle_SET_X8_B2,        STACK) /* Set the third bit of the 1 byte size value (x) */ \
+    X(SET_X8_B3,        0x4B,  "SET_X8_B3",        1,                     OPERANDS_NONE,       1,                 1,                 COST_BIT,       handle_SET_X8_B3,        STACK) /* Set the fourth bit of the 1 byte size value (x) */ \
+    X(SET_X8_B4,        0x4C,  "SET_X8_B4",        1,                     OPERANDS_NONE,       1,                 1,                 COST_BIT,       handle_SET_X8_B4,        STACK) /* Set the fifth bit of the 1 byte size value (x) */ \
+    X(SET_X8_B5,        0x4D,  "SET_X8_B5",        1,                     OPERANDS_NONE,       1,                 1,                 COST_BIT,       handle_SET_X8_B5,        STACK) /* Set the sixth bit of the 1 byte size value (x) */ \
+    X(SET_X8_B6,        0x4E,  "SET_X8_B6",        1,                     OPERANDS_NONE,       1,                 1,                 COST_BIT,       handle_SET_X8_B6,        STACK) /* Set the seventh bit of the 1 byte size value (x) */ \
+    X(SET_X8_B7,        0x4F,  "SET_X8_B7",        1,                     OPERANDS_NONE,       1,                 1,                 COST_BIT,       handle_SET_X8_B7,        STACK) /* Set the eighth bit of the 1 byte size value (x) */ \
+    X(RSET_X8_B0,       0x50,  "RSET_X8_B0",       1,                     OPERANDS_NONE,       1,                 1,                 COST_BIT,       handle_RSET_X8_B0,       STACK) /* Reset the first bit of the 1 byte size value (x) */ \
+    X(RSET_X8_B1,       0x51,  "RSET_X8_B1",       1,                     OPERANDS_NONE,       1,                 1,                 COST_BIT,       handle_RSET_X8_B1,       STACK) /* Reset the second bit of the 1 byte size value (x) */ \
+    X(RSET_X8_B2,       0x52,  "RSET_X8_B2",       1,                     OPERANDS_NONE,       1,                 1,                 COST_BIT,       handle_RSET_X8_B2,       STACK) /* Reset the third bit of the 1 byte size value (x) */ \
+    X(RSET_X8_B3,       0x53,  "RSET_X8_B3",       1,                     OPERANDS_NONE,       1,                 1,                 COST_BIT,       handle_RSET_X8_B3,       STACK) /* Reset the fourth bit of the 1 byte size value (x) */ \
+    X(RSET_X8_B4,       0x54,  "RSET_X8_B4",       1,                     OPERANDS_NONE,       1,                 1,                 COST_BIT,       handle_RSET_X8_B4,       STACK) /* Reset the fifth bit of the 1 byte size value (x) */ \
+    X(RSET_X8_B5,       0x55,  "RSET_X8_B5",       1,                     OPERANDS_NONE,       1,                 1,                 COST_BIT,       handle_RSET_X8_B5,       STACK) /* Reset the sixth bit of the 1 byte size value (x) */ \
+    X(RSET_X8_B6,       0x56,  "RSET_X8_B6",       1,                     OPERANDS_NONE,       1,                 1,                 COST_BIT,       handle_RSET_X8_B6,       STACK) /* Reset the seventh bit of the 1 byte size value (x) */ \
+    X(RSET_X8_B7,       0x57,  "RSET_X8_B7",       1,                     OPERANDS_NONE,       1,                 1,                 COST_BIT,       handle_RSET_X8_B7,       STACK) /* Reset the eighth bit of the 1 byte size value (x) */ \
+    X(READ_X8_B0,       0x58,  "READ_X8_B0",       3,                     OPERANDS_ADDRESS,    0,                 1,                 COST_BIT,       handle_READ_X8_B0,       MEMORY) /* Read the first bit of the 1 byte at the given address (x) */ \
+    X(READ_X8_B1,       0x59,  "READ_X8_B1",       3,                     OPERANDS_ADDRESS,    0,                 1,                 COST_BIT,       handle_READ_X8_B1,       MEMORY) /* Read the second bit of the 1 byte at the given address (x) */ \
+    X(READ_X8_B2,       0x5A,  "READ_X8_B2",       3,                     OPERANDS_ADDRESS,    0,                 1,                 COST_BIT,       handle_READ_X8_B2,       MEMORY) /* Read the third bit of the 1 byte at the given address (x) */ \
+    X(READ_X8_B3,       0x5B,  "READ_X8_B3",       3,                     OPERANDS_ADDRESS,    0,                 1,                 COST_BIT,       handle_READ_X8_B3,       MEMORY) /* Read the fourth bit of the 1 byte at the given address (x) */ \
+    X(READ_X8_B4,       0x5C,  "READ_X8_B4",       3,                     OPERANDS_ADDRESS,    0,                 1,                 COST_BIT,       handle_READ_X8_B4,       MEMORY) /* Read the fifth bit of the 1 byte at the given address (x) */ \
+    X(READ_X8_B5,       0x5D,  "READ_X8_B5",       3,                     OPERANDS_ADDRESS,    0,                 1,                 COST_BIT,       handle_READ_X8_B5,       MEMORY) /* Read the sixth bit of the 1 byte at the given address (x) */ \
+    X(READ_X8_B6,       0x5E,  "READ_X8_B6",       3,                     OPERANDS_ADDRESS,    0,                 1,                 COST_BIT,       handle_READ_X8_B6,       MEMORY) /* Read the seventh bit of the 1 byte at the given address (x) */ \
+    X(READ_X8_B7,       0x5F,  "READ_X8_B7",       3,                     OPERANDS_ADDRESS,    0,                 1,                 COST_BIT,       handle_READ_X8_B7,       MEMORY) /* Read the eighth bit of the 1 byte at the given address (x) */ \
+    X(WRITE_X8_B0,      0x60,  "WRITE_X8_B0",      3,                     OPERANDS_ADDRESS,    1,                 0,                 COST_BIT,       handle_WRITE_X8_B0,      MEMORY) /* Write the first bit of the 1 byte at the given address (x) */ \
+    X(WRITE_X8_B1,      0x61,  "WRITE_X8_B1",      3,                     OPERANDS_ADDRESS,    1,                 0,                 COST_BIT,       handle_WRITE_X8_B1,      MEMORY) /* Write the second bit of the 1 byte at the given address (x) */ \
+    X(WRITE_X8_B2,      0x62,  "WRITE_X8_B2",      3,                     OPERANDS_ADDRESS,    1,                 0,                 COST_BIT,       handle_WRITE_X8_B2,      MEMORY) /* Write the third bit of the 1 byte at the given address (x) */ \
+    X(WRITE_X8_B3,      0x63,  "WRITE_X8_B3",      3,                     OPERANDS_ADDRESS,    1,                 0,                 COST_BIT,       handle_WRITE_X8_B3,      MEMORY) /* Write the fourth bit of the 1 byte at the given address (x) */ \
+    X(WRITE_X8_B4,      0x64,  "WRITE_X8_B4",      3,                     OPERANDS_ADDRESS,    1,                 0,                 COST_BIT,       handle_WRITE_X8_B4,      MEMORY) /* Write the fifth bit of the 1 byte at the given address (x) */ \
+    X(WRITE_X8_B5,      0x65,  "WRITE_X8_B5",      3,                     OPERANDS_ADDRESS,    1,                 0,                 COST_BIT,       handle_WRITE_X8_B5,      MEMORY) /* Write the sixth bit of the 1 byte at the given address (x) */ \
+    X(WRITE_X8_B6,      0x66,  "WRITE_X8_B6",      3,                     OPERANDS_ADDRESS,    1,                 0,                 COST_BIT,       handle_WRITE_X8_B6,      MEMORY) /* Write the seventh bit of the 1 byte at the given address (x) */ \
+    X(WRITE_X8_B7,      0x67,  "WRITE_X8_B7",      3,                     OPERANDS_ADDRESS,    1,                 0,                 COST_BIT,       handle_WRITE_X8_B7,      MEMORY) /* Write the eighth bit of the 1 byte at the given address (x) */ \
+    X(WRITE_S_X8_B0,    0x68,  "WRITE_S_X8_B0",    3,                     OPERANDS_ADDRESS,    0,                 0,                 COST_BIT,       handle_WRITE_S_X8_B0,    MEMORY) /* Write the first bit of the 1 byte at the given address (x) to value 1 (SET) */ \
+    X(WRITE_S_X8_B1,    0x69,  "WRITE_S_X8_B1",    3,                     OPERANDS_ADDRESS,    0,                 0,                 COST_BIT,       handle_WRITE_S_X8_B1,    MEMORY) /* Write the second bit of the 1 byte at the given address (x) to value 1 (SET) */ \
+    X(WRITE_S_X8_B2,    0x6A,  "WRITE_S_X8_B2",    3,                     OPERANDS_ADDRESS,    0,                 0,                 COST_BIT,       handle_WRITE_S_X8_B2,    MEMORY) /* Write the third bit of the 1 byte at the given address (x) to value 1 (SET) */ \
+    X(WRITE_S_X8_B3,    0x6B,  "WRITE_S_X8_B3",    3,                     OPERANDS_ADDRESS,    0,                 0,                 COST_BIT,       handle_WRITE_S_X8_B3,    MEMORY) /* Write the fourth bit of the 1 byte at the given address (x) to value 1 (SET) */ \
+    X(WRITE_S_X8_B4,    0x6C,  "WRITE_S_X8_B4",    3,                     OPERANDS_ADDRESS,    0,                 0,                 COST_BIT,       handle_WRITE_S_X8_B4,    MEMORY) /* Write the fifth bit of the 1 byte at the given address (x) to value 1 (SET) */ \
+    X(WRITE_S_X8_B5,    0x6D,  "WRITE_S_X8_B5",    3,                     OPERANDS_ADDRESS,    0,                 0,                 COST_BIT,       handle_WRITE_S_X8_B5,    MEMORY) /* Write the sixth bit of the 1 byte at the given address (x) to value 1 (SET) */ \
+    X(WRITE_S_X8_B6,    0x6E,  "WRITE_S_X8_B6",    3,                     OPERANDS_ADDRESS,    0,                 0,                 COST_BIT,       handle_WRITE_S_X8_B6,    MEMORY) /* Write the seventh bit of the 1 byte at the given address (x) to value 1 (SET) */ \
+    X(WRITE_S_X8_B7,    0x6F,  "WRITE_S_X8_B7",    3,                     OPERANDS_ADDRESS,    0,                 0,                 COST_BIT,       handle_WRITE_S_X8_B7,    MEMORY) /* Write the eighth bit of the 1 byte at the given address (x) to value 1 (SET) */ \
+    X(WRITE_R_X8_B0,    0x70,  "WRITE_R_X8_B0",    3,                     OPERANDS_ADDRESS,    0,                 0,                 COST_BIT,       handle_WRITE_R_X8_B0,    MEMORY) /* Write the first bit of the 1 byte at the given address (x) to value 0 (RESET) */ \
+    X(WRITE_R_X8_B1,    0x71,  "WRITE_R_X8_B1",    3,                     OPERANDS_ADDRESS,    0,                 0,                 COST_BIT,       handle_WRITE_R_X8_B1,    MEMORY) /* Write the second bit of the 1 byte at the given address (x) to value 0 (RESET) */ \
+    X(WRITE_R_X8_B2,    0x72,  "WRITE_R_X8_B2",    3,                     OPERANDS_ADDRESS,    0,                 0,                 COST_BIT,       handle_WRITE_R_X8_B2,    MEMORY) /* Write the third bit of the 1 byte at the given address (x) to value 0 (RESET) */ \
+    X(WRITE_R_X8_B3,    0x73,  "WRITE_R_X8_B3",    3,                     OPERANDS_ADDRESS,    0,                 0,                 COST_BIT,       handle_WRITE_R_X8_B3,    MEMORY) /* Write the fourth bit of the 1 byte at the given address (x) to value 0 (RESET) */ \
+    X(WRITE_R_X8_B4,    0x74,  "WRITE_R_X8_B4",    3,                     OPERANDS_ADDRESS,    0,                 0,                 COST_BIT,       handle_WRITE_R_X8_B4,    MEMORY) /* Write the fifth bit of the 1 byte at the given address (x) to value 0 (RESET) */ \
+    X(WRITE_R_X8_B5,    0x75,  "WRITE_R_X8_B5",    3,                     OPERANDS_ADDRESS,    0,                 0,                 COST_BIT,       handle_WRITE_R_X8_B5,    MEMORY) /* Write the sixth bit of the 1 byte at the given address (x) to value 0 (RESET) */ \
+    X(WRITE_R_X8_B6,    0x76,  "WRITE_R_X8_B6",    3,                     OPERANDS_ADDRESS,    0,                 0,                 COST_BIT,       handle_WRITE_R_X8_B6,    MEMORY) /* Write the seventh bit of the 1 byte at the given address (x) to value 0 (RESET) */ \
+    X(WRITE_R_X8_B7,    0x77,  "WRITE_R_X8_B7",    3,                     OPERANDS_ADDRESS,    0,                 0,                 COST_BIT,       handle_WRITE_R_X8_B7,    MEMORY) /* Write the eighth bit of the 1 byte at the given address (x) to value 0 (RESET) */ \
+    X(WRITE_INV_X8_B0,  0x78,  "WRITE_INV_X8_B0",  3,                     OPERANDS_ADDRESS,    0,                 0,                 COST_BIT,       handle_WRITE_INV_X8_B0,  MEMORY) /* Write the first bit of the 1 byte at the given address (x) to inverted value (INVERT) */ \
+    X(WRITE_INV_X8_B1,  0x79,  "WRITE_INV_X8_B1",  3,                     OPERANDS_ADDRESS,    0,                 0,                 COST_BIT,       handle_WRITE_INV_X8_B1,  MEMORY) /* Write the second bit of the 1 byte at the given address (x) to inverted value (INVERT) */ \
+    X(WRITE_INV_X8_B2,  0x7A,  "WRITE_INV_X8_B2",  3,                     OPERANDS_ADDRESS,    0,                 0,                 COST_BIT,       handle_WRITE_INV_X8_B2,  MEMORY) /* Write the third bit of the 1 byte at the given address (x) to inverted value (INVERT) */ \
+    X(WRITE_INV_X8_B3,  0x7B,  "WRITE_INV_X8_B3",  3,                     OPERANDS_ADDRESS,    0,                 0,                 COST_BIT,       handle_WRITE_INV_X8_B3,  MEMORY) /* Write the fourth bit of the 1 byte at the given address (x) to inverted value (INVERT) */ \
+    X(WRITE_INV_X8_B4,  0x7C,  "WRITE_INV_X8_B4",  3,                     OPERANDS_ADDRESS,    0,                 0,                 COST_BIT,       handle_WRITE_INV_X8_B4,  MEMORY) /* Write the fifth bit of the 1 byte at the given address (x) to inverted value (INVERT) */ \
+    X(WRITE_INV_X8_B5,  0x7D,  "WRITE_INV_X8_B5",  3,                     OPERANDS_ADDRESS,    0,                 0,                 COST_BIT,       handle_WRITE_INV_X8_B5,  MEMORY) /* Write the sixth bit of the 1 byte at the given address (x) to inverted value (INVERT) */ \
+    X(WRITE_INV_X8_B6,  0x7E,  "WRITE_INV_X8_B6",  3,                     OPERANDS_ADDRESS,    0,                 0,                 COST_BIT,       handle_WRITE_INV_X8_B6,  MEMORY) /* Write the seventh bit of the 1 byte at the given address (x) to inverted value (INVERT) */ \
+    X(WRITE_INV_X8_B7,  0x7F,  "WRITE_INV_X8_B7",  3,                     OPERANDS_ADDRESS,    0,                 0,                 COST_BIT,       handle_WRITE_INV_X8_B7,  MEMORY) /* Write the eighth bit of the 1 byte at the given address (x) to inverted value (INVERT) */ \
+    X(BW_AND_X8,        0xA0,  "BW_AND_X8",        1,                     OPERANDS_NONE,       2,                 1,                 COST_INTEGER,   handle_BW_AND_X8,        STACK) /* Bitwise AND for 1 byte size values (x, y) */ \
+    X(BW_AND_X16,       0xA1,  "BW_AND_X16",       1,                     OPERANDS_NONE,       4,                 2,                 COST_INTEGER,   handle_BW_AND_X16,       STACK) /* Bitwise AND for 2 byte size values (x, y) */ \
+    X(BW_AND_X32,       0xA2,  "BW_AND_X32",       1,                     OPERANDS_NONE,       8,                 4,                 COST_INTEGER,   handle_BW_AND_X32,       STACK) /* Bitwise AND for 4 byte size values (x, y) */ \
+    X(BW_OR_X8,         0xA4,  "BW_OR_X8",         1,                     OPERANDS_NONE,       2,                 1,                 COST_INTEGER,   handle_BW_OR_X8,         STACK) /* Bitwise OR for 1 byte size values (x, y) */ \
+    X(BW_OR_X16,        0xA5,  "BW_OR_X16",        1,                     OPERANDS_NONE,       4,                 2,                 COST_INTEGER,   handle_BW_OR_X16,        STACK) /* Bitwise OR for 2 byte size values (x, y) */ \
+    X(BW_OR_X32,        0xA6,  "BW_OR_X32",        1,                     OPERANDS_NONE,       8,                 4,                 COST_INTEGER,   handle_BW_OR_X32,        STACK) /* Bitwise OR for 4 byte size values (x, y) */ \
+    X(BW_XOR_X8,        0xA8,  "BW_XOR_X8",        1,                     OPERANDS_NONE,       2,                 1,                 COST_INTEGER,   handle_BW_XOR_X8,        STACK) /* Bitwise XOR for 1 byte size values (x, y) */ \
+    X(BW_XOR_X16,       0xA9,  "BW_XOR_X16",       1,                     OPERANDS_NONE,       4,                 2,                 COST_INTEGER,   handle_BW_XOR_X16,       STACK) /* Bitwise XOR for 2 byte size values (x, y) */ \
+    X(BW_XOR_X32,       0xAA,  "BW_XOR_X32",       1,                     OPERANDS_NONE,       8,                 4,                 COST_INTEGER,   handle_BW_XOR_X32,       STACK) /* Bitwise XOR for 4 byte size values (x, y) */ \
+    X(BW_NOT_X8,        0xAC,  "BW_NOT_X8",        1,                     OPERANDS_NONE,       1,                 1,                 COST_INTEGER,   handle_BW_NOT_X8,        STACK) /* Bitwise NOT for 1 byte size values (x) */ \
+    X(BW_NOT_X16,       0xAD,  "BW_NOT_X16",       1,                     OPERANDS_NONE,       2,                 2,                 COST_INTEGER,   handle_BW_NOT_X16,       STACK) /* Bitwise NOT for 2 byte size values (x) */ \
+    X(BW_NOT_X32,       0xAE,  "BW_NOT_X32",       1,                     OPERANDS_NONE,       4,                 4,                 COST_INTEGER,   handle_BW_NOT_X32,       STACK) /* Bitwise NOT for 4 byte size values (x) */ \
+    X(BW_LSHIFT_X8,     0xB0,  "BW_LSHIFT_X8",     1,                     OPERANDS_NONE,       2,                 1,                 COST_INTEGER,   handle_BW_LSHIFT_X8,     STACK) /* Bitwise left shift for 1 byte size values (x, y) */ \
+    X(BW_LSHIFT_X16,    0xB1,  "BW_LSHIFT_X16",    1,                     OPERANDS_NONE,       4,                 2,                 COST_INTEGER,   handle_BW_LSHIFT_X16,    STACK) /* Bitwise left shift for 2 byte size values (x, y) */ \
+    X(BW_LSHIFT_X32,    0xB2,  "BW_LSHIFT_X32",    1,                     OPERANDS_NONE,       8,                 4,                 COST_INTEGER,   handle_BW_LSHIFT_X32,    STACK) /* Bitwise left shift for 4 byte size values (x, y) */ \
+    X(BW_RSHIFT_X8,     0xB4,  "BW_RSHIFT_X8",     1,                     OPERANDS_NONE,       2,                 1,                 COST_INTEGER,   handle_BW_RSHIFT_X8,     STACK) /* Bitwise right shift for 1 byte size values (x, y) */ \
+    X(BW_RSHIFT_X16,    0xB5,  "BW_RSHIFT_X16",    1,                     OPERANDS_NONE,       4,                 2,                 COST_INTEGER,   handle_BW_RSHIFT_X16,    STACK) /* Bitwise right shift for 2 byte size values (x, y) */ \
+    X(BW_RSHIFT_X32,    0xB6,  "BW_RSHIFT_X32",    1,                     OPERANDS_NONE,       8,                 4,                 COST_INTEGER,   handle_BW_RSHIFT_X32,    STACK) /* Bitwise right shift for 4 byte size values (x, y) */ \
+    X(LOGIC_AND,        0xC0,  "LOGIC_AND",        1,                     OPERANDS_NONE,       2,                 1,                 COST_INTEGER,   LOGIC_AND,               STACK) /* Logical AND for bool (x, y) */ \
+    X(LOGIC_OR,         0xC1,  "LOGIC_OR",         1,                     OPERANDS_NONE,       2,                 1,                 COST_INTEGER,   LOGIC_OR,                STACK) /* Logical OR for bool (x, y) */ \
+    X(LOGIC_XOR,        0xC2,  "LOGIC_XOR",        1,                     OPERANDS_NONE,       2,                 1,                 COST_INTEGER,   LOGIC_XOR,               STACK) /* Logical XOR for bool (x, y) */ \
+    X(LOGIC_NOT,        0xC3,  "LOGIC_NOT",        1,                     OPERANDS_NONE,       1,                 1,                 COST_INTEGER,   LOGIC_NOT,               STACK) /* Logical NOT for bool (x) */ \
+    X(CMP_EQ,           0xD0,  "CMP_EQ",           2,                     OPERANDS_TYPE,       2 * t1,            1,                 COST_INTEGER,   handle_CMP_EQ,           PROGRAM) /* Compare  (x, y) */ \
+    X(CMP_NEQ,          0xD1,  "CMP_NEQ",          2,                     OPERANDS_TYPE,       2 * t1,            1,                 COST_INTEGER,   handle_CMP_NEQ,          PROGRAM) /* Compare  (x, y) */ \
+    X(CMP_GT,           0xD2,  "CMP_GT",           2,                     OPERANDS_TYPE,       2 * t1,            1,                 COST_INTEGER,   handle_CMP_GT,           PROGRAM) /* Compare  (x, y) */ \
+    X(CMP_LT,           0xD3,  "CMP_LT",           2,                     OPERANDS_TYPE,       2 * t1,            1,                 COST_INTEGER,   handle_CMP_LT,           PROGRAM) /* Compare  (x, y) */ \
+    X(CMP_GTE,          0xD4,  "CMP_GTE",          2,                     OPERANDS_TYPE,       2 * t1,            1,                 COST_INTEGER,   handle_CMP_GTE,          PROGRAM) /* Compare  (x, y) */ \
+    X(CMP_LTE,          0xD5,  "CMP_LTE",          2,                     OPERANDS_TYPE,       2 * t1,            1,                 COST_INTEGER,   handle_CMP_LTE,          PROGRAM) /* Compare  (x, y) */ \
+    X(JMP,              0xE0,  "JMP",              3,                     OPERANDS_JUMP,       0,                 0,                 COST_JUMP,      handle_JMP,              PROGRAM) /* Jump to the given address in the program bytecode (u16) */ \
+    X(JMP_IF,           0xE1,  "JMP_IF",           3,                     OPERANDS_JUMP,       1,                 0,                 COST_JUMP,      handle_JMP_IF,           PROGRAM) /* Jump to the given address in the program bytecode if the top of the stack is true (u16) */ \
+    X(JMP_IF_NOT,       0xE2,  "JMP_IF_NOT",       3,                     OPERANDS_JUMP,       1,                 0,                 COST_JUMP,      handle_JMP_IF_NOT,       PROGRAM) /* Jump to the given address in the program bytecode if the top of the stack is false (u16) */ \
+    X(CALL,             0xE3,  "CALL",             3,                     OPERANDS_JUMP,       0,                 0,                 COST_CALL,      handle_CALL,             PROGRAM) /* Call a function (u16) */ \
+    X(CALL_IF,          0xE4,  "CALL_IF",          3,                     OPERANDS_JUMP,       1,                 0,                 COST_CALL,      handle_CALL_IF,          PROGRAM) /* Call a function if the top of the stack is true (u16) */ \
+    X(CALL_IF_NOT,      0xE5,  "CALL_IF_NOT",      3,                     OPERANDS_JUMP,       1,                 0,                 COST_CALL,      handle_CALL_IF_NOT,      PROGRAM) /* Call a function if the top of the stack is false (u16) */ \
+    X(RET,              0xE6,  "RET",              1,                     OPERANDS_NONE,       0,                 0,                 COST_JUMP,      handle_RET,              PROGRAM) /* Return from a function call */ \
+    X(RET_IF,           0xE7,  "RET_IF",           1,                     OPERANDS_NONE,       1,                 0,                 COST_JUMP,      handle_RET_IF,           PROGRAM) /* Return from a function call if the top of the stack is true */ \
+    X(RET_IF_NOT,       0xE8,  "RET_IF_NOT",       1,                     OPERANDS_NONE,       1,                 0,                 COST_JUMP,      handle_RET_IF_NOT,       PROGRAM) /* Return from a function call if the top of the stack is false */ \
+    X(RECIPE,           0xF0,  "RECIPE",           1,                     OPERANDS_NONE,       1,                 0,                 COST_MEMORY,    handle_RECIPE,           RUNTIME) /* Apply the recipe with the u8 index from the stack at the start of the next scan */ \
+    X(SFC,              0xF1,  "SFC",              1,                     OPERANDS_NONE,       0,                 0,                 COST_CALL,      handle_SFC,              RUNTIME) /* Run the actions of the active chart steps and the transitions leaving them */ \
+    X(EXIT,             0xFF,  "EXIT",             1,                     OPERANDS_NONE,       0,                 0,                 COST_JUMP,      handle_EXIT_PROGRAM,     STACK) /* Exit the program. This will cease the execution of the program */
+
+#define PLCRUNTIME_INSTRUCTION_SET_X64(X) \
+    X(type_u64,         0x06,  "PUSH u64",         9,                     OPERANDS_CONSTANT,   0,                 8,                 COST_STACK,     push_u64,                PROGRAM) /* Constant u64 value */ \
+    X(type_i64,         0x0A,  "PUSH i64",         9,                     OPERANDS_CONSTANT,   0,                 8,                 COST_STACK,     push_i64,                PROGRAM) /* Constant i64 value */ \
+    X(type_f64,         0x0C,  "PUSH f64",         9,                     OPERANDS_CONSTANT,   0,                 8,                 COST_STACK,     push_f64,                PROGRAM) /* Constant f64 value */ \
+    X(BW_AND_X64,       0xA3,  "BW_AND_X64",       1,                     OPERANDS_NONE,       16,                8,                 COST_INTEGER,   handle_BW_AND_X64,       STACK) /* Bitwise AND for 8 byte size values (x, y) */ \
+    X(BW_OR_X64,        0xA7,  "BW_OR_X64",        1,                     OPERANDS_NONE,       16,                8,                 COST_INTEGER,   handle_BW_OR_X64,        STACK) /* Bitwise OR for 8 byte size values (x, y) */ \
+    X(BW_XOR_X64,       0xAB,  "BW_XOR_X64",       1,                     OPERANDS_NONE,       16,                8,                 COST_INTEGER,   handle_BW_XOR_X64,       STACK) /* Bitwise XOR for 8 byte size values (x, y) */ \
+    X(BW_NOT_X64,       0xAF,  "BW_NOT_X64",       1,                     OPERANDS_NONE,       8,                 8,                 COST_INTEGER,   handle_BW_NOT_X64,       STACK) /* Bitwise NOT for 8 byte size values (x) */ \
+    X(BW_LSHIFT_X64,    0xB3,  "BW_LSHIFT_X64",    1,                     OPERANDS_NONE,       16,                8,                 COST_INTEGER,   handle_BW_LSHIFT_X64,    STACK) /* Bitwise left shift for 8 byte size values (x, y) */ \
+    X(BW_RSHIFT_X64,    0xB7,  "BW_RSHIFT_X64",    1,                     OPERANDS_NONE,       16,                8,                 COST_INTEGER,   handle_BW_RSHIFT_X64,    STACK) /* Bitwise right shift for 8 byte size values (x, y) */
+
+// ################################################################################################
+// Instruction subset
+// ################################################################################################
+// A firmware for a single program can be built with only the instructions and data types the program uses, which makes
+// the firmware smaller and the dispatch switch dense. The assembler prints the list for a program (printInstructionSubset),
+// which is defined before the runtime is included:
+//    #define PLCRUNTIME_INSTRUCTION_SUBSET
+//    #define PLCRUNTIME_USE_type_u8 1          - instruction 'type_u8' (push u8 constant)
+//    #define PLCRUNTIME_USE_ADD 1              - instruction 'ADD'
+//    #define PLCRUNTIME_USE_DATA_type_u8 1     - data type operand 'u8'
+// Left out instructions are not dispatched and OPCODE_EXISTS reports them as unknown. Programs with left out instructions
+// or data type operands are rejected when they are loaded.
+
+#ifdef PLCRUNTIME_INSTRUCTION_SUBSET
+// PLCRUNTIME_SUBSET_DEFINED(MACRO) is 1 if MACRO is defined as 1 or as nothing, 0 otherwise
+#define PLCRUNTIME_SUBSET_PLACEHOLDER_ 0,
+#define PLCRUNTIME_SUBSET_PLACEHOLDER_1 0,
+#define PLCRUNTIME_SUBSET_SECOND(ignored, value, ...) value
+#define PLCRUNTIME_SUBSET_TEST(placeholder_or_junk) PLCRUNTIME_SUBSET_SECOND(placeholder_or_junk 1, 0, 0)
+#define PLCRUNTIME_SUBSET_PASTE(value) PLCRUNTIME_SUBSET_TEST(PLCRUNTIME_SUBSET_PLACEHOLDER_##value)
+#define PLCRUNTIME_SUBSET_DEFINED(macro) PLCRUNTIME_SUBSET_PASTE(macro)
+#define PLCRUNTIME_SUBSET_IF_0(...)
+#define PLCRUNTIME_SUBSET_IF_1(...) __VA_ARGS__
+#define PLCRUNTIME_SUBSET_IF_PASTE(value) PLCRUNTIME_SUBSET_IF_##value
+#define PLCRUNTIME_SUBSET_IF(value) PLCRUNTIME_SUBSET_IF_PASTE(value)
+#define PLCRUNTIME_OPCODE_USED(name) PLCRUNTIME_SUBSET_DEFINED(PLCRUNTIME_USE_##name)
+#define PLCRUNTIME_DATA_TYPE_USED(name) PLCRUNTIME_SUBSET_DEFINED(PLCRUNTIME_USE_DATA_##name)
+// PLCRUNTIME_IF_USED(name)(tokens) keeps the tokens only if the instruction is part of the build
+#define PLCRUNTIME_IF_USED(name) PLCRUNTIME_SUBSET_IF(PLCRUNTIME_OPCODE_USED(name))
+#else
+#define PLCRUNTIME_SUBSET_IF_1(...) __VA_ARGS__
+#define PLCRUNTIME_OPCODE_USED(name) 1
+#define PLCRUNTIME_DATA_TYPE_USED(name) 1
+#define PLCRUNTIME_IF_USED(name) PLCRUNTIME_SUBSET_IF_1
+#endif // PLCRUNTIME_INSTRUCTION_SUBSET
+
+/* TODO: */
+// MIN, MAX, MAP (x, in_min, in_max, out_min, out_max), CON (x, min, max), RAND, RAND1 (max), RAND2 (min, max),
+// LN, LOG10, LOG2, EXP, TAN, ASIN, ACOS, ATAN, ATAN2, SINH, COSH, TANH, ASINH, ACOSH, ATANH
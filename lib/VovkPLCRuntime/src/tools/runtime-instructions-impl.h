@@ -49,359 +49,30 @@ void logRuntimeErrorList() {
 
 
 bool OPCODE_EXISTS(PLCRuntimeInstructionSet opcode) {
+#define PLCRUNTIME_OPCODE_EXISTS(name, ...) PLCRUNTIME_IF_USED(name)(case name:)
     switch (opcode) {
-        case NOP:
-        case type_pointer:
-        case type_bool:
-        case type_u8:
-        case type_i8:
-        case type_u16:
-        case type_i16:
-        case type_u32:
-        case type_i32:
-        case type_f32:
+        PLCRUNTIME_INSTRUCTION_SET(PLCRUNTIME_OPCODE_EXISTS)
 #ifdef USE_X64_OPS
-        case type_u64:
-        case type_i64:
-        case type_f64:
+        PLCRUNTIME_INSTRUCTION_SET_X64(PLCRUNTIME_OPCODE_EXISTS)
 #endif
-        case CVT:
-        case LOAD:
-        case MOVE:
-        case MOVE_COPY:
-        case COPY:
-        case SWAP:
-        case DROP:
-        case CLEAR:
-        case ADD:
-        case SUB:
-        case MUL:
-        case DIV:
-        case MOD:
-        case POW:
-        case SQRT:
-        case NEG:
-        case ABS:
-        case SIN:
-        case COS:
-            /* TODO: */
-            // case MOD:
-            // case POW:
-            // case SQRT:
-            // case MIN:
-            // case MAX:
-            // case ABS:
-            // case MAP:
-            // case CON:
-            // case RAND:
-            // case RAND1:
-            // case RAND2:
-            // case LN:
-            // case LOG10:
-            // case LOG2:
-            // case EXP:
-            // case SIN:
-            // case COS:
-            // case TAN:
-            // case ASIN:
-            // case ACOS:
-            // case ATAN:
-            // case ATAN2:
-            // case SINH:
-            // case COSH:
-            // case TANH:
-            // case ASINH:
-            // case ACOSH:
-            // case ATANH:
-        case GET_X8_B0:
-        case GET_X8_B1:
-        case GET_X8_B2:
-        case GET_X8_B3:
-        case GET_X8_B4:
-        case GET_X8_B5:
-        case GET_X8_B6:
-        case GET_X8_B7:
-        case SET_X8_B0:
-        case SET_X8_B1:
-        case SET_X8_B2:
-        case SET_X8_B3:
-        case SET_X8_B4:
-        case SET_X8_B5:
-        case SET_X8_B6:
-        case SET_X8_B7:
-        case RSET_X8_B0:
-        case RSET_X8_B1:
-        case RSET_X8_B2:
-        case RSET_X8_B3:
-        case RSET_X8_B4:
-        case RSET_X8_B5:
-        case RSET_X8_B6:
-        case RSET_X8_B7:
-        case READ_X8_B0:
-        case READ_X8_B1:
-        case READ_X8_B2:
-        case READ_X8_B3:
-        case READ_X8_B4:
-        case READ_X8_B5:
-        case READ_X8_B6:
-        case READ_X8_B7:
-        case WRITE_X8_B0:
-        case WRITE_X8_B1:
-        case WRITE_X8_B2:
-        case WRITE_X8_B3:
-        case WRITE_X8_B4:
-        case WRITE_X8_B5:
-        case WRITE_X8_B6:
-        case WRITE_X8_B7:
-        case WRITE_S_X8_B0:
-        case WRITE_S_X8_B1:
-        case WRITE_S_X8_B2:
-        case WRITE_S_X8_B3:
-        case WRITE_S_X8_B4:
-        case WRITE_S_X8_B5:
-        case WRITE_S_X8_B6:
-        case WRITE_S_X8_B7:
-        case WRITE_R_X8_B0:
-        case WRITE_R_X8_B1:
-        case WRITE_R_X8_B2:
-        case WRITE_R_X8_B3:
-        case WRITE_R_X8_B4:
-        case WRITE_R_X8_B5:
-        case WRITE_R_X8_B6:
-        case WRITE_R_X8_B7:
-        case WRITE_INV_X8_B0:
-        case WRITE_INV_X8_B1:
-        case WRITE_INV_X8_B2:
-        case WRITE_INV_X8_B3:
-        case WRITE_INV_X8_B4:
-        case WRITE_INV_X8_B5:
-        case WRITE_INV_X8_B6:
-        case WRITE_INV_X8_B7:
-
-        case BW_AND_X8:
-        case BW_AND_X16:
-        case BW_AND_X32:
-        case BW_OR_X8:
-        case BW_OR_X16:
-        case BW_OR_X32:
-        case BW_XOR_X8:
-        case BW_XOR_X16:
-        case BW_XOR_X32:
-        case BW_NOT_X8:
-        case BW_NOT_X16:
-        case BW_NOT_X32:
-        case BW_LSHIFT_X8:
-        case BW_LSHIFT_X16:
-        case BW_LSHIFT_X32:
-        case BW_RSHIFT_X8:
-        case BW_RSHIFT_X16:
-        case BW_RSHIFT_X32:
-#ifdef USE_X64_OPS
-        case BW_AND_X64:
-        case BW_OR_X64:
-        case BW_XOR_X64:
-        case BW_NOT_X64:
-        case BW_LSHIFT_X64:
-        case BW_RSHIFT_X64:
-#endif
-        case LOGIC_AND:
-        case LOGIC_OR:
-        case LOGIC_XOR:
-        case LOGIC_NOT:
-        case CMP_EQ:
-        case CMP_NEQ:
-        case CMP_GT:
-        case CMP_LT:
-        case CMP_GTE:
-        case CMP_LTE:
-        case JMP:
-        case JMP_IF:
-        case JMP_IF_NOT:
-        case CALL:
-        case CALL_IF:
-        case CALL_IF_NOT:
-        case RET:
-        case RET_IF:
-        case RET_IF_NOT:
-        case EXIT: return true;
+            return true;
         default: break;
     }
+#undef PLCRUNTIME_OPCODE_EXISTS
     return false;
 }
 
 #ifdef __RUNTIME_DEBUG__
 const FSH* OPCODE_NAME(PLCRuntimeInstructionSet opcode) {
+#define PLCRUNTIME_OPCODE_NAME(name, opcode, mnemonic, ...) PLCRUNTIME_IF_USED(name)(case name: return F(mnemonic);)
     switch (opcode) {
-        case NOP: return F("NOP");
-        case type_pointer: return F("PUSH pointer");
-        case type_bool: return F("PUSH boolean");
-        case type_u8: return F("PUSH u8");
-        case type_i8: return F("PUSH i8");
-        case type_u16: return F("PUSH u16");
-        case type_i16: return F("PUSH i16");
-        case type_u32: return F("PUSH u32");
-        case type_i32: return F("PUSH i32");
-        case type_f32: return F("PUSH f32");
-#ifdef USE_X64_OPS
-        case type_u64: return F("PUSH u64");
-        case type_i64: return F("PUSH i64");
-        case type_f64: return F("PUSH f64");
-#endif
-        case CVT: return F("CVT");
-        case LOAD: return F("LOAD");
-        case MOVE: return F("MOVE");
-        case MOVE_COPY: return F("MOVE_COPY");
-        case COPY: return F("COPY");
-        case SWAP: return F("SWAP");
-        case DROP: return F("DROP");
-        case CLEAR: return F("CLEAR");
-        case ADD: return F("ADD");
-        case SUB: return F("SUB");
-        case MUL: return F("MUL");
-        case DIV: return F("DIV");
-        case MOD: return F("MOD");
-        case POW: return F("POW");
-        case SQRT: return F("SQRT");
-        case NEG: return F("NEG");
-        case ABS: return F("ABS");
-        case SIN: return F("SIN");
-        case COS: return F("COS");
-                /* TODO: */
-                // case MIN: return F("MIN");
-                // case MAX: return F("MAX");
-                // case MAP: return F("MAP");
-                // case CON: return F("CON");
-                // case RAND: return F("RAND");
-                // case RAND1: return F("RAND1");
-                // case RAND2: return F("RAND2");
-                // case LN: return F("LN");
-                // case LOG10: return F("LOG10");
-                // case LOG2: return F("LOG2");
-                // case EXP: return F("EXP");
-                // case TAN: return F("TAN");
-                // case ASIN: return F("ASIN");
-                // case ACOS: return F("ACOS");
-                // case ATAN: return F("ATAN");
-                // case ATAN2: return F("ATAN2");
-                // case SINH: return F("SINH");
-                // case COSH: return F("COSH");
-                // case TANH: return F("TANH");
-                // case ASINH: return F("ASINH");
-                // case ACOSH: return F("ACOSH");
-                // case ATANH: return F("ATANH");>
-        case GET_X8_B0: return F("GET_X8_B0");
-        case GET_X8_B1: return F("GET_X8_B1");
-        case GET_X8_B2: return F("GET_X8_B2");
-        case GET_X8_B3: return F("GET_X8_B3");
-        case GET_X8_B4: return F("GET_X8_B4");
-        case GET_X8_B5: return F("GET_X8_B5");
-        case GET_X8_B6: return F("GET_X8_B6");
-        case GET_X8_B7: return F("GET_X8_B7");
-        case SET_X8_B0: return F("SET_X8_B0");
-        case SET_X8_B1: return F("SET_X8_B1");
-        case SET_X8_B2: return F("SET_X8_B2");
-        case SET_X8_B3: return F("SET_X8_B3");
-        case SET_X8_B4: return F("SET_X8_B4");
-        case SET_X8_B5: return F("SET_X8_B5");
-        case SET_X8_B6: return F("SET_X8_B6");
-        case SET_X8_B7: return F("SET_X8_B7");
-        case RSET_X8_B0: return F("RSET_X8_B0");
-        case RSET_X8_B1: return F("RSET_X8_B1");
-        case RSET_X8_B2: return F("RSET_X8_B2");
-        case RSET_X8_B3: return F("RSET_X8_B3");
-        case RSET_X8_B4: return F("RSET_X8_B4");
-        case RSET_X8_B5: return F("RSET_X8_B5");
-        case RSET_X8_B6: return F("RSET_X8_B6");
-        case RSET_X8_B7: return F("RSET_X8_B7");
-        case READ_X8_B0: return F("READ_X8_B0");
-        case READ_X8_B1: return F("READ_X8_B1");
-        case READ_X8_B2: return F("READ_X8_B2");
-        case READ_X8_B3: return F("READ_X8_B3");
-        case READ_X8_B4: return F("READ_X8_B4");
-        case READ_X8_B5: return F("READ_X8_B5");
-        case READ_X8_B6: return F("READ_X8_B6");
-        case READ_X8_B7: return F("READ_X8_B7");
-        case WRITE_X8_B0: return F("WRITE_X8_B0");
-        case WRITE_X8_B1: return F("WRITE_X8_B1");
-        case WRITE_X8_B2: return F("WRITE_X8_B2");
-        case WRITE_X8_B3: return F("WRITE_X8_B3");
-        case WRITE_X8_B4: return F("WRITE_X8_B4");
-        case WRITE_X8_B5: return F("WRITE_X8_B5");
-        case WRITE_X8_B6: return F("WRITE_X8_B6");
-        case WRITE_X8_B7: return F("WRITE_X8_B7");
-        case WRITE_S_X8_B0: return F("WRITE_S_X8_B0");
-        case WRITE_S_X8_B1: return F("WRITE_S_X8_B1");
-        case WRITE_S_X8_B2: return F("WRITE_S_X8_B2");
-        case WRITE_S_X8_B3: return F("WRITE_S_X8_B3");
-        case WRITE_S_X8_B4: return F("WRITE_S_X8_B4");
-        case WRITE_S_X8_B5: return F("WRITE_S_X8_B5");
-        case WRITE_S_X8_B6: return F("WRITE_S_X8_B6");
-        case WRITE_S_X8_B7: return F("WRITE_S_X8_B7");
-        case WRITE_R_X8_B0: return F("WRITE_R_X8_B0");
-        case WRITE_R_X8_B1: return F("WRITE_R_X8_B1");
-        case WRITE_R_X8_B2: return F("WRITE_R_X8_B2");
-        case WRITE_R_X8_B3: return F("WRITE_R_X8_B3");
-        case WRITE_R_X8_B4: return F("WRITE_R_X8_B4");
-        case WRITE_R_X8_B5: return F("WRITE_R_X8_B5");
-        case WRITE_R_X8_B6: return F("WRITE_R_X8_B6");
-        case WRITE_R_X8_B7: return F("WRITE_R_X8_B7");
-        case WRITE_INV_X8_B0: return F("WRITE_INV_X8_B0");
-        case WRITE_INV_X8_B1: return F("WRITE_INV_X8_B1");
-        case WRITE_INV_X8_B2: return F("WRITE_INV_X8_B2");
-        case WRITE_INV_X8_B3: return F("WRITE_INV_X8_B3");
-        case WRITE_INV_X8_B4: return F("WRITE_INV_X8_B4");
-        case WRITE_INV_X8_B5: return F("WRITE_INV_X8_B5");
-        case WRITE_INV_X8_B6: return F("WRITE_INV_X8_B6");
-        case WRITE_INV_X8_B7: return F("WRITE_INV_X8_B7");
-
-        case BW_AND_X8: return F("BW_AND_X8");
-        case BW_AND_X16: return F("BW_AND_X16");
-        case BW_AND_X32: return F("BW_AND_X32");
-        case BW_OR_X8: return F("BW_OR_X8");
-        case BW_OR_X16: return F("BW_OR_X16");
-        case BW_OR_X32: return F("BW_OR_X32");
-        case BW_XOR_X8: return F("BW_XOR_X8");
-        case BW_XOR_X16: return F("BW_XOR_X16");
-        case BW_XOR_X32: return F("BW_XOR_X32");
-        case BW_NOT_X8: return F("BW_NOT_X8");
-        case BW_NOT_X16: return F("BW_NOT_X16");
-        case BW_NOT_X32: return F("BW_NOT_X32");
-        case BW_LSHIFT_X8: return F("BW_LSHIFT_X8");
-        case BW_LSHIFT_X16: return F("BW_LSHIFT_X16");
-        case BW_LSHIFT_X32: return F("BW_LSHIFT_X32");
-        case BW_RSHIFT_X8: return F("BW_RSHIFT_X8");
-        case BW_RSHIFT_X16: return F("BW_RSHIFT_X16");
-        case BW_RSHIFT_X32: return F("BW_RSHIFT_X32");
+        PLCRUNTIME_INSTRUCTION_SET(PLCRUNTIME_OPCODE_NAME)
 #ifdef USE_X64_OPS
-        case BW_AND_X64: return F("BW_AND_X64");
-        case BW_OR_X64: return F("BW_OR_X64");
-        case BW_XOR_X64: return F("BW_XOR_X64");
-        case BW_NOT_X64: return F("BW_NOT_X64");
-        case BW_LSHIFT_X64: return F("BW_LSHIFT_X64");
-        case BW_RSHIFT_X64: return F("BW_RSHIFT_X64");
+        PLCRUNTIME_INSTRUCTION_SET_X64(PLCRUNTIME_OPCODE_NAME)
 #endif
-        case LOGIC_AND: return F("LOGIC_AND");
-        case LOGIC_OR: return F("LOGIC_OR");
-        case LOGIC_XOR: return F("LOGIC_XOR");
-        case LOGIC_NOT: return F("LOGIC_NOT");
-        case CMP_EQ: return F("CMP_EQ");
-        case CMP_NEQ: return F("CMP_NEQ");
-        case CMP_GT: return F("CMP_GT");
-        case CMP_LT: return F("CMP_LT");
-        case CMP_GTE: return F("CMP_GTE");
-        case CMP_LTE: return F("CMP_LTE");
-        case JMP: return F("JMP");
-        case JMP_IF: return F("JMP_IF");
-        case JMP_IF_NOT: return F("JMP_IF_NOT");
-        case CALL: return F("CALL");
-        case CALL_IF: return F("CALL_IF");
-        case CALL_IF_NOT: return F("CALL_IF_NOT");
-        case RET: return F("RET");
-        case RET_IF: return F("RET_IF");
-        case RET_IF_NOT: return F("RET_IF_NOT");
-        case EXIT: return F("EXIT");
         default: break;
     }
+#undef PLCRUNTIME_OPCODE_NAME
     return F("UNKNOWN OPCODE");
 }
 #else
@@ -418,186 +89,108 @@ u8 OPCODE_SIZE(PLCRuntimeInstructionSet opcode) {
     //    NOP       = 1 + 0 = 1
     //    type_bool = 1 + 1 = 2
     //    type_i32  = 1 + 4 = 5
+#define PLCRUNTIME_OPCODE_SIZE(name, opcode, mnemonic, size, ...) case name: return size;
     switch (opcode) {
-        case NOP: return 1;
-        case type_pointer: return 1 + sizeof(MY_PTR_t);
-        case type_bool: return 2;
-        case type_u8: return 2;
-        case type_i8: return 2;
-        case type_u16: return 3;
-        case type_i16: return 3;
-        case type_u32: return 5;
-        case type_i32: return 5;
-        case type_f32: return 5;
+        PLCRUNTIME_INSTRUCTION_SET(PLCRUNTIME_OPCODE_SIZE)
 #ifdef USE_X64_OPS
-        case type_u64: return 9;
-        case type_i64: return 9;
-        case type_f64: return 9;
+        PLCRUNTIME_INSTRUCTION_SET_X64(PLCRUNTIME_OPCODE_SIZE)
 #endif
-        case CVT: return 3;
-        case LOAD: return 2;
-        case MOVE: return 2;
-        case MOVE_COPY: return 2;
-        case COPY: return 2;
-        case SWAP: return 3;
-        case DROP: return 2;
-        case CLEAR: return 1;
-        case ADD: return 2;
-        case SUB: return 2;
-        case MUL: return 2;
-        case DIV: return 2;
-        case MOD: return 2;
-        case POW: return 2;
-        case SQRT: return 2;
-        case NEG: return 2;
-        case ABS: return 2;
-        case SIN: return 2;
-        case COS: return 2;
-            // case MOD: return 2;
-            // case POW: return 2;
-            // case SQRT: return 2;
-            // case MIN: return 2;
-            // case MAX: return 2;
-            // case ABS: return 2;
-            // case MAP: return 2;
-            // case CON: return 2;
-            // case RAND: return 2;
-            // case RAND1: return 2;
-            // case RAND2: return 2;
-            // case LN: return 2;
-            // case LOG10: return 2;
-            // case LOG2: return 2;
-            // case EXP: return 2;
-            // case SIN: return 2;
-            // case COS: return 2;
-            // case TAN: return 2;
-            // case ASIN: return 2;
-            // case ACOS: return 2;
-            // case ATAN: return 2;
-            // case ATAN2: return 2;
-            // case SINH: return 2;
-            // case COSH: return 2;
-            // case TANH: return 2;
-            // case ASINH: return 2;
-            // case ACOSH: return 2;
-            // case ATANH: return 2;
+        default: break;
+    }
+#undef PLCRUNTIME_OPCODE_SIZE
+    return 0;
+}
 
-        case GET_X8_B0:
-        case GET_X8_B1:
-        case GET_X8_B2:
-        case GET_X8_B3:
-        case GET_X8_B4:
-        case GET_X8_B5:
-        case GET_X8_B6:
-        case GET_X8_B7:
-        case SET_X8_B0:
-        case SET_X8_B1:
-        case SET_X8_B2:
-        case SET_X8_B3:
-        case SET_X8_B4:
-        case SET_X8_B5:
-        case SET_X8_B6:
-        case SET_X8_B7:
-        case RSET_X8_B0:
-        case RSET_X8_B1:
-        case RSET_X8_B2:
-        case RSET_X8_B3:
-        case RSET_X8_B4:
-        case RSET_X8_B5:
-        case RSET_X8_B6:
-        case RSET_X8_B7: return 1;
-        case READ_X8_B0:
-        case READ_X8_B1:
-        case READ_X8_B2:
-        case READ_X8_B3:
-        case READ_X8_B4:
-        case READ_X8_B5:
-        case READ_X8_B6:
-        case READ_X8_B7:
-        case WRITE_X8_B0:
-        case WRITE_X8_B1:
-        case WRITE_X8_B2:
-        case WRITE_X8_B3:
-        case WRITE_X8_B4:
-        case WRITE_X8_B5:
-        case WRITE_X8_B6:
-        case WRITE_X8_B7:
-        case WRITE_S_X8_B0:
-        case WRITE_S_X8_B1:
-        case WRITE_S_X8_B2:
-        case WRITE_S_X8_B3:
-        case WRITE_S_X8_B4:
-        case WRITE_S_X8_B5:
-        case WRITE_S_X8_B6:
-        case WRITE_S_X8_B7:
-        case WRITE_R_X8_B0:
-        case WRITE_R_X8_B1:
-        case WRITE_R_X8_B2:
-        case WRITE_R_X8_B3:
-        case WRITE_R_X8_B4:
-        case WRITE_R_X8_B5:
-        case WRITE_R_X8_B6:
-        case WRITE_R_X8_B7:
-        case WRITE_INV_X8_B0:
-        case WRITE_INV_X8_B1:
-        case WRITE_INV_X8_B2:
-        case WRITE_INV_X8_B3:
-        case WRITE_INV_X8_B4:
-        case WRITE_INV_X8_B5:
-        case WRITE_INV_X8_B6:
-        case WRITE_INV_X8_B7: return 3;
+// Size of a value of the data type, 0 if the type is not valid
+u8 DATA_TYPE_SIZE(u8 type) {
+    if (type < type_pointer || type > type_f64) return 0;
+    u8 size = OPCODE_SIZE((PLCRuntimeInstructionSet) type);
+    return size > 0 ? size - 1 : 0;
+}
 
-        case BW_AND_X8:
-        case BW_AND_X16:
-        case BW_AND_X32:
-        case BW_OR_X8:
-        case BW_OR_X16:
-        case BW_OR_X32:
-        case BW_XOR_X8:
-        case BW_XOR_X16:
-        case BW_XOR_X32:
-        case BW_NOT_X8:
-        case BW_NOT_X16:
-        case BW_NOT_X32:
-        case BW_LSHIFT_X8:
-        case BW_LSHIFT_X16:
-        case BW_LSHIFT_X32:
-        case BW_RSHIFT_X8:
-        case BW_RSHIFT_X16:
-        case BW_RSHIFT_X32: return 1;
+PLCRuntimeOperandLayout OPCODE_OPERANDS(PLCRuntimeInstructionSet opcode) {
+#define PLCRUNTIME_OPCODE_OPERANDS(name, opcode, mnemonic, size, operands, ...) case name: return operands;
+    switch (opcode) {
+        PLCRUNTIME_INSTRUCTION_SET(PLCRUNTIME_OPCODE_OPERANDS)
 #ifdef USE_X64_OPS
-        case BW_AND_X64:
-        case BW_OR_X64:
-        case BW_XOR_X64:
-        case BW_NOT_X64:
-        case BW_LSHIFT_X64:
-        case BW_RSHIFT_X64: return 1;
+        PLCRUNTIME_INSTRUCTION_SET_X64(PLCRUNTIME_OPCODE_OPERANDS)
 #endif
-        case LOGIC_AND:
-        case LOGIC_OR:
-        case LOGIC_XOR:
-        case LOGIC_NOT: return 1;
-        case CMP_EQ:
-        case CMP_NEQ:
-        case CMP_GT:
-        case CMP_LT:
-        case CMP_GTE:
-        case CMP_LTE: return 2;
+        default: break;
+    }
+#undef PLCRUNTIME_OPCODE_OPERANDS
+    return OPERANDS_NONE;
+}
 
-        case JMP:
-        case JMP_IF:
-        case JMP_IF_NOT:
-        case CALL:
-        case CALL_IF:
-        case CALL_IF_NOT: return 3;
+PLCRuntimeCostClass OPCODE_COST_CLASS(PLCRuntimeInstructionSet opcode) {
+#define PLCRUNTIME_OPCODE_COST_CLASS(name, opcode, mnemonic, size, operands, pop, push, cost, ...) case name: return cost;
+    switch (opcode) {
+        PLCRUNTIME_INSTRUCTION_SET(PLCRUNTIME_OPCODE_COST_CLASS)
+#ifdef USE_X64_OPS
+        PLCRUNTIME_INSTRUCTION_SET_X64(PLCRUNTIME_OPCODE_COST_CLASS)
+#endif
+        default: break;
+    }
+#undef PLCRUNTIME_OPCODE_COST_CLASS
+    return COST_STACK;
+}
 
-        case RET:
-        case RET_IF:
-        case RET_IF_NOT:
-        case EXIT: return 1;
+// A data type can be used as an operand in this build
+bool DATA_TYPE_ENABLED(u8 type) {
+    if (DATA_TYPE_SIZE(type) == 0) return false;
+#define PLCRUNTIME_DATA_TYPE_ENABLED(name, ...) case name: return PLCRUNTIME_DATA_TYPE_USED(name);
+    switch (type) {
+        PLCRUNTIME_INSTRUCTION_SET(PLCRUNTIME_DATA_TYPE_ENABLED)
+#ifdef USE_X64_OPS
+        PLCRUNTIME_INSTRUCTION_SET_X64(PLCRUNTIME_DATA_TYPE_ENABLED)
+#endif
         default: break;
     }
-    return 0;
+#undef PLCRUNTIME_DATA_TYPE_ENABLED
+    return false;
+}
+
+// Checks that the program uses only the instructions and data types of this build
+RuntimeError INSTRUCTION_SUBSET_CHECK(const u8* program, u32 prog_size) {
+    u32 index = 0;
+    while (index < prog_size) {
+        PLCRuntimeInstructionSet opcode = (PLCRuntimeInstructionSet) program[index];
+        if (!OPCODE_EXISTS(opcode)) return UNKNOWN_INSTRUCTION;
+        u8 size = OPCODE_SIZE(opcode);
+        if (index + size > prog_size) return PROGRAM_POINTER_OUT_OF_BOUNDS;
+        PLCRuntimeOperandLayout operands = OPCODE_OPERANDS(opcode);
+        if ((operands == OPERANDS_TYPE || operands == OPERANDS_TYPE_TYPE || operands == OPERANDS_TYPE_LOCAL) && !DATA_TYPE_ENABLED(program[index + 1])) return INVALID_DATA_TYPE;
+        if (operands == OPERANDS_TYPE_TYPE && !DATA_TYPE_ENABLED(program[index + 2])) return INVALID_DATA_TYPE;
+        index += size;
+    }
+    return STATUS_SUCCESS;
+}
+
+// Number of stack bytes taken (pop) and left (push) by the instruction at code. CLEAR pops STACK_EFFECT_ALL.
+RuntimeError OPCODE_STACK_EFFECT(const u8* code, u16& pop, u16& push) {
+    PLCRuntimeInstructionSet opcode = (PLCRuntimeInstructionSet) code[0];
+    if (!OPCODE_EXISTS(opcode)) return UNKNOWN_INSTRUCTION;
+    PLCRuntimeOperandLayout operands = OPCODE_OPERANDS(opcode);
+    IGNORE_UNUSED u16 ptr = sizeof(MY_PTR_t);
+    IGNORE_UNUSED u16 t1 = 0;
+    IGNORE_UNUSED u16 t2 = 0;
+    if (operands == OPERANDS_TYPE || operands == OPERANDS_TYPE_TYPE || operands == OPERANDS_TYPE_LOCAL) {
+        t1 = DATA_TYPE_SIZE(code[1]);
+        if (t1 == 0) return INVALID_DATA_TYPE;
+    }
+    if (operands == OPERANDS_TYPE_TYPE) {
+        t2 = DATA_TYPE_SIZE(code[2]);
+        if (t2 == 0) return INVALID_DATA_TYPE;
+    }
+#define PLCRUNTIME_OPCODE_STACK_EFFECT(name, opcode, mnemonic, size, operands, pop_bytes, push_bytes, ...) case name: pop = pop_bytes; push = push_bytes; return STATUS_SUCCESS;
+    switch (opcode) {
+        PLCRUNTIME_INSTRUCTION_SET(PLCRUNTIME_OPCODE_STACK_EFFECT)
+#ifdef USE_X64_OPS
+        PLCRUNTIME_INSTRUCTION_SET_X64(PLCRUNTIME_OPCODE_STACK_EFFECT)
+#endif
+        default: break;
+    }
+#undef PLCRUNTIME_OPCODE_STACK_EFFECT
+    return UNKNOWN_INSTRUCTION;
 }
 
 
@@ -22,6 +22,7 @@
 #pragma once
 
 #include "runtime-tools.h"
+#include "runtime-instruction-table.h"
 
 enum RuntimeError {
     STATUS_SUCCESS = 0,
@@ -48,6 +49,9 @@ enum RuntimeError {
     EXECUTION_TIMEOUT,
     MEMORY_ACCESS_ERROR,
     PROGRAM_CYCLE_LIMIT_EXCEEDED,
+    PROGRAM_READ_ONLY,
+    FRAME_UNDERFLOW,
+    FRAME_NOT_CLOSED,
 };
 
 #ifdef __RUNTIME_DEBUG__
@@ -76,6 +80,9 @@ const char* const RuntimeErrorNames [] PROGMEM = {
     STRINGIFY(EXECUTION_TIMEOUT),
     STRINGIFY(MEMORY_ACCESS_ERROR),
     STRINGIFY(PROGRAM_CYCLE_LIMIT_EXCEEDED),
+    STRINGIFY(PROGRAM_READ_ONLY),
+    STRINGIFY(FRAME_UNDERFLOW),
+    STRINGIFY(FRAME_NOT_CLOSED),
 };
 
 const char* RUNTIME_ERROR_NAME(RuntimeError error);
@@ -109,207 +116,24 @@ enum PLCRuntimeMemoryLocation {
     MEMORY = 0x02,      // MEMORY - internal memory location
 };
 
-// Instruction set:
+// Instruction set, generated from the instruction table
+#define PLCRUNTIME_INSTRUCTION_ENUM(name, opcode, ...) name = opcode,
 enum PLCRuntimeInstructionSet {
-    NOP = 0x00,         // NOP - no operation
-
-    // Data types
-    type_pointer,       // Pointer to a memory location
-    type_bool,          // Constant boolean value
-    type_u8,            // Constant u8 value
-    type_u16,           // Constant i8 value
-    type_u32,           // Constant u16 integer value
-    type_u64,           // Constant i16 integer value
-    type_i8,            // Constant u32 integer value
-    type_i16,           // Constant i32 integer value
-    type_i32,           // Constant u64 integer value
-    type_i64,           // Constant i64 integer value
-    type_f32,           // Constant f32 value
-    type_f64,           // Constant f64 value
-
-    CVT = 0x10,         // Convert value from one type to another. Example: [ u8 CVT, u8 source_type, u8 destination_type ]
-    LOAD,               // Load value from memory to stack. Example: [ u8 LOAD, u8 type, u16 address ]
-    MOVE,               // Move value from stack to memory. Example: [ u8 MOVE, u8 type, u16 address ]
-    MOVE_COPY,          // Move value from stack to memory and keep the value on the stack. Example: [ u8 MOVE_COPY, u8 type, u16 address ]
-
-    COPY,               // Make a duplicate of the top of the stack
-    SWAP,               // Swap the top two values on the stack
-    DROP,               // Remove the top of the stack
-    CLEAR,              // Clear the stack
-
-    // Arithmetic operations
-    ADD = 0x20,         // Addition, requires data type as argument
-    SUB,                // Subtraction, requires data type as argument
-    MUL,                // Multiplication, requires data type as argument
-    DIV,                // Division, requires data type as argument
-    MOD,                // Modulo, requires data type as argument
-    POW,                // Power for given type. Example: POW u8
-    SQRT,               // Square root
-    NEG,                // Negate for signed types including f32 and f64
-
-    /* TODO: */
-    // MIN,                // Minimum 
-    // MAX,                // Maximum 
-    ABS,                // Absolute value for i8
-    // MAP,                // Map  (x, in_min, in_max, out_min, out_max)
-    // CON,                // Constrain  (x, min, max)
-    // RAND,               // Random  (full range)
-    // RAND1,              // Random  (max)
-    // RAND2,              // Random  (min, max)
-    // LN,                 // Natural logarithm
-    // LOG10,              // Base 10 logarithm
-    // LOG2,               // Base 2 logarithm for f32
-    // EXP,                // Exponential
-    SIN,                // Sine
-    COS,                // Cosine
-    // TAN,                // Tangent
-    // ASIN,               // Arc sine
-    // ACOS,               // Arc cosine
-    // ATAN,               // Arc tangent
-    // ATAN2,              // Arc tangent 2
-    // SINH,               // Hyperbolic sine
-    // COSH,               // Hyperbolic cosine
-    // TANH,               // Hyperbolic tangent
-    // ASINH,              // Hyperbolic arc sine
-    // ACOSH,              // Hyperbolic arc cosine
-    // ATANH,              // Hyperbolic arc tangent
-
-    // Bit operations (PLC specific for simpler bytecode generation)
-    GET_X8_B0 = 0x40,   // Get the first bit of the 1 byte size value (x)
-    GET_X8_B1,          // Get the second bit of the 1 byte size value (x)
-    GET_X8_B2,          // Get the third bit of the 1 byte size value (x)
-    GET_X8_B3,          // Get the fourth bit of the 1 byte size value (x)
-    GET_X8_B4,          // Get the fifth bit of the 1 byte size value (x)
-    GET_X8_B5,          // Get the sixth bit of the 1 byte size value (x)
-    GET_X8_B6,          // Get the seventh bit of the 1 byte size value (x)
-    GET_X8_B7,          // Get the eighth bit of the 1 byte size value (x)
-
-    SET_X8_B0,          // Set the first bit of the 1 byte size value (x)
-    SET_X8_B1,          // Set the second bit of the 1 byte size value (x)
-    SET_X8_B2,          // Set the third bit of the 1 byte size value (x)
-    SET_X8_B3,          // Set the fourth bit of the 1 byte size value (x)
-    SET_X8_B4,          // Set the fifth bit of the 1 byte size value (x)
-    SET_X8_B5,          // Set the sixth bit of the 1 byte size value (x)
-    SET_X8_B6,          // Set the seventh bit of the 1 byte size value (x)
-    SET_X8_B7,          // Set the eighth bit of the 1 byte size value (x)
-
-    RSET_X8_B0,         // Reset the first bit of the 1 byte size value (x)
-    RSET_X8_B1,         // Reset the second bit of the 1 byte size value (x)
-    RSET_X8_B2,         // Reset the third bit of the 1 byte size value (x)
-    RSET_X8_B3,         // Reset the fourth bit of the 1 byte size value (x)
-    RSET_X8_B4,         // Reset the fifth bit of the 1 byte size value (x)
-    RSET_X8_B5,         // Reset the sixth bit of the 1 byte size value (x)
-    RSET_X8_B6,         // Reset the seventh bit of the 1 byte size value (x)
-    RSET_X8_B7,         // Reset the eighth bit of the 1 byte size value (x)
-
-    READ_X8_B0,         // Read the first bit of the 1 byte at the given address (x)
-    READ_X8_B1,         // Read the second bit of the 1 byte at the given address (x)
-    READ_X8_B2,         // Read the third bit of the 1 byte at the given address (x)
-    READ_X8_B3,         // Read the fourth bit of the 1 byte at the given address (x)
-    READ_X8_B4,         // Read the fifth bit of the 1 byte at the given address (x)
-    READ_X8_B5,         // Read the sixth bit of the 1 byte at the given address (x)
-    READ_X8_B6,         // Read the seventh bit of the 1 byte at the given address (x)
-    READ_X8_B7,         // Read the eighth bit of the 1 byte at the given address (x)
-
-    WRITE_X8_B0,        // Write the first bit of the 1 byte at the given address (x)
-    WRITE_X8_B1,        // Write the second bit of the 1 byte at the given address (x)
-    WRITE_X8_B2,        // Write the third bit of the 1 byte at the given address (x)
-    WRITE_X8_B3,        // Write the fourth bit of the 1 byte at the given address (x)
-    WRITE_X8_B4,        // Write the fifth bit of the 1 byte at the given address (x)
-    WRITE_X8_B5,        // Write the sixth bit of the 1 byte at the given address (x)
-    WRITE_X8_B6,        // Write the seventh bit of the 1 byte at the given address (x)
-    WRITE_X8_B7,        // Write the eighth bit of the 1 byte at the given address (x)
-
-    WRITE_S_X8_B0,      // Write the first bit of the 1 byte at the given address (x) to value 1 (SET)
-    WRITE_S_X8_B1,      // Write the second bit of the 1 byte at the given address (x) to value 1 (SET)
-    WRITE_S_X8_B2,      // Write the third bit of the 1 byte at the given address (x) to value 1 (SET)
-    WRITE_S_X8_B3,      // Write the fourth bit of the 1 byte at the given address (x) to value 1 (SET)
-    WRITE_S_X8_B4,      // Write the fifth bit of the 1 byte at the given address (x) to value 1 (SET)
-    WRITE_S_X8_B5,      // Write the sixth bit of the 1 byte at the given address (x) to value 1 (SET)
-    WRITE_S_X8_B6,      // Write the seventh bit of the 1 byte at the given address (x) to value 1 (SET)
-    WRITE_S_X8_B7,      // Write the eighth bit of the 1 byte at the given address (x) to value 1 (SET)
-
-    WRITE_R_X8_B0,      // Write the first bit of the 1 byte at the given address (x) to value 0 (RESET)
-    WRITE_R_X8_B1,      // Write the second bit of the 1 byte at the given address (x) to value 0 (RESET)
-    WRITE_R_X8_B2,      // Write the third bit of the 1 byte at the given address (x) to value 0 (RESET)
-    WRITE_R_X8_B3,      // Write the fourth bit of the 1 byte at the given address (x) to value 0 (RESET)
-    WRITE_R_X8_B4,      // Write the fifth bit of the 1 byte at the given address (x) to value 0 (RESET)
-    WRITE_R_X8_B5,      // Write the sixth bit of the 1 byte at the given address (x) to value 0 (RESET)
-    WRITE_R_X8_B6,      // Write the seventh bit of the 1 byte at the given address (x) to value 0 (RESET)
-    WRITE_R_X8_B7,      // Write the eighth bit of the 1 byte at the given address (x) to value 0 (RESET)
-
-    WRITE_INV_X8_B0,    // Write the first bit of the 1 byte at the given address (x) to inverted value (INVERT)
-    WRITE_INV_X8_B1,    // Write the second bit of the 1 byte at the given address (x) to inverted value (INVERT)
-    WRITE_INV_X8_B2,    // Write the third bit of the 1 byte at the given address (x) to inverted value (INVERT)
-    WRITE_INV_X8_B3,    // Write the fourth bit of the 1 byte at the given address (x) to inverted value (INVERT)
-    WRITE_INV_X8_B4,    // Write the fifth bit of the 1 byte at the given address (x) to inverted value (INVERT)
-    WRITE_INV_X8_B5,    // Write the sixth bit of the 1 byte at the given address (x) to inverted value (INVERT)
-    WRITE_INV_X8_B6,    // Write the seventh bit of the 1 byte at the given address (x) to inverted value (INVERT)
-    WRITE_INV_X8_B7,    // Write the eighth bit of the 1 byte at the given address (x) to inverted value (INVERT)
-
-    // Bitwise operations
-    BW_AND_X8 = 0xA0,   // Bitwise AND for 1 byte size values (x, y)
-    BW_AND_X16,         // Bitwise AND for 2 byte size values (x, y)
-    BW_AND_X32,         // Bitwise AND for 4 byte size values (x, y)
-    BW_AND_X64,         // Bitwise AND for 8 byte size values (x, y)
-
-    BW_OR_X8,           // Bitwise OR for 1 byte size values (x, y)
-    BW_OR_X16,          // Bitwise OR for 2 byte size values (x, y)
-    BW_OR_X32,          // Bitwise OR for 4 byte size values (x, y)
-    BW_OR_X64,          // Bitwise OR for 8 byte size values (x, y)
-
-    BW_XOR_X8,          // Bitwise XOR for 1 byte size values (x, y)
-    BW_XOR_X16,         // Bitwise XOR for 2 byte size values (x, y)
-    BW_XOR_X32,         // Bitwise XOR for 4 byte size values (x, y)
-    BW_XOR_X64,         // Bitwise XOR for 8 byte size values (x, y)
-
-    BW_NOT_X8,          // Bitwise NOT for 1 byte size values (x)
-    BW_NOT_X16,         // Bitwise NOT for 2 byte size values (x)
-    BW_NOT_X32,         // Bitwise NOT for 4 byte size values (x)
-    BW_NOT_X64,         // Bitwise NOT for 8 byte size values (x)
-
-    BW_LSHIFT_X8,       // Bitwise left shift for 1 byte size values (x, y)
-    BW_LSHIFT_X16,      // Bitwise left shift for 2 byte size values (x, y)
-    BW_LSHIFT_X32,      // Bitwise left shift for 4 byte size values (x, y)
-    BW_LSHIFT_X64,      // Bitwise left shift for 8 byte size values (x, y)
-
-    BW_RSHIFT_X8,       // Bitwise right shift for 1 byte size values (x, y)
-    BW_RSHIFT_X16,      // Bitwise right shift for 2 byte size values (x, y)
-    BW_RSHIFT_X32,      // Bitwise right shift for 4 byte size values (x, y)
-    BW_RSHIFT_X64,      // Bitwise right shift for 8 byte size values (x, y)
-
-    // Logical operations
-    LOGIC_AND = 0xC0,   // Logical AND for bool (x, y)
-    LOGIC_OR,           // Logical OR for bool (x, y)
-    LOGIC_XOR,          // Logical XOR for bool (x, y)
-    LOGIC_NOT,          // Logical NOT for bool (x)
-
-    // Comparison operations
-    CMP_EQ = 0xD0,      // Compare  (x, y)
-    CMP_NEQ,            // Compare  (x, y)
-    CMP_GT,             // Compare  (x, y)
-    CMP_LT,             // Compare  (x, y)
-    CMP_GTE,            // Compare  (x, y)
-    CMP_LTE,            // Compare  (x, y)
-
-    // Control flow
-    JMP = 0xE0,         // Jump to the given address in the program bytecode (u16)
-    JMP_IF,             // Jump to the given address in the program bytecode if the top of the stack is true (u16)
-    JMP_IF_NOT,         // Jump to the given address in the program bytecode if the top of the stack is false (u16)
-    CALL,               // Call a function (u16)
-    CALL_IF,            // Call a function if the top of the stack is true (u16)
-    CALL_IF_NOT,        // Call a function if the top of the stack is false (u16)
-    RET,                // Return from a function call
-    RET_IF,             // Return from a function call if the top of the stack is true
-    RET_IF_NOT,         // Return from a function call if the top of the stack is false
-
-    EXIT = 0xFF         // Exit the program. This will cease the execution of the program and return an optional exit error code (u8)
+    PLCRUNTIME_INSTRUCTION_SET(PLCRUNTIME_INSTRUCTION_ENUM)
+    PLCRUNTIME_INSTRUCTION_SET_X64(PLCRUNTIME_INSTRUCTION_ENUM)
 };
+#undef PLCRUNTIME_INSTRUCTION_ENUM
 
 
 bool OPCODE_EXISTS(PLCRuntimeInstructionSet opcode);
 const FSH* OPCODE_NAME(PLCRuntimeInstructionSet opcode);
 u8 OPCODE_SIZE(PLCRuntimeInstructionSet opcode);
+u8 DATA_TYPE_SIZE(u8 type);
+PLCRuntimeOperandLayout OPCODE_OPERANDS(PLCRuntimeInstructionSet opcode);
+PLCRuntimeCostClass OPCODE_COST_CLASS(PLCRuntimeInstructionSet opcode);
+RuntimeError OPCODE_STACK_EFFECT(const u8* code, u16& pop, u16& push);
+bool DATA_TYPE_ENABLED(u8 type);
+RuntimeError INSTRUCTION_SUBSET_CHECK(const u8* program, u32 prog_size);
 void logRuntimeInstructionSet();
 
 
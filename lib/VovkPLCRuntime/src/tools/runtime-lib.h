@@ -23,8 +23,46 @@
 
 #ifdef __WASM__
 #define PLCRUNTIME_MAX_STACK_SIZE 1024
+#define PLCRUNTIME_MAX_FRAME_SIZE 4096
+#define PLCRUNTIME_MAX_FRAMES 256
+#ifdef PLCRUNTIME_PAGED_MEMORY
+#define PLCRUNTIME_MAX_MEMORY_SIZE 16777216
+#define PLCRUNTIME_PAGE_SIZE 256
+#define PLCRUNTIME_PAGE_TABLE_SIZE 256
+#define PLCRUNTIME_PAGE_POOL_SIZE 1024
+#define PLCRUNTIME_PAGE_TABLE_POOL_SIZE 64
+#else
 #define PLCRUNTIME_MAX_MEMORY_SIZE 104857
+#define PLCRUNTIME_REGISTER_ENGINE // Compiles to pointers into the flat memory
+#endif // PLCRUNTIME_PAGED_MEMORY
 #define PLCRUNTIME_MAX_PROGRAM_SIZE 104857
+#define PLCRUNTIME_PROFILER
+#define PLCRUNTIME_REGISTER_MAX_INSTRUCTIONS 16384
+#define PLCRUNTIME_REGISTER_MAX_BLOCKS 4096
+#define PLCRUNTIME_REGISTER_MAX_CONSTANTS 16384
+#define PLCRUNTIME_TREND_LOGGER
+#define PLCRUNTIME_TREND_MAX_TAGS 64
+#define PLCRUNTIME_TREND_BUFFER_SIZE 65536
+#define PLCRUNTIME_CAPTURE
+#define PLCRUNTIME_CAPTURE_MAX_TAGS 64
+#define PLCRUNTIME_CAPTURE_BUFFER_SIZE 65536
+#define PLCRUNTIME_ALARMS
+#define PLCRUNTIME_ALARM_MAX_COUNT 4096
+#define PLCRUNTIME_ALARM_QUEUE_SIZE 1024
+#define PLCRUNTIME_RECIPES
+#define PLCRUNTIME_RECIPE_MAX_COUNT 128
+#define PLCRUNTIME_RECIPE_POOL_SIZE 65536
+#define PLCRUNTIME_RECIPE_MAX_NAME 64
+#define PLCRUNTIME_TAGS
+#define PLCRUNTIME_TAG_MAX_COUNT 2048
+#define PLCRUNTIME_TAG_HASH_SIZE 4096
+#define PLCRUNTIME_MATH_CACHE
+#define PLCRUNTIME_MATH_CACHE_SIZE 256
+#define PLCRUNTIME_SFC
+#define PLCRUNTIME_SFC_MAX_STEPS 1024
+#define PLCRUNTIME_SFC_MAX_TRANSITIONS 2048
+#define PLCRUNTIME_COMM
+#define PLCRUNTIME_COMM_MAX_PORTS 4
 #endif // __WASM__
 
 #define PLCRUNTIME_NUM_OF_INPUTS 10
@@ -42,10 +80,25 @@
 #define PLCRUNTIME_MAX_STACK_SIZE 16
 #endif // PLCRUNTIME_MAX_STACK_SIZE
 
+// Bytes for the local variables of all nested calls (ENTER / LEAVE)
+#ifndef PLCRUNTIME_MAX_FRAME_SIZE
+#define PLCRUNTIME_MAX_FRAME_SIZE 32
+#endif // PLCRUNTIME_MAX_FRAME_SIZE
+
+// Frames that can be open at the same time (ENTER / LEAVE)
+#ifndef PLCRUNTIME_MAX_FRAMES
+#define PLCRUNTIME_MAX_FRAMES 8
+#endif // PLCRUNTIME_MAX_FRAMES
+
 #ifndef PLCRUNTIME_MAX_MEMORY_SIZE
 #define PLCRUNTIME_MAX_MEMORY_SIZE 64
 #endif // PLCRUNTIME_MAX_MEMORY_SIZE
 
+// Backward jumps and calls allowed in one scan before it is aborted as a runaway loop, 0 disables the guard
+#ifndef PLCRUNTIME_LOOP_LIMIT
+#define PLCRUNTIME_LOOP_LIMIT 10000
+#endif // PLCRUNTIME_LOOP_LIMIT
+
 #ifndef PLCRUNTIME_MAX_PROGRAM_SIZE
 #define PLCRUNTIME_MAX_PROGRAM_SIZE 1024
 #endif // PLCRUNTIME_MAX_PROGRAM_SIZE
@@ -63,6 +116,31 @@
 #include "stack/runtime-stack.h"
 #include "arithmetics/runtime-arithmetics.h"
 #include "runtime-program.h"
+#include "runtime-program-builder.h"
+#ifdef PLCRUNTIME_TREND_LOGGER
+#include "trend/runtime-trend.h"
+#endif // PLCRUNTIME_TREND_LOGGER
+#ifdef PLCRUNTIME_CAPTURE
+#include "capture/runtime-capture.h"
+#endif // PLCRUNTIME_CAPTURE
+#ifdef PLCRUNTIME_ALARMS
+#include "alarm/runtime-alarm.h"
+#endif // PLCRUNTIME_ALARMS
+#ifdef PLCRUNTIME_RECIPES
+#include "recipe/runtime-recipe.h"
+#endif // PLCRUNTIME_RECIPES
+#ifdef PLCRUNTIME_TAGS
+#include "tags/runtime-tags.h"
+#endif // PLCRUNTIME_TAGS
+#ifdef PLCRUNTIME_MATH_CACHE
+#include "mathcache/runtime-math-cache.h"
+#endif // PLCRUNTIME_MATH_CACHE
+#ifdef PLCRUNTIME_SFC
+#include "sfc/runtime-sfc.h"
+#endif // PLCRUNTIME_SFC
+#ifdef PLCRUNTIME_COMM
+#include "comm/runtime-comm.h"
+#endif // PLCRUNTIME_COMM
 
 #define SERIAL_TIMEOUT_RETURN if (serial_timeout) return;
 #define SERIAL_TIMEOUT_JOB(task) if (serial_timeout) { Serial.flush(); task; return; };
@@ -70,13 +148,51 @@
 class VovkPLCRuntime {
 private:
     bool started_up = false;
+    // Execute the instruction at index without the program bounds checks of step()
+    RuntimeError dispatch(u8* program, u32 prog_size, u32& index);
 public:
     const u32 input_offset = PLCRUNTIME_INPUT_OFFSET; // Output offset in memory
     const u32 output_offset = PLCRUNTIME_OUTPUT_OFFSET + PLCRUNTIME_INPUT_OFFSET; // Output offset in memory
 
     RuntimeStack stack = RuntimeStack(); // Active memory stack for PLC execution
+#ifdef PLCRUNTIME_PAGED_MEMORY
+    RuntimePagedMemory pages; // Sparse page table backing the PLC memory
+    plc_memory_t memory = &pages; // PLC memory to manipulate
+#else
     u8 memory[PLCRUNTIME_MAX_MEMORY_SIZE]; // PLC memory to manipulate
-    RuntimeProgram program = RuntimeProgram(); // Active PLC program
+#endif // PLCRUNTIME_PAGED_MEMORY
+    RuntimeProgram program; // Active PLC program, an own copy or an attached shared image
+#ifdef PLCRUNTIME_PROFILER
+    bool profiling = false; // Count into program.profile, off by default to keep the dispatch lean
+#endif // PLCRUNTIME_PROFILER
+#ifdef PLCRUNTIME_TREND_LOGGER
+    RuntimeTrendLogger trend; // Tag samples taken at the end of every scan
+#endif // PLCRUNTIME_TREND_LOGGER
+#ifdef PLCRUNTIME_CAPTURE
+    RuntimeCapture capture; // Triggered per scan tag capture
+#endif // PLCRUNTIME_CAPTURE
+#ifdef PLCRUNTIME_ALARMS
+    RuntimeAlarms alarms; // Alarm bit area diffing and event queue
+#endif // PLCRUNTIME_ALARMS
+#ifdef PLCRUNTIME_RECIPES
+    RuntimeRecipes recipes; // Named parameter blocks applied at the scan boundary
+#endif // PLCRUNTIME_RECIPES
+#ifdef PLCRUNTIME_TAGS
+    RuntimeTagTable tags; // Tag name hash to address lookup
+#endif // PLCRUNTIME_TAGS
+#ifdef PLCRUNTIME_MATH_CACHE
+    RuntimeMathCache math_cache; // Last input and result of every POW/SQRT/SIN/COS call site
+#endif // PLCRUNTIME_MATH_CACHE
+#ifdef PLCRUNTIME_SFC
+    RuntimeSFC sfc; // Sequential function chart run by the SFC instruction
+#endif // PLCRUNTIME_SFC
+#ifdef PLCRUNTIME_COMM
+    RuntimeComm comm; // Receive and transmit rings of the auxiliary ports in the memory
+#endif // PLCRUNTIME_COMM
+    RuntimeError fault = STATUS_SUCCESS; // First fault of the last deferred scan or loop guard abort (sticky until the next scan)
+    u32 fault_index = 0; // Program offset of the instruction that raised the fault
+    u32 loop_limit = PLCRUNTIME_LOOP_LIMIT; // Backward jumps and calls allowed per scan, 0 disables the guard
+    u32 loop_budget = PLCRUNTIME_LOOP_LIMIT; // Backward jumps and calls left in the current scan
 
     static void splash() {
         Serial.println();
@@ -108,29 +224,76 @@ public:
     }
 
     void formatMemory() {
+#ifdef PLCRUNTIME_PAGED_MEMORY
+        pages.clear();
+#else
         for (u32 i = 0; i < PLCRUNTIME_MAX_MEMORY_SIZE; i++) memory[i] = 0;
+#endif // PLCRUNTIME_PAGED_MEMORY
+    }
+
+#ifdef PLCRUNTIME_PROFILER
+    // Clear the execution counts of the program, those of the attached image for all runtimes sharing it
+    void clearProfile() {
+        if (program.profile) memset(program.profile, 0, PLCRUNTIME_MAX_PROGRAM_SIZE * sizeof(u32));
     }
+#endif // PLCRUNTIME_PROFILER
 
     VovkPLCRuntime() {}
 
+    // Reset the state that belongs to the previous program
+    void programChanged() {
+#ifdef PLCRUNTIME_PROFILER
+        if (program.image == nullptr) clearProfile(); // The counts of an image are cleared when it is loaded
+#endif // PLCRUNTIME_PROFILER
+#ifdef PLCRUNTIME_MATH_CACHE
+        math_cache.clear();
+        math_cache.enabled = false;
+#endif // PLCRUNTIME_MATH_CACHE
+#ifdef PLCRUNTIME_SFC
+        sfc.clear(); // The chart refers to the segments of the previous program
+#endif // PLCRUNTIME_SFC
+    }
+
     void loadProgramUnsafe(const u8* program, u32 prog_size) {
         if (!started_up) initialize();
         this->program.loadUnsafe(program, prog_size);
+        programChanged();
     }
 
     void loadProgram(const u8* program, u32 prog_size, u8 checksum) {
         if (!started_up) initialize();
         this->program.load(program, prog_size, checksum);
+        programChanged();
     }
 
-    // Clear the stack
+    // Run a program image shared with other runtimes instead of an own copy, returns an error code (0 on success)
+    RuntimeError attachProgram(RuntimeProgramImage& image) {
+        if (!started_up) initialize();
+        RuntimeError status = program.attach(image);
+        programChanged();
+        return status;
+    }
+
+    // Write the interval flags and the uptime into the system area of the memory
+    void updateSystemMemory();
+    // Prepare the memory for a new scan, called before the first instruction
+    void scanStart();
+    // Run the end of scan services after a successfully completed scan
+    void scanComplete();
+    // Clear the stack and refill the loop budget
     void clear();
-    // Clear the stack and reset the program line
+    // Clear the stack, reset the program line and refill the loop budget
     void clear(RuntimeProgram& program);
+    // Abort the scan of a runaway loop: record the pc and put the outputs into the safe (off) state
+    RuntimeError loopLimitExceeded(u32 pc);
     // Execute one PLC instruction at index, returns an error code (0 on success)
     RuntimeError step(u8* program, u32 prog_size, u32& index);
     // Execute the whole PLC program, returns an error code (0 on success)
     RuntimeError run(u8* program, u32 prog_size);
+    // Execute the segment at the program offset like a CALL until it returns, returns an error code (0 on success)
+    RuntimeError runSegment(u32 offset);
+    // Execute the whole PLC program with the fault check deferred to the basic block boundaries, returns an error code (0 on success)
+    RuntimeError runDeferred(u8* program, u32 prog_size);
     // Execute one PLC instruction, returns an error code (0 on success)
     RuntimeError step(RuntimeProgram& program);
     // Run/Continue the whole PLC program from where it left off, returns an error code (0 on success)
@@ -144,6 +307,12 @@ public:
         if (!started_up) initialize();
         return run(program.program, program.prog_size);
     }
+    // Run the whole PLC program from the beginning in deferred fault mode, returns an error code (0 on success)
+    RuntimeError runDeferred() {
+        if (!started_up) initialize();
+        clear();
+        return runDeferred(program.program, program.prog_size);
+    }
     // Run the whole PLC program from the beginning, returns an error code (0 on success)
     RuntimeError run() {
         if (!started_up) initialize();
@@ -166,7 +335,7 @@ public:
 
     void setInput(u32 index, byte value) {
         // memory.set(index + input_offset, value);
-        memory[index + input_offset] = value;
+        set_u8(memory, index + input_offset, value);
     }
 
     void setInputBit(u32 index, u8 bit, bool value) {
@@ -177,7 +346,7 @@ public:
         if (value) temp |= (1 << bit);
         else temp &= ~(1 << bit);
         // memory.set(index + input_offset, temp);
-        memory[index + input_offset] = temp;
+        set_u8(memory, index + input_offset, temp);
     }
 
 #ifndef __AVR__
@@ -221,7 +390,7 @@ public:
         if (value) temp |= (1 << bit);
         else temp &= ~(1 << bit);
         // memory.set(index, temp);
-        memory[index] = temp;
+        set_u8(memory, index, temp);
     }
 
     bool getBit(u32 index, u8 bit, bool& value) {
@@ -256,7 +425,7 @@ public:
         // Listen for input from [serial, ethernet, wifi, etc.]
 #ifdef PLCRUNTIME_SERIAL_ENABLED
             // If the serial port is available and the first character is not 'P' or 'M', skip the character
-        while (Serial.available() && Serial.peek() != 'R' && Serial.peek() != 'P' && Serial.peek() != 'M' && Serial.peek() != 'S') Serial.read();
+        while (Serial.available() && Serial.peek() != 'R' && Serial.peek() != 'P' && Serial.peek() != 'M' && Serial.peek() != 'S' && Serial.peek() != 'T' && Serial.peek() != 'C' && Serial.peek() != 'A' && Serial.peek() != 'N') Serial.read();
         if (Serial.available() > 1) {
             // Command syntax:
             // <command>[<size>][<data>]<checksum>
@@ -272,6 +441,18 @@ public:
             //  - Memory format:    'MF<u32><u32><u8><u8>' (address, size, value, checksum)
             //  - Source download:  'SD<u32><u8[]><u8>' (size, data, checksum) // Only available if PLCRUNTIME_SOURCE_ENABLED is defined
             //  - Source upload:    'SU<u32><u8>' (size, checksum) // Only available if PLCRUNTIME_SOURCE_ENABLED is defined
+            //  - Trend setup:      'TS<u8><{u32,u8}[]><u16><u8>' (tag count, tag address and type, interval, checksum) // Only available if PLCRUNTIME_TREND_LOGGER is defined
+            //  - Trend upload:     'TU<u8>' (checksum) // Only available if PLCRUNTIME_TREND_LOGGER is defined
+            //  - Capture setup:    'CS<u8><{u32,u8}[]><u16><u16><u8><u32><u8><u8[8]><u8>' (tag count, tag address and type, pre-trigger, post-trigger, trigger mode, trigger address, bit or data type, threshold, checksum) // Only available if PLCRUNTIME_CAPTURE is defined
+            //  - Capture upload:   'CU<u8>' (checksum) // Only available if PLCRUNTIME_CAPTURE is defined
+            //  - Alarm setup:      'AS<u32><u32><u16><u8>' (alarm address, acknowledge address, alarm count, checksum) // Only available if PLCRUNTIME_ALARMS is defined
+            //  - Alarm events:     'AE<u32><u8>' (first sequence, checksum) // Only available if PLCRUNTIME_ALARMS is defined
+            //  - Alarm acknowledge:'AA<u16><u8>' (alarm index or 0xFFFF for all, checksum) // Only available if PLCRUNTIME_ALARMS is defined
+            //  - Recipe download:  'RD<u8><char[]><u32><u16><u8[]><u8>' (name length, name, address, size, data, checksum) // Only available if PLCRUNTIME_RECIPES is defined
+            //  - Recipe apply:     'RA<u8><char[]><u8>' (name length, name, checksum) // Only available if PLCRUNTIME_RECIPES is defined
+            //  - Tag table load:   'NL<u16><{u32,u32,u8,u8}[]><u8>' (tag count, name hash, address, type and size, checksum) // Only available if PLCRUNTIME_TAGS is defined
+            //  - Tag find:         'NF<u8><char[]><u8>' (name length, name, checksum), prints the address, type and size // Only available if PLCRUNTIME_TAGS is defined
+            //  - Tag read:         'NR<u8><{u8,char[]}[]><u8>' (tag count, name length and name, checksum), prints the values // Only available if PLCRUNTIME_TAGS is defined
             // If the program is downloaded and the checksum is invalid, the runtime will restart
             u8 cmd[2] = { 0, 0 };
             u32 size = 0;
@@ -297,6 +478,18 @@ public:
             bool memory_format = cmd[0] == 'M' && cmd[1] == 'F';
             bool source_download = cmd[0] == 'S' && cmd[1] == 'D';
             bool source_upload = cmd[0] == 'S' && cmd[1] == 'U';
+            bool trend_setup = cmd[0] == 'T' && cmd[1] == 'S';
+            bool trend_upload = cmd[0] == 'T' && cmd[1] == 'U';
+            bool capture_setup = cmd[0] == 'C' && cmd[1] == 'S';
+            bool capture_upload = cmd[0] == 'C' && cmd[1] == 'U';
+            bool alarm_setup = cmd[0] == 'A' && cmd[1] == 'S';
+            bool alarm_events = cmd[0] == 'A' && cmd[1] == 'E';
+            bool alarm_acknowledge = cmd[0] == 'A' && cmd[1] == 'A';
+            bool recipe_download = cmd[0] == 'R' && cmd[1] == 'D';
+            bool recipe_apply = cmd[0] == 'R' && cmd[1] == 'A';
+            bool tag_load = cmd[0] == 'N' && cmd[1] == 'L';
+            bool tag_find = cmd[0] == 'N' && cmd[1] == 'F';
+            bool tag_read = cmd[0] == 'N' && cmd[1] == 'R';
 
             if (plc_reset) {
                 Serial.print(F("PLC RESET - "));
@@ -351,6 +544,7 @@ public:
                     return;
                 }
                 program.resetLine();
+                programChanged();
 
                 Serial.flush();
                 Serial.println(F("Complete"));
@@ -539,6 +733,508 @@ public:
 
                 Serial.flush();
                 Serial.println(F("Complete"));
+            } else if (trend_setup) {
+#ifdef PLCRUNTIME_TREND_LOGGER
+                Serial.print(F("TREND SETUP - "));
+                // Read the tag count
+                u8 count = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+                crc8_simple(checksum_calc, count);
+                if (count > PLCRUNTIME_TREND_MAX_TAGS) {
+                    Serial.println(F("Too many tags"));
+                    Serial.flush();
+                    return;
+                }
+
+                // Read the tags
+                u32 addresses[PLCRUNTIME_TREND_MAX_TAGS];
+                u8 types[PLCRUNTIME_TREND_MAX_TAGS];
+                for (u8 i = 0; i < count; i++) {
+                    address = 0;
+                    for (u8 j = 0; j < 4; j++) {
+                        u8 b = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+                        crc8_simple(checksum_calc, b);
+                        address = address << 8 | b;
+                    }
+                    addresses[i] = address;
+                    types[i] = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+                    crc8_simple(checksum_calc, types[i]);
+                }
+
+                // Read the interval
+                u16 interval = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+                crc8_simple(checksum_calc, (interval & 0xff));
+                interval = interval << 8 | serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+                crc8_simple(checksum_calc, (interval & 0xff));
+
+                // Read the checksum
+                checksum = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+
+                // Verify the checksum
+                if (checksum != checksum_calc) {
+                    Serial.println(F("Invalid checksum"));
+                    Serial.flush();
+                    return;
+                }
+
+                trend.clearTags();
+                for (u8 i = 0; i < count; i++) {
+                    if (trend.addTag(addresses[i], types[i])) {
+                        trend.clearTags();
+                        Serial.println(F("Invalid tag"));
+                        Serial.flush();
+                        return;
+                    }
+                }
+                trend.setInterval(interval);
+
+                Serial.flush();
+                Serial.println(F("Complete"));
+#else // PLCRUNTIME_TREND_LOGGER
+                Serial.println(F("TREND SETUP - Not available"));
+#endif // PLCRUNTIME_TREND_LOGGER
+            } else if (trend_upload) {
+#ifdef PLCRUNTIME_TREND_LOGGER
+                Serial.print(F("TREND UPLOAD - "));
+                // Read the checksum
+                checksum = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+
+                // Verify the checksum
+                if (checksum != checksum_calc) {
+                    Serial.println(F("Invalid checksum"));
+                    Serial.flush();
+                    return;
+                }
+
+                // Print the trend
+                trend.upload();
+
+                Serial.flush();
+                Serial.println(F("Complete"));
+#else // PLCRUNTIME_TREND_LOGGER
+                Serial.println(F("TREND UPLOAD - Not available"));
+#endif // PLCRUNTIME_TREND_LOGGER
+            } else if (capture_setup) {
+#ifdef PLCRUNTIME_CAPTURE
+                Serial.print(F("CAPTURE SETUP - "));
+                // Read the tag count
+                u8 count = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+                crc8_simple(checksum_calc, count);
+                if (count > PLCRUNTIME_CAPTURE_MAX_TAGS) {
+                    Serial.println(F("Too many tags"));
+                    Serial.flush();
+                    return;
+                }
+
+                // Read the tags
+                u32 addresses[PLCRUNTIME_CAPTURE_MAX_TAGS];
+                u8 types[PLCRUNTIME_CAPTURE_MAX_TAGS];
+                for (u8 i = 0; i < count; i++) {
+                    address = 0;
+                    for (u8 j = 0; j < 4; j++) {
+                        u8 b = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+                        crc8_simple(checksum_calc, b);
+                        address = address << 8 | b;
+                    }
+                    addresses[i] = address;
+                    types[i] = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+                    crc8_simple(checksum_calc, types[i]);
+                }
+
+                // Read the pre-trigger and post-trigger scan counts
+                u16 pre = 0;
+                u16 post = 0;
+                for (u8 j = 0; j < 2; j++) {
+                    u8 b = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+                    crc8_simple(checksum_calc, b);
+                    pre = pre << 8 | b;
+                }
+                for (u8 j = 0; j < 2; j++) {
+                    u8 b = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+                    crc8_simple(checksum_calc, b);
+                    post = post << 8 | b;
+                }
+
+                // Read the trigger
+                u8 mode = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+                crc8_simple(checksum_calc, mode);
+                address = 0;
+                for (u8 j = 0; j < 4; j++) {
+                    u8 b = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+                    crc8_simple(checksum_calc, b);
+                    address = address << 8 | b;
+                }
+                u8 parameter = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+                crc8_simple(checksum_calc, parameter);
+                u8 threshold[8];
+                for (u8 j = 0; j < 8; j++) {
+                    threshold[j] = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+                    crc8_simple(checksum_calc, threshold[j]);
+                }
+
+                // Read the checksum
+                checksum = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+
+                // Verify the checksum
+                if (checksum != checksum_calc) {
+                    Serial.println(F("Invalid checksum"));
+                    Serial.flush();
+                    return;
+                }
+
+                capture.clearTags();
+                for (u8 i = 0; i < count; i++) {
+                    if (capture.addTag(addresses[i], types[i])) {
+                        capture.clearTags();
+                        Serial.println(F("Invalid tag"));
+                        Serial.flush();
+                        return;
+                    }
+                }
+                if (capture.setTrigger(mode, address, parameter, threshold)) {
+                    Serial.println(F("Invalid trigger"));
+                    Serial.flush();
+                    return;
+                }
+                if (capture.arm(pre, post)) {
+                    Serial.println(F("Window too large"));
+                    Serial.flush();
+                    return;
+                }
+
+                Serial.flush();
+                Serial.println(F("Complete"));
+#else // PLCRUNTIME_CAPTURE
+                Serial.println(F("CAPTURE SETUP - Not available"));
+#endif // PLCRUNTIME_CAPTURE
+            } else if (capture_upload) {
+#ifdef PLCRUNTIME_CAPTURE
+                Serial.print(F("CAPTURE UPLOAD - "));
+                // Read the checksum
+                checksum = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+
+                // Verify the checksum
+                if (checksum != checksum_calc) {
+                    Serial.println(F("Invalid checksum"));
+                    Serial.flush();
+                    return;
+                }
+
+                // Print the capture
+                capture.upload();
+
+                Serial.flush();
+                Serial.println(F("Complete"));
+#else // PLCRUNTIME_CAPTURE
+                Serial.println(F("CAPTURE UPLOAD - Not available"));
+#endif // PLCRUNTIME_CAPTURE
+            } else if (alarm_setup) {
+#ifdef PLCRUNTIME_ALARMS
+                Serial.print(F("ALARM SETUP - "));
+                // Read the alarm area address
+                for (u8 i = 0; i < 4; i++) {
+                    u8 b = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+                    crc8_simple(checksum_calc, b);
+                    address = address << 8 | b;
+                }
+                // Read the acknowledge area address
+                u32 ack_address = 0;
+                for (u8 i = 0; i < 4; i++) {
+                    u8 b = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+                    crc8_simple(checksum_calc, b);
+                    ack_address = ack_address << 8 | b;
+                }
+                // Read the alarm count
+                u16 count = 0;
+                for (u8 i = 0; i < 2; i++) {
+                    u8 b = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+                    crc8_simple(checksum_calc, b);
+                    count = count << 8 | b;
+                }
+
+                // Read the checksum
+                checksum = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+
+                // Verify the checksum
+                if (checksum != checksum_calc) {
+                    Serial.println(F("Invalid checksum"));
+                    Serial.flush();
+                    return;
+                }
+
+                if (alarms.configure(address, ack_address, count)) {
+                    Serial.println(F("Invalid alarm area"));
+                    Serial.flush();
+                    return;
+                }
+
+                Serial.flush();
+                Serial.println(F("Complete"));
+#else // PLCRUNTIME_ALARMS
+                Serial.println(F("ALARM SETUP - Not available"));
+#endif // PLCRUNTIME_ALARMS
+            } else if (alarm_events) {
+#ifdef PLCRUNTIME_ALARMS
+                Serial.print(F("ALARM EVENTS - "));
+                // Read the first sequence
+                u32 from = 0;
+                for (u8 i = 0; i < 4; i++) {
+                    u8 b = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+                    crc8_simple(checksum_calc, b);
+                    from = from << 8 | b;
+                }
+
+                // Read the checksum
+                checksum = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+
+                // Verify the checksum
+                if (checksum != checksum_calc) {
+                    Serial.println(F("Invalid checksum"));
+                    Serial.flush();
+                    return;
+                }
+
+                // Print the events
+                alarms.upload(from);
+
+                Serial.flush();
+                Serial.println(F("Complete"));
+#else // PLCRUNTIME_ALARMS
+                Serial.println(F("ALARM EVENTS - Not available"));
+#endif // PLCRUNTIME_ALARMS
+            } else if (alarm_acknowledge) {
+#ifdef PLCRUNTIME_ALARMS
+                Serial.print(F("ALARM ACKNOWLEDGE - "));
+                // Read the alarm index
+                u16 alarm = 0;
+                for (u8 i = 0; i < 2; i++) {
+                    u8 b = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+                    crc8_simple(checksum_calc, b);
+                    alarm = alarm << 8 | b;
+                }
+
+                // Read the checksum
+                checksum = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+
+                // Verify the checksum
+                if (checksum != checksum_calc) {
+                    Serial.println(F("Invalid checksum"));
+                    Serial.flush();
+                    return;
+                }
+
+                if (alarm == 0xFFFF) alarms.acknowledgeAll(memory);
+                else if (alarms.acknowledge(memory, alarm)) {
+                    Serial.println(F("Invalid alarm"));
+                    Serial.flush();
+                    return;
+                }
+
+                Serial.flush();
+                Serial.println(F("Complete"));
+#else // PLCRUNTIME_ALARMS
+                Serial.println(F("ALARM ACKNOWLEDGE - Not available"));
+#endif // PLCRUNTIME_ALARMS
+            } else if (recipe_download || recipe_apply) {
+#ifdef PLCRUNTIME_RECIPES
+                Serial.print(recipe_download ? F("RECIPE DOWNLOAD - ") : F("RECIPE APPLY - "));
+                // Read the name
+                u8 name_length = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+                crc8_simple(checksum_calc, name_length);
+                if (name_length > PLCRUNTIME_RECIPE_MAX_NAME) {
+                    Serial.println(F("Name too long"));
+                    Serial.flush();
+                    return;
+                }
+                char name[PLCRUNTIME_RECIPE_MAX_NAME];
+                for (u8 i = 0; i < name_length; i++) {
+                    name[i] = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+                    crc8_simple(checksum_calc, name[i]);
+                }
+
+                if (recipe_download) {
+                    // Read the address and the size
+                    for (u8 i = 0; i < 4; i++) {
+                        u8 b = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+                        crc8_simple(checksum_calc, b);
+                        address = address << 8 | b;
+                    }
+                    for (u8 i = 0; i < 2; i++) {
+                        u8 b = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+                        crc8_simple(checksum_calc, b);
+                        size = size << 8 | b;
+                    }
+                    if (size > PLCRUNTIME_RECIPE_POOL_SIZE) {
+                        Serial.println(F("Recipe too large"));
+                        Serial.flush();
+                        return;
+                    }
+
+                    // Read the data
+                    data = new u8[size];
+                    for (u32 i = 0; i < size; i++) {
+                        data[i] = serialReadHexByteTimeout(); SERIAL_TIMEOUT_JOB(delete[] data);
+                        crc8_simple(checksum_calc, data[i]);
+                    }
+                }
+
+                // Read the checksum
+                checksum = serialReadHexByteTimeout(); SERIAL_TIMEOUT_JOB(delete[] data);
+
+                // Verify the checksum
+                if (checksum != checksum_calc) {
+                    delete[] data;
+                    Serial.println(F("Invalid checksum"));
+                    Serial.flush();
+                    return;
+                }
+
+                bool error = false;
+                if (recipe_download) {
+                    error = recipes.store(name, name_length, address, data, size);
+                    delete[] data;
+                } else error = recipes.request(recipes.find(name, name_length));
+                if (error) {
+                    Serial.println(recipe_download ? F("Invalid recipe") : F("Unknown recipe"));
+                    Serial.flush();
+                    return;
+                }
+
+                Serial.flush();
+                Serial.println(F("Complete"));
+#else // PLCRUNTIME_RECIPES
+                Serial.println(recipe_download ? F("RECIPE DOWNLOAD - Not available") : F("RECIPE APPLY - Not available"));
+#endif // PLCRUNTIME_RECIPES
+            } else if (tag_load) {
+#ifdef PLCRUNTIME_TAGS
+                Serial.print(F("TAG LOAD - "));
+                // Read the tag count
+                u16 count = 0;
+                for (u8 i = 0; i < 2; i++) {
+                    u8 b = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+                    crc8_simple(checksum_calc, b);
+                    count = count << 8 | b;
+                }
+                if (count > PLCRUNTIME_TAG_MAX_COUNT) {
+                    Serial.println(F("Too many tags"));
+                    Serial.flush();
+                    return;
+                }
+
+                // Read the tags
+                TagEntry* entries = new TagEntry[count > 0 ? count : 1];
+                for (u16 i = 0; i < count; i++) {
+                    u32 values[2] = { 0, 0 };
+                    for (u8 j = 0; j < 8; j++) {
+                        u8 b = serialReadHexByteTimeout(); SERIAL_TIMEOUT_JOB(delete[] entries);
+                        crc8_simple(checksum_calc, b);
+                        values[j / 4] = values[j / 4] << 8 | b;
+                    }
+                    entries[i].hash = values[0];
+                    entries[i].address = values[1];
+                    entries[i].type = serialReadHexByteTimeout(); SERIAL_TIMEOUT_JOB(delete[] entries);
+                    crc8_simple(checksum_calc, entries[i].type);
+                    entries[i].size = serialReadHexByteTimeout(); SERIAL_TIMEOUT_JOB(delete[] entries);
+                    crc8_simple(checksum_calc, entries[i].size);
+                }
+
+                // Read the checksum
+                checksum = serialReadHexByteTimeout(); SERIAL_TIMEOUT_JOB(delete[] entries);
+
+                // Verify the checksum
+                if (checksum != checksum_calc) {
+                    delete[] entries;
+                    Serial.println(F("Invalid checksum"));
+                    Serial.flush();
+                    return;
+                }
+
+                bool error = tags.load(entries, count);
+                delete[] entries;
+                if (error) {
+                    Serial.println(F("Invalid tag table"));
+                    Serial.flush();
+                    return;
+                }
+
+                Serial.flush();
+                Serial.println(F("Complete"));
+#else // PLCRUNTIME_TAGS
+                Serial.println(F("TAG LOAD - Not available"));
+#endif // PLCRUNTIME_TAGS
+            } else if (tag_find || tag_read) {
+#ifdef PLCRUNTIME_TAGS
+                Serial.print(tag_find ? F("TAG FIND - ") : F("TAG READ - "));
+                // Read the tag count, a find is a single tag
+                u8 count = 1;
+                if (tag_read) {
+                    count = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+                    crc8_simple(checksum_calc, count);
+                }
+
+                // Read the names, they are hashed while they are received
+                u32* hashes = new u32[count > 0 ? count : 1];
+                for (u8 i = 0; i < count; i++) {
+                    u8 length = serialReadHexByteTimeout(); SERIAL_TIMEOUT_JOB(delete[] hashes);
+                    crc8_simple(checksum_calc, length);
+                    hashes[i] = PLCRUNTIME_TAG_HASH_SEED;
+                    for (u8 j = 0; j < length; j++) {
+                        u8 c = serialReadHexByteTimeout(); SERIAL_TIMEOUT_JOB(delete[] hashes);
+                        crc8_simple(checksum_calc, c);
+                        hashes[i] = tagHashStep(hashes[i], c);
+                    }
+                }
+
+                // Read the checksum
+                checksum = serialReadHexByteTimeout(); SERIAL_TIMEOUT_JOB(delete[] hashes);
+
+                // Verify the checksum
+                if (checksum != checksum_calc) {
+                    delete[] hashes;
+                    Serial.println(F("Invalid checksum"));
+                    Serial.flush();
+                    return;
+                }
+
+                // Resolve all names before anything is printed
+                for (u8 i = 0; i < count; i++) {
+                    if (tags.find(hashes[i]) == nullptr) {
+                        delete[] hashes;
+                        Serial.println(F("Unknown tag"));
+                        Serial.flush();
+                        return;
+                    }
+                }
+
+                char c1, c2;
+                for (u8 i = 0; i < count; i++) {
+                    const TagEntry* tag = tags.find(hashes[i]);
+                    if (tag_find) {
+                        // Address, type and size
+                        u8 info[6] = { (u8) (tag->address >> 24), (u8) (tag->address >> 16), (u8) (tag->address >> 8), (u8) tag->address, tag->type, tag->size };
+                        for (u8 j = 0; j < 6; j++) {
+                            byteToHex(info[j], c1, c2);
+                            Serial.print(c1);
+                            Serial.print(c2);
+                        }
+                    } else {
+                        // Value bytes as stored in the memory, one group per tag
+                        for (u8 j = 0; j < tag->size; j++) {
+                            u8 byte = 0;
+                            get_u8(memory, tag->address + j, byte);
+                            byteToHex(byte, c1, c2);
+                            Serial.print(c1);
+                            Serial.print(c2);
+                        }
+                    }
+                    Serial.print(' ');
+                }
+                delete[] hashes;
+
+                Serial.flush();
+                Serial.println(F("Complete"));
+#else // PLCRUNTIME_TAGS
+                Serial.println(tag_find ? F("TAG FIND - Not available") : F("TAG READ - Not available"));
+#endif // PLCRUNTIME_TAGS
             } else if (source_download) {
                 Serial.println(F("SOURCE DOWNLOAD - Not implemented"));
             } else if (source_upload) {
@@ -562,11 +1258,13 @@ public:
 void VovkPLCRuntime::clear() {
     program.resetLine();
     stack.clear();
+    loop_budget = loop_limit; // A stepped run starts here, without scanStart()
 }
 // Clear the runtime stack and reset the program line
 void VovkPLCRuntime::clear(RuntimeProgram& program) {
     program.resetLine();
     stack.clear();
+    loop_budget = loop_limit;
 }
 
 // Print the stack
@@ -579,6 +1277,94 @@ RuntimeError VovkPLCRuntime::run(RuntimeProgram& program) { return run(program.p
 // Execute the whole PLC program, returns an erro code (0 on success)
 RuntimeError VovkPLCRuntime::run(u8* program, u32 prog_size) {
     if (!started_up) initialize();
+    scanStart();
+    u32 index = 0;
+    while (index < prog_size) {
+        RuntimeError status = step(program, prog_size, index);
+        if (status != STATUS_SUCCESS) {
+            if (status == PROGRAM_EXITED) {
+                scanComplete();
+                return STATUS_SUCCESS;
+            }
+            return status;
+        }
+    }
+    scanComplete();
+    return STATUS_SUCCESS;
+}
+
+// Execute the whole PLC program in deferred fault mode, returns an error code (0 on success)
+// The status of the instructions is not acted on one by one. The first fault of the scan is kept as a sticky fault
+// together with its program offset, and the instructions in between run on the safe values the stack and memory
+// accessors fall back to (a failed pop reads 0, a failed push or load is dropped). The sticky fault is only acted on at
+// the end of the basic block, i.e. after a flow control instruction (JMP/CALL/RET/EXIT, the top of the opcode space),
+// and at the end of the scan. Without the program bounds checks of step() the clean path costs one test per instruction.
+RuntimeError VovkPLCRuntime::runDeferred(u8* program, u32 prog_size) {
+    if (!started_up) initialize();
+    if (prog_size == 0) return EMPTY_PROGRAM;
+    scanStart();
+    RuntimeError first = STATUS_SUCCESS;
+    u32 first_index = 0;
+    u32 index = 0;
+    while (index < prog_size) {
+        u32 pc = index;
+        RuntimeError status = dispatch(program, prog_size, index);
+        if ((status | first) == STATUS_SUCCESS) continue;
+        // Only reached once the block has faulted
+        if (first == STATUS_SUCCESS) {
+            first = status;
+            first_index = pc;
+        }
+        if (program[pc] >= JMP) break;
+    }
+    if (first == PROGRAM_EXITED) first = STATUS_SUCCESS;
+    fault = first;
+    fault_index = first_index;
+    if (fault != STATUS_SUCCESS) return fault;
+    scanComplete();
+    return STATUS_SUCCESS;
+}
+
+RuntimeError VovkPLCRuntime::loopLimitExceeded(u32 pc) {
+    fault = PROGRAM_CYCLE_LIMIT_EXCEEDED;
+    fault_index = pc;
+    for (u32 i = 0; i < PLCRUNTIME_NUM_OF_OUTPUTS; i++) set_u8(memory, output_offset + i, 0);
+    return PROGRAM_CYCLE_LIMIT_EXCEEDED;
+}
+
+// Update the system memory, apply a pending recipe and fill the receive rings, so the whole scan sees a consistent
+// parameter set and input data
+void VovkPLCRuntime::scanStart() {
+    fault = STATUS_SUCCESS;
+    fault_index = 0;
+    loop_budget = loop_limit;
+    updateSystemMemory();
+#ifdef PLCRUNTIME_RECIPES
+    recipes.apply(memory);
+#endif // PLCRUNTIME_RECIPES
+#ifdef PLCRUNTIME_COMM
+    comm.fill(memory);
+#endif // PLCRUNTIME_COMM
+}
+
+// Run the end of scan services after a successfully completed scan
+void VovkPLCRuntime::scanComplete() {
+#ifdef PLCRUNTIME_TREND_LOGGER
+    trend.sample(memory);
+#endif // PLCRUNTIME_TREND_LOGGER
+#ifdef PLCRUNTIME_CAPTURE
+    capture.sample(memory);
+#endif // PLCRUNTIME_CAPTURE
+#ifdef PLCRUNTIME_ALARMS
+    alarms.scan(memory);
+#endif // PLCRUNTIME_ALARMS
+#ifdef PLCRUNTIME_COMM
+    comm.drain(memory);
+#endif // PLCRUNTIME_COMM
+}
+
+// Write the interval flags and the uptime into the system area of the memory
+void VovkPLCRuntime::updateSystemMemory() {
     IntervalGlobalLoopCheck();
     u8 state = 0;
     state = state << 1 | P_10s;
@@ -590,7 +1376,7 @@ RuntimeError VovkPLCRuntime::run(u8* program, u32 prog_size) {
     state = state << 1 | P_200ms;
     state = state << 1 | P_100ms;
     // memory.set(1, state); // u8 -> 1 byte
-    memory[1] = state;
+    set_u8(memory, 1, state);
     state = 0;
     state = state << 1 | P_2hr;
     state = state << 1 | P_1hr;
@@ -601,7 +1387,7 @@ RuntimeError VovkPLCRuntime::run(u8* program, u32 prog_size) {
     state = state << 1 | P_1min;
     state = state << 1 | P_30s;
     // memory.set(2, state); // u8 -> 1 byte
-    memory[2] = state;
+    set_u8(memory, 2, state);
     state = 0;
     state = state << 1 | P_1day;
     state = state << 1 | P_12hr;
@@ -610,30 +1396,59 @@ RuntimeError VovkPLCRuntime::run(u8* program, u32 prog_size) {
     state = state << 1 | P_4hr;
     state = state << 1 | P_3hr;
     // memory.set(3, state); // u8 -> 1 byte
-    memory[3] = state;
+    set_u8(memory, 3, state);
 
     // memory.set(4, interval_time_days);
     // memory.set(5, interval_time_hours);
     // memory.set(6, interval_time_minutes);
     // memory.set(7, interval_time_seconds);
-    memory[4] = interval_time_days;
-    memory[5] = interval_time_hours;
-    memory[6] = interval_time_minutes;
-    memory[7] = interval_time_seconds;
-    u32 index = 0;
-    while (index < prog_size) {
-        RuntimeError status = step(program, prog_size, index);
-        if (status != STATUS_SUCCESS) {
-            if (status == PROGRAM_EXITED)
-                return STATUS_SUCCESS;
-            return status;
-        }
+    set_u8(memory, 4, interval_time_days);
+    set_u8(memory, 5, interval_time_hours);
+    set_u8(memory, 6, interval_time_minutes);
+    set_u8(memory, 7, interval_time_seconds);
+}
+
+
+
+
+// Execute the segment at the program offset like a CALL until it returns, returns an error code (0 on success)
+RuntimeError VovkPLCRuntime::runSegment(u32 offset) {
+    u8* program = this->program.program;
+    u32 prog_size = this->program.prog_size;
+    u32 depth = stack.call_stack.size();
+    // The return address is never used, the segment is done when its RET drops the call stack to the entry depth
+    RuntimeError status = stack.pushCall(0);
+    if (status != STATUS_SUCCESS) return status;
+    u32 index = offset;
+    while (stack.call_stack.size() > depth) {
+        if (index >= prog_size) return PROGRAM_POINTER_OUT_OF_BOUNDS;
+        status = dispatch(program, prog_size, index);
+        if (status != STATUS_SUCCESS) return status;
     }
     return STATUS_SUCCESS;
 }
 
+namespace PLCMethods {
+    // Run one scan of the sequential function chart
+    RuntimeError handle_SFC(VovkPLCRuntime& runtime) {
+#ifdef PLCRUNTIME_SFC
+        return runtime.sfc.scan(runtime);
+#else // PLCRUNTIME_SFC
+        return UNKNOWN_INSTRUCTION;
+#endif // PLCRUNTIME_SFC
+    }
 
-
+    // Schedule the recipe with the u8 index from the stack for the next scan boundary
+    RuntimeError handle_RECIPE(VovkPLCRuntime& runtime) {
+#ifdef PLCRUNTIME_RECIPES
+        u8 index = runtime.stack.pop_u8();
+        if (runtime.recipes.request(index)) return EXECUTION_ERROR;
+        return STATUS_SUCCESS;
+#else // PLCRUNTIME_RECIPES
+        return UNKNOWN_INSTRUCTION;
+#endif // PLCRUNTIME_RECIPES
+    }
+}
 
 // Execute one PLC instruction at index, returns an error code (0 on success)
 RuntimeError VovkPLCRuntime::step(RuntimeProgram& program) { return step(program.program, program.prog_size, program.program_line); }
@@ -642,150 +1457,89 @@ RuntimeError VovkPLCRuntime::step(RuntimeProgram& program) { return step(program
 RuntimeError VovkPLCRuntime::step(u8* program, u32 prog_size, u32& index) {
     if (prog_size == 0) return EMPTY_PROGRAM;
     if (index >= prog_size) return PROGRAM_SIZE_EXCEEDED;
+    return dispatch(program, prog_size, index);
+}
+
+RuntimeError VovkPLCRuntime::dispatch(u8* program, u32 prog_size, u32& index) {
+#ifdef PLCRUNTIME_PROFILER
+    if (profiling && this->program.profile) this->program.profile[index]++;
+#endif // PLCRUNTIME_PROFILER
+    u32 pc = index;
     u8 opcode = program[index];
     index++;
+#define PLCRUNTIME_ARGUMENTS_STACK (this->stack)
+#define PLCRUNTIME_ARGUMENTS_PROGRAM (this->stack, program, prog_size, index)
+#define PLCRUNTIME_ARGUMENTS_MEMORY (this->stack, this->memory, program, prog_size, index)
+#define PLCRUNTIME_ARGUMENTS_RUNTIME (*this)
+#define PLCRUNTIME_CALL(handler, arguments) PLCMethods::handler PLCRUNTIME_ARGUMENTS_##arguments
+    // Each cost class generates its own case body, so the extra work of a class is only paid by its instructions
+#define PLCRUNTIME_CASE(handler, arguments, pop, push) return PLCRUNTIME_CALL(handler, arguments);
+#define PLCRUNTIME_CASE_COST_STACK PLCRUNTIME_CASE
+#define PLCRUNTIME_CASE_COST_MEMORY PLCRUNTIME_CASE
+#define PLCRUNTIME_CASE_COST_BIT PLCRUNTIME_CASE
+#define PLCRUNTIME_CASE_COST_INTEGER PLCRUNTIME_CASE
+#define PLCRUNTIME_CASE_COST_MULTIPLY PLCRUNTIME_CASE
+#define PLCRUNTIME_CASE_COST_DIVIDE PLCRUNTIME_CASE
+#define PLCRUNTIME_CASE_COST_STRING PLCRUNTIME_CASE
+#ifdef PLCRUNTIME_MATH_CACHE
+    // Math result cache, only for the instructions that work on the stack alone (not LUT_INTERP, it reads the memory)
+#define PLCRUNTIME_PURE_STACK true
+#define PLCRUNTIME_PURE_PROGRAM true
+#define PLCRUNTIME_PURE_MEMORY false
+#define PLCRUNTIME_PURE_RUNTIME false
+#define PLCRUNTIME_CASE_COST_MATH(handler, arguments, pop, push) { \
+        if (!PLCRUNTIME_PURE_##arguments || !math_cache.enabled || index >= prog_size) return PLCRUNTIME_CALL(handler, arguments); \
+        IGNORE_UNUSED u16 ptr = sizeof(MY_PTR_t); \
+        IGNORE_UNUSED u16 t1 = DATA_TYPE_SIZE(program[index]); \
+        if (math_cache.lookup(stack.stack, pc, pop, push)) { index++; return STATUS_SUCCESS; } \
+        RuntimeError status = PLCRUNTIME_CALL(handler, arguments); \
+        if (status == STATUS_SUCCESS) math_cache.store(stack.stack); \
+        return status; \
+    }
+#else // PLCRUNTIME_MATH_CACHE
+#define PLCRUNTIME_CASE_COST_MATH PLCRUNTIME_CASE
+#endif // PLCRUNTIME_MATH_CACHE
+    // Runaway loop guard. Every loop has to take a backward jump or call, so only those are counted
+    // (RET and EXIT are excluded, opcode < RET). A limit of 0 disables the guard.
+#define PLCRUNTIME_CASE_COST_JUMP(handler, arguments, pop, push) { \
+        RuntimeError status = PLCRUNTIME_CALL(handler, arguments); \
+        if (index <= pc && opcode < RET && status == STATUS_SUCCESS && loop_limit && --loop_budget == 0) return loopLimitExceeded(pc); \
+        return status; \
+    }
+#define PLCRUNTIME_CASE_COST_CALL PLCRUNTIME_CASE_COST_JUMP
+#define PLCRUNTIME_DISPATCH(name, opcode, mnemonic, size, operands, pop, push, cost, handler, arguments) PLCRUNTIME_IF_USED(name)(case name: PLCRUNTIME_CASE_##cost(handler, arguments, pop, push))
     switch (opcode) {
-        case NOP: return STATUS_SUCCESS;
-        case LOGIC_AND: return PLCMethods::LOGIC_AND(this->stack);
-        case LOGIC_OR: return PLCMethods::LOGIC_OR(this->stack);
-        case LOGIC_NOT: return PLCMethods::LOGIC_NOT(this->stack);
-        case LOGIC_XOR: return PLCMethods::LOGIC_XOR(this->stack);
-        case CVT: return PLCMethods::CVT(this->stack, program, prog_size, index);
-        case LOAD: return PLCMethods::LOAD(this->stack, this->memory, program, prog_size, index);
-        case MOVE: return PLCMethods::MOVE(this->stack, this->memory, program, prog_size, index);
-        case MOVE_COPY: return PLCMethods::MOVE_COPY(this->stack, this->memory, program, prog_size, index);
-        case COPY: return PLCMethods::COPY(this->stack, program, prog_size, index);
-        case SWAP: return PLCMethods::SWAP(this->stack, program, prog_size, index);
-        case DROP: return PLCMethods::DROP(this->stack, program, prog_size, index);
-        case CLEAR: return PLCMethods::CLEAR(this->stack);
-        case JMP: return PLCMethods::handle_JMP(this->stack, program, prog_size, index);
-        case JMP_IF: return PLCMethods::handle_JMP_IF(this->stack, program, prog_size, index);
-        case JMP_IF_NOT: return PLCMethods::handle_JMP_IF_NOT(this->stack, program, prog_size, index);
-        case CALL: return PLCMethods::handle_CALL(this->stack, program, prog_size, index);
-        case CALL_IF: return PLCMethods::handle_CALL_IF(this->stack, program, prog_size, index);
-        case CALL_IF_NOT: return PLCMethods::handle_CALL_IF_NOT(this->stack, program, prog_size, index);
-        case RET: return PLCMethods::handle_RET(this->stack, program, prog_size, index);
-        case RET_IF: return PLCMethods::handle_RET_IF(this->stack, program, prog_size, index);
-        case RET_IF_NOT: return PLCMethods::handle_RET_IF_NOT(this->stack, program, prog_size, index);
-        case type_pointer: return PLCMethods::PUSH_pointer(this->stack, program, prog_size, index);
-        case type_bool: return PLCMethods::PUSH_bool(this->stack, program, prog_size, index);
-        case type_u8: return PLCMethods::push_u8(this->stack, program, prog_size, index);
-        case type_i8: return PLCMethods::push_i8(this->stack, program, prog_size, index);
-        case type_u16: return PLCMethods::push_u16(this->stack, program, prog_size, index);
-        case type_i16: return PLCMethods::push_i16(this->stack, program, prog_size, index);
-        case type_u32: return PLCMethods::push_u32(this->stack, program, prog_size, index);
-        case type_i32: return PLCMethods::push_i32(this->stack, program, prog_size, index);
-        case type_f32: return PLCMethods::push_f32(this->stack, program, prog_size, index);
-#ifdef USE_X64_OPS
-        case type_u64: return PLCMethods::push_u64(this->stack, program, prog_size, index);
-        case type_i64: return PLCMethods::push_i64(this->stack, program, prog_size, index);
-        case type_f64: return PLCMethods::push_f64(this->stack, program, prog_size, index);
-#endif // USE_X64_OPS
-        case ADD: return PLCMethods::handle_ADD(this->stack, program, prog_size, index);
-        case SUB: return PLCMethods::handle_SUB(this->stack, program, prog_size, index);
-        case MUL: return PLCMethods::handle_MUL(this->stack, program, prog_size, index);
-        case DIV: return PLCMethods::handle_DIV(this->stack, program, prog_size, index);
-        case MOD: return PLCMethods::handle_MOD(this->stack, program, prog_size, index);
-        case POW: return PLCMethods::handle_POW(this->stack, program, prog_size, index);
-        case ABS: return PLCMethods::handle_ABS(this->stack, program, prog_size, index);
-        case NEG: return PLCMethods::handle_NEG(this->stack, program, prog_size, index);
-        case SQRT: return PLCMethods::handle_SQRT(this->stack, program, prog_size, index);
-        case SIN: return PLCMethods::handle_SIN(this->stack, program, prog_size, index);
-        case COS: return PLCMethods::handle_COS(this->stack, program, prog_size, index);
-
-        case GET_X8_B0: return PLCMethods::handle_GET_X8_B0(this->stack);
-        case GET_X8_B1: return PLCMethods::handle_GET_X8_B1(this->stack);
-        case GET_X8_B2: return PLCMethods::handle_GET_X8_B2(this->stack);
-        case GET_X8_B3: return PLCMethods::handle_GET_X8_B3(this->stack);
-        case GET_X8_B4: return PLCMethods::handle_GET_X8_B4(this->stack);
-        case GET_X8_B5: return PLCMethods::handle_GET_X8_B5(this->stack);
-        case GET_X8_B6: return PLCMethods::handle_GET_X8_B6(this->stack);
-        case GET_X8_B7: return PLCMethods::handle_GET_X8_B7(this->stack);
-        case SET_X8_B0: return PLCMethods::handle_SET_X8_B0(this->stack);
-        case SET_X8_B1: return PLCMethods::handle_SET_X8_B1(this->stack);
-        case SET_X8_B2: return PLCMethods::handle_SET_X8_B2(this->stack);
-        case SET_X8_B3: return PLCMethods::handle_SET_X8_B3(this->stack);
-        case SET_X8_B4: return PLCMethods::handle_SET_X8_B4(this->stack);
-        case SET_X8_B5: return PLCMethods::handle_SET_X8_B5(this->stack);
-        case SET_X8_B6: return PLCMethods::handle_SET_X8_B6(this->stack);
-        case SET_X8_B7: return PLCMethods::handle_SET_X8_B7(this->stack);
-        case RSET_X8_B0: return PLCMethods::handle_RSET_X8_B0(this->stack);
-        case RSET_X8_B1: return PLCMethods::handle_RSET_X8_B1(this->stack);
-        case RSET_X8_B2: return PLCMethods::handle_RSET_X8_B2(this->stack);
-        case RSET_X8_B3: return PLCMethods::handle_RSET_X8_B3(this->stack);
-        case RSET_X8_B4: return PLCMethods::handle_RSET_X8_B4(this->stack);
-        case RSET_X8_B5: return PLCMethods::handle_RSET_X8_B5(this->stack);
-        case RSET_X8_B6: return PLCMethods::handle_RSET_X8_B6(this->stack);
-        case RSET_X8_B7: return PLCMethods::handle_RSET_X8_B7(this->stack);
-        case READ_X8_B0: return PLCMethods::handle_READ_X8_B0(this->stack, this->memory, program, prog_size, index);
-        case READ_X8_B1: return PLCMethods::handle_READ_X8_B1(this->stack, this->memory, program, prog_size, index);
-        case READ_X8_B2: return PLCMethods::handle_READ_X8_B2(this->stack, this->memory, program, prog_size, index);
-        case READ_X8_B3: return PLCMethods::handle_READ_X8_B3(this->stack, this->memory, program, prog_size, index);
-        case READ_X8_B4: return PLCMethods::handle_READ_X8_B4(this->stack, this->memory, program, prog_size, index);
-        case READ_X8_B5: return PLCMethods::handle_READ_X8_B5(this->stack, this->memory, program, prog_size, index);
-        case READ_X8_B6: return PLCMethods::handle_READ_X8_B6(this->stack, this->memory, program, prog_size, index);
-        case READ_X8_B7: return PLCMethods::handle_READ_X8_B7(this->stack, this->memory, program, prog_size, index);
-        case WRITE_X8_B0: return PLCMethods::handle_WRITE_X8_B0(this->stack, this->memory, program, prog_size, index);
-        case WRITE_X8_B1: return PLCMethods::handle_WRITE_X8_B1(this->stack, this->memory, program, prog_size, index);
-        case WRITE_X8_B2: return PLCMethods::handle_WRITE_X8_B2(this->stack, this->memory, program, prog_size, index);
-        case WRITE_X8_B3: return PLCMethods::handle_WRITE_X8_B3(this->stack, this->memory, program, prog_size, index);
-        case WRITE_X8_B4: return PLCMethods::handle_WRITE_X8_B4(this->stack, this->memory, program, prog_size, index);
-        case WRITE_X8_B5: return PLCMethods::handle_WRITE_X8_B5(this->stack, this->memory, program, prog_size, index);
-        case WRITE_X8_B6: return PLCMethods::handle_WRITE_X8_B6(this->stack, this->memory, program, prog_size, index);
-        case WRITE_X8_B7: return PLCMethods::handle_WRITE_X8_B7(this->stack, this->memory, program, prog_size, index);
-        case WRITE_S_X8_B0: return PLCMethods::handle_WRITE_S_X8_B0(this->stack, this->memory, program, prog_size, index);
-        case WRITE_S_X8_B1: return PLCMethods::handle_WRITE_S_X8_B1(this->stack, this->memory, program, prog_size, index);
-        case WRITE_S_X8_B2: return PLCMethods::handle_WRITE_S_X8_B2(this->stack, this->memory, program, prog_size, index);
-        case WRITE_S_X8_B3: return PLCMethods::handle_WRITE_S_X8_B3(this->stack, this->memory, program, prog_size, index);
-        case WRITE_S_X8_B4: return PLCMethods::handle_WRITE_S_X8_B4(this->stack, this->memory, program, prog_size, index);
-        case WRITE_S_X8_B5: return PLCMethods::handle_WRITE_S_X8_B5(this->stack, this->memory, program, prog_size, index);
-        case WRITE_S_X8_B6: return PLCMethods::handle_WRITE_S_X8_B6(this->stack, this->memory, program, prog_size, index);
-        case WRITE_S_X8_B7: return PLCMethods::handle_WRITE_S_X8_B7(this->stack, this->memory, program, prog_size, index);
-        case WRITE_R_X8_B0: return PLCMethods::handle_WRITE_R_X8_B0(this->stack, this->memory, program, prog_size, index);
-        case WRITE_R_X8_B1: return PLCMethods::handle_WRITE_R_X8_B1(this->stack, this->memory, program, prog_size, index);
-        case WRITE_R_X8_B2: return PLCMethods::handle_WRITE_R_X8_B2(this->stack, this->memory, program, prog_size, index);
-        case WRITE_R_X8_B3: return PLCMethods::handle_WRITE_R_X8_B3(this->stack, this->memory, program, prog_size, index);
-        case WRITE_R_X8_B4: return PLCMethods::handle_WRITE_R_X8_B4(this->stack, this->memory, program, prog_size, index);
-        case WRITE_R_X8_B5: return PLCMethods::handle_WRITE_R_X8_B5(this->stack, this->memory, program, prog_size, index);
-        case WRITE_R_X8_B6: return PLCMethods::handle_WRITE_R_X8_B6(this->stack, this->memory, program, prog_size, index);
-        case WRITE_R_X8_B7: return PLCMethods::handle_WRITE_R_X8_B7(this->stack, this->memory, program, prog_size, index);
-        case WRITE_INV_X8_B0: return PLCMethods::handle_WRITE_INV_X8_B0(this->stack, this->memory, program, prog_size, index);
-        case WRITE_INV_X8_B1: return PLCMethods::handle_WRITE_INV_X8_B1(this->stack, this->memory, program, prog_size, index);
-        case WRITE_INV_X8_B2: return PLCMethods::handle_WRITE_INV_X8_B2(this->stack, this->memory, program, prog_size, index);
-        case WRITE_INV_X8_B3: return PLCMethods::handle_WRITE_INV_X8_B3(this->stack, this->memory, program, prog_size, index);
-        case WRITE_INV_X8_B4: return PLCMethods::handle_WRITE_INV_X8_B4(this->stack, this->memory, program, prog_size, index);
-        case WRITE_INV_X8_B5: return PLCMethods::handle_WRITE_INV_X8_B5(this->stack, this->memory, program, prog_size, index);
-        case WRITE_INV_X8_B6: return PLCMethods::handle_WRITE_INV_X8_B6(this->stack, this->memory, program, prog_size, index);
-        case WRITE_INV_X8_B7: return PLCMethods::handle_WRITE_INV_X8_B7(this->stack, this->memory, program, prog_size, index);
-
-        case BW_AND_X8: return PLCMethods::handle_BW_AND_X8(this->stack);
-        case BW_AND_X16: return PLCMethods::handle_BW_AND_X16(this->stack);
-        case BW_AND_X32: return PLCMethods::handle_BW_AND_X32(this->stack);
-        case BW_OR_X8: return PLCMethods::handle_BW_OR_X8(this->stack);
-        case BW_OR_X16: return PLCMethods::handle_BW_OR_X16(this->stack);
-        case BW_OR_X32: return PLCMethods::handle_BW_OR_X32(this->stack);
-        case BW_XOR_X8: return PLCMethods::handle_BW_XOR_X8(this->stack);
-        case BW_XOR_X16: return PLCMethods::handle_BW_XOR_X16(this->stack);
-        case BW_XOR_X32: return PLCMethods::handle_BW_XOR_X32(this->stack);
-        case BW_NOT_X8: return PLCMethods::handle_BW_NOT_X8(this->stack);
-        case BW_NOT_X16: return PLCMethods::handle_BW_NOT_X16(this->stack);
-        case BW_NOT_X32: return PLCMethods::handle_BW_NOT_X32(this->stack);
+        PLCRUNTIME_INSTRUCTION_SET(PLCRUNTIME_DISPATCH)
 #ifdef USE_X64_OPS
-        case BW_AND_X64: return PLCMethods::handle_BW_AND_X64(this->stack);
-        case BW_OR_X64: return PLCMethods::handle_BW_OR_X64(this->stack);
-        case BW_XOR_X64: return PLCMethods::handle_BW_XOR_X64(this->stack);
-        case BW_NOT_X64: return PLCMethods::handle_BW_NOT_X64(this->stack);
+        PLCRUNTIME_INSTRUCTION_SET_X64(PLCRUNTIME_DISPATCH)
 #endif // USE_X64_OPS
-        case CMP_EQ: return PLCMethods::handle_CMP_EQ(this->stack, program, prog_size, index);
-        case CMP_NEQ: return PLCMethods::handle_CMP_NEQ(this->stack, program, prog_size, index);
-        case CMP_GT: return PLCMethods::handle_CMP_GT(this->stack, program, prog_size, index);
-        case CMP_GTE: return PLCMethods::handle_CMP_GTE(this->stack, program, prog_size, index);
-        case CMP_LT: return PLCMethods::handle_CMP_LT(this->stack, program, prog_size, index);
-        case CMP_LTE: return PLCMethods::handle_CMP_LTE(this->stack, program, prog_size, index);
-        case EXIT: {
-            return PROGRAM_EXITED;
-            // return PLCMethods::handle_EXIT(this->stack, program, prog_size, index);
-        }
         default: return UNKNOWN_INSTRUCTION;
     }
-}
\ No newline at end of file
+#undef PLCRUNTIME_DISPATCH
+#undef PLCRUNTIME_CASE_COST_STACK
+#undef PLCRUNTIME_CASE_COST_MEMORY
+#undef PLCRUNTIME_CASE_COST_BIT
+#undef PLCRUNTIME_CASE_COST_INTEGER
+#undef PLCRUNTIME_CASE_COST_MULTIPLY
+#undef PLCRUNTIME_CASE_COST_DIVIDE
+#undef PLCRUNTIME_CASE_COST_STRING
+#undef PLCRUNTIME_CASE_COST_MATH
+#undef PLCRUNTIME_CASE_COST_JUMP
+#undef PLCRUNTIME_CASE_COST_CALL
+#ifdef PLCRUNTIME_MATH_CACHE
+#undef PLCRUNTIME_PURE_STACK
+#undef PLCRUNTIME_PURE_PROGRAM
+#undef PLCRUNTIME_PURE_MEMORY
+#undef PLCRUNTIME_PURE_RUNTIME
+#endif // PLCRUNTIME_MATH_CACHE
+#undef PLCRUNTIME_CASE
+#undef PLCRUNTIME_CALL
+#undef PLCRUNTIME_ARGUMENTS_STACK
+#undef PLCRUNTIME_ARGUMENTS_PROGRAM
+#undef PLCRUNTIME_ARGUMENTS_MEMORY
+#undef PLCRUNTIME_ARGUMENTS_RUNTIME
+}
+
+#ifdef PLCRUNTIME_REGISTER_ENGINE
+#include "register/runtime-register.h"
+#endif // PLCRUNTIME_REGISTER_ENGINE
@@ -0,0 +1,164 @@
+// runtime-program-builder.h - 1.0.0 - 2022-12-11
+//
+// Copyright (c) 2022 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+// ################################################################################################
+// Compile time program builder
+// ################################################################################################
+// Firmware can describe a PLC program as a list of instruction types. The bytecode, the label
+// addresses and the checksum are resolved by the compiler, so no assembler has to run on the device:
+//
+//     enum { end };
+//     typedef PLCBuilder::Program<
+//         PLCBuilder::ReadBit<1, 4>,           // u8.readBit     1.4
+//         PLCBuilder::JumpIfNot<end>,          // jump_if_not    end
+//         PLCBuilder::WriteBitInvert<20, 0>,   // u8.writeBitInv 20.0
+//         PLCBuilder::Label<end>,              // end:
+//         PLCBuilder::Op<EXIT>
+//     > Blinky;
+//     runtime.loadProgram(Blinky::bytecode(), Blinky::size, Blinky::checksum());
+//
+// Real constants are given by their IEEE-754 bit pattern (PushF32<0x3FC00000> is 1.5), because C++11
+// does not allow floating point template arguments.
+
+namespace PLCBuilder {
+
+    // ---------- Instructions ----------
+
+    // Opcode followed by a big-endian operand of 'operand_size' bytes
+    template <u8 opcode, u64 operand = 0, u8 operand_size = 0> struct Instruction {
+        static const u32 size = 1 + operand_size;
+        template <typename Program> static constexpr u8 byte(u32 i) {
+            return i == 0 ? opcode : (u8) ((operand >> (8 * (operand_size - i))) & 0xFF);
+        }
+    };
+
+    // Jump target, takes no space in the bytecode
+    template <u16 id> struct Label {
+        static const u32 size = 0;
+        template <typename Program> static constexpr u8 byte(u32) { return 0; }
+    };
+
+    // Instruction with a program address operand resolved from a label
+    template <u8 opcode, u16 label> struct JumpTo {
+        static const u32 size = 3;
+        template <typename Program> static constexpr u8 byte(u32 i) {
+            return i == 0 ? opcode : (u8) ((Program::template Offset<label>::value >> (8 * (2 - i))) & 0xFF);
+        }
+    };
+
+    template <u8 opcode> struct Op : Instruction<opcode> {};
+    template <u8 opcode, u8 data_type> struct Typed : Instruction<opcode, data_type, 1> {};
+    template <u8 from, u8 to> struct Convert : Instruction<CVT, (from << 8) | to, 2> {};
+    template <u8 type_a, u8 type_b> struct Swap : Instruction<SWAP, (type_a << 8) | type_b, 2> {};
+
+    template <MY_PTR_t address> struct PushPointer : Instruction<type_pointer, address, sizeof(MY_PTR_t)> {};
+    template <bool value> struct PushBool : Instruction<type_bool, value ? 1 : 0, 1> {};
+    template <u8 value> struct PushU8 : Instruction<type_u8, value, 1> {};
+    template <u16 value> struct PushU16 : Instruction<type_u16, value, 2> {};
+    template <u32 value> struct PushU32 : Instruction<type_u32, value, 4> {};
+    template <i8 value> struct PushI8 : Instruction<type_i8, (u8) value, 1> {};
+    template <i16 value> struct PushI16 : Instruction<type_i16, (u16) value, 2> {};
+    template <i32 value> struct PushI32 : Instruction<type_i32, (u32) value, 4> {};
+    template <u32 bits> struct PushF32 : Instruction<type_f32, bits, 4> {};
+#ifdef USE_X64_OPS
+    template <u64 value> struct PushU64 : Instruction<type_u64, value, 8> {};
+    template <i64 value> struct PushI64 : Instruction<type_i64, (u64) value, 8> {};
+    template <u64 bits> struct PushF64 : Instruction<type_f64, bits, 8> {};
+#endif // USE_X64_OPS
+
+    // Bit access on a byte in the memory (address.bit)
+    template <u16 address, u8 bit> struct ReadBit : Instruction<READ_X8_B0 + bit, address, 2> { static_assert(bit < 8, "Bit index out of range"); };
+    template <u16 address, u8 bit> struct WriteBit : Instruction<WRITE_X8_B0 + bit, address, 2> { static_assert(bit < 8, "Bit index out of range"); };
+    template <u16 address, u8 bit> struct WriteBitSet : Instruction<WRITE_S_X8_B0 + bit, address, 2> { static_assert(bit < 8, "Bit index out of range"); };
+    template <u16 address, u8 bit> struct WriteBitReset : Instruction<WRITE_R_X8_B0 + bit, address, 2> { static_assert(bit < 8, "Bit index out of range"); };
+    template <u16 address, u8 bit> struct WriteBitInvert : Instruction<WRITE_INV_X8_B0 + bit, address, 2> { static_assert(bit < 8, "Bit index out of range"); };
+
+    template <u16 label> struct Jump : JumpTo<JMP, label> {};
+    template <u16 label> struct JumpIf : JumpTo<JMP_IF, label> {};
+    template <u16 label> struct JumpIfNot : JumpTo<JMP_IF_NOT, label> {};
+    template <u16 label> struct Call : JumpTo<CALL, label> {};
+    template <u16 label> struct CallIf : JumpTo<CALL_IF, label> {};
+    template <u16 label> struct CallIfNot : JumpTo<CALL_IF_NOT, label> {};
+
+    // ---------- Layout ----------
+
+    template <typename... Ops> struct ProgramSize { static const u32 value = 0; };
+    template <typename Op, typename... Rest> struct ProgramSize<Op, Rest...> { static const u32 value = Op::size + ProgramSize<Rest...>::value; };
+
+    template <typename... Ops> struct InstructionCount { static const u32 value = 0; };
+    template <typename Op, typename... Rest> struct InstructionCount<Op, Rest...> { static const u32 value = (Op::size > 0 ? 1 : 0) + InstructionCount<Rest...>::value; };
+
+    template <typename Op, u16 id> struct IsLabel { static const bool value = false; };
+    template <u16 id> struct IsLabel<Label<id>, id> { static const bool value = true; };
+
+    template <u16 id> struct LabelNotFound { static const bool value = false; };
+
+    // Offset of the label 'id', searched from 'offset' on
+    template <u16 id, u32 offset, typename... Ops> struct LabelOffset {
+        static_assert(LabelNotFound<id>::value, "Jump to an undefined label");
+        static const u32 value = 0;
+    };
+    template <bool found, u16 id, u32 offset, typename... Ops> struct LabelSearch { static const u32 value = offset; };
+    template <u16 id, u32 offset, typename... Ops> struct LabelSearch<false, id, offset, Ops...> : LabelOffset<id, offset, Ops...> {};
+    template <u16 id, u32 offset, typename Op, typename... Rest> struct LabelOffset<id, offset, Op, Rest...> : LabelSearch<IsLabel<Op, id>::value, id, offset + Op::size, Rest...> {};
+
+    template <typename Program> constexpr u8 byteAt(u32) { return 0; }
+    template <typename Program, typename Op, typename... Rest> constexpr u8 byteAt(u32 i) {
+        return i < Op::size ? Op::template byte<Program>(i) : byteAt<Program, Rest...>(i - Op::size);
+    }
+
+    // Same polynomial as crc8_simple(), split in halves to keep the constexpr recursion shallow
+    constexpr u8 crc8Bits(u8 crc, u8 k) { return k == 0 ? crc : crc8Bits(crc & 0x80 ? (u8) ((crc << 1) ^ 0x31) : (u8) (crc << 1), k - 1); }
+    template <typename Program> constexpr u8 crc8Range(u8 crc, u32 start, u32 count) {
+        return count == 0 ? crc : count == 1 ? crc8Bits(crc ^ Program::byte(start), 8) : crc8Range<Program>(crc8Range<Program>(crc, start, count / 2), start + count / 2, count - count / 2);
+    }
+
+    template <u32... I> struct Indices {};
+    template <typename A, typename B> struct IndicesJoin;
+    template <u32... A, u32... B> struct IndicesJoin<Indices<A...>, Indices<B...> > { typedef Indices<A..., (sizeof...(A) + B)...> type; };
+    template <u32 N> struct MakeIndices { typedef typename IndicesJoin<typename MakeIndices<N / 2>::type, typename MakeIndices<N - N / 2>::type>::type type; };
+    template <> struct MakeIndices<0> { typedef Indices<> type; };
+    template <> struct MakeIndices<1> { typedef Indices<0> type; };
+
+    template <typename Program, typename I> struct ProgramData;
+    template <typename Program, u32... I> struct ProgramData<Program, Indices<I...> > { static const u8 bytes[sizeof...(I)]; };
+    template <typename Program, u32... I> const u8 ProgramData<Program, Indices<I...> >::bytes[sizeof...(I)] = { Program::byte(I)... };
+
+    // ---------- Program ----------
+
+    // The bytecode is a constant array, it is copied into the runtime program memory by loadProgram()
+    template <typename... Ops> struct Program {
+        static const u32 size = ProgramSize<Ops...>::value;
+        static const u32 instruction_count = InstructionCount<Ops...>::value;
+        static_assert(size > 0, "Empty program");
+        static_assert(size <= PLCRUNTIME_MAX_PROGRAM_SIZE, "Program does not fit into the program memory");
+        static_assert(size <= 0xFFFF, "Program addresses are limited to 16 bits");
+
+        template <u16 id> struct Offset : LabelOffset<id, 0, Ops...> {};
+
+        static constexpr u8 byte(u32 i) { return byteAt<Program, Ops...>(i); }
+        static constexpr u8 checksum() { return crc8Range<Program>(0, 0, size); }
+        static const u8* bytecode() { return ProgramData<Program, typename MakeIndices<size>::type>::bytes; }
+    };
+
+}
@@ -24,7 +24,7 @@
 class InstructionCompiler {
 public:
     // Push a new sequence of bytes to the PLC Program
-    static u32 push(u8* location, u8* code, u32 code_size) {
+    static u32 push(u8* location, const u8* code, u32 code_size) {
         memcpy(location, code, code_size);
         return code_size;
     }
@@ -258,22 +258,149 @@ public:
         location[1] = type;
         return 2;
     }
+
+    // Open a frame of 'size' bytes for the local variables of the current call
+    static u8 push_enter(u8* location, u8 size) {
+        location[0] = ENTER;
+        location[1] = size;
+        return 2;
+    }
+    // Push the local variable at the frame offset
+    static u8 push_local_load(u8* location, PLCRuntimeInstructionSet type, u8 offset) {
+        location[0] = LOCAL_LOAD;
+        location[1] = type;
+        location[2] = offset;
+        return 3;
+    }
+    // Pop the value into the local variable at the frame offset
+    static u8 push_local_store(u8* location, PLCRuntimeInstructionSet type, u8 offset) {
+        location[0] = LOCAL_STORE;
+        location[1] = type;
+        location[2] = offset;
+        return 3;
+    }
+};
+
+// Program image
+// The bytecode and its metadata loaded once and shared read-only by any number of runtimes (RuntimeProgram::attach),
+// e.g. a simulation running many copies of the same controller. Every runtime keeps its own stack, memory and program
+// line. The image counts the runtimes attached to it and can't be reloaded while any of them is. With the profiler the
+// image also holds the execution counts, summed over all attached runtimes.
+// With PLCRUNTIME_SHARED_PROGRAM the runtimes have no program storage of their own and only run attached images.
+class RuntimeProgramImage {
+public:
+    u8 code[PLCRUNTIME_MAX_PROGRAM_SIZE]; // Bytecode
+#ifdef PLCRUNTIME_PROFILER
+    u32 profile[PLCRUNTIME_MAX_PROGRAM_SIZE]; // Execution count of each program offset
+#endif // PLCRUNTIME_PROFILER
+    u32 size = 0; // Bytecode size in bytes
+    u8 checksum = 0; // CRC8 of the bytecode
+    u16 references = 0; // Number of runtimes attached to the image
+
+    RuntimeProgramImage() {}
+    RuntimeProgramImage(const RuntimeProgramImage&) = delete;
+
+    // Load the bytecode into the image, returns an error code (0 on success)
+    RuntimeError load(const u8* program, u32 prog_size, u8 checksum) {
+        if (references > 0) return PROGRAM_READ_ONLY;
+        if (prog_size == 0) return EMPTY_PROGRAM;
+        if (prog_size > PLCRUNTIME_MAX_PROGRAM_SIZE) return PROGRAM_SIZE_EXCEEDED;
+        u8 calculated_checksum = 0;
+        crc8_simple(calculated_checksum, program, prog_size);
+        if (calculated_checksum != checksum) return INVALID_CHECKSUM;
+#ifdef PLCRUNTIME_INSTRUCTION_SUBSET
+        RuntimeError status = INSTRUCTION_SUBSET_CHECK(program, prog_size);
+        if (status != STATUS_SUCCESS) return status;
+#endif // PLCRUNTIME_INSTRUCTION_SUBSET
+        memcpy(code, program, prog_size);
+#ifdef PLCRUNTIME_PROFILER
+        memset(profile, 0, sizeof(profile));
+#endif // PLCRUNTIME_PROFILER
+        this->size = prog_size;
+        this->checksum = checksum;
+        return STATUS_SUCCESS;
+    }
 };
 
 class RuntimeProgram {
 private:
-    u32 MAX_PROGRAM_SIZE = PLCRUNTIME_MAX_PROGRAM_SIZE; // Max program size in bytes
+#ifdef PLCRUNTIME_SHARED_PROGRAM
+    u32 STORAGE_SIZE = 0; // No own program storage, only attached images are run
+#else
+    u32 STORAGE_SIZE = PLCRUNTIME_MAX_PROGRAM_SIZE; // Size of the own program storage in bytes
+    u8 storage[PLCRUNTIME_MAX_PROGRAM_SIZE]; // Own program storage
+#ifdef PLCRUNTIME_PROFILER
+    u32 profile_storage[PLCRUNTIME_MAX_PROGRAM_SIZE]; // Execution counts of the own program
+#endif // PLCRUNTIME_PROFILER
+#endif // PLCRUNTIME_SHARED_PROGRAM
+    u32 MAX_PROGRAM_SIZE = STORAGE_SIZE; // Max program size in bytes, 0 while an image is attached (read-only)
 public:
-    u8 program[PLCRUNTIME_MAX_PROGRAM_SIZE]; // PLC program to execute
+#ifdef PLCRUNTIME_SHARED_PROGRAM
+    u8* program = nullptr; // PLC program to execute, the attached image
+#ifdef PLCRUNTIME_PROFILER
+    u32* profile = nullptr; // Execution count of each program offset, those of the attached image
+#endif // PLCRUNTIME_PROFILER
+#else
+    u8* program = storage; // PLC program to execute, the own storage or the attached image
+#ifdef PLCRUNTIME_PROFILER
+    u32* profile = profile_storage; // Execution count of each program offset, the own counts or those of the attached image
+#endif // PLCRUNTIME_PROFILER
+#endif // PLCRUNTIME_SHARED_PROGRAM
+    RuntimeProgramImage* image = nullptr; // Attached image, nullptr for an own program
     u32 prog_size = 0; // Current program size in bytes
     u32 program_line = 0; // Active program line
+    u32 generation = 0; // Bumped whenever the bytecode is replaced or modified, appending only grows prog_size
     RuntimeError status = UNDEFINED_STATE;
 
     RuntimeProgram(u32 prog_size) {
-        if (prog_size > PLCRUNTIME_MAX_PROGRAM_SIZE) prog_size = PLCRUNTIME_MAX_PROGRAM_SIZE;
+        if (prog_size > STORAGE_SIZE) prog_size = STORAGE_SIZE;
+        this->STORAGE_SIZE = prog_size;
         this->MAX_PROGRAM_SIZE = prog_size;
     }
     RuntimeProgram() {}
+    RuntimeProgram(const RuntimeProgram&) = delete;
+    ~RuntimeProgram() { detach(); }
+
+    // Run the shared image instead of an own copy of the program, returns an error code (0 on success)
+    RuntimeError attach(RuntimeProgramImage& image) {
+        if (image.size == 0) return EMPTY_PROGRAM;
+        detach();
+        generation++;
+        image.references++;
+        this->image = &image;
+        this->program = image.code;
+#ifdef PLCRUNTIME_PROFILER
+        this->profile = image.profile;
+#endif // PLCRUNTIME_PROFILER
+        this->prog_size = image.size;
+        this->program_line = 0;
+        this->MAX_PROGRAM_SIZE = 0;
+        status = STATUS_SUCCESS;
+        return status;
+    }
+
+    // Release the attached image, the program is empty afterwards
+    void detach() {
+        if (image == nullptr) return;
+        generation++;
+        image->references--;
+        image = nullptr;
+#ifdef PLCRUNTIME_SHARED_PROGRAM
+        program = nullptr;
+#ifdef PLCRUNTIME_PROFILER
+        profile = nullptr;
+#endif // PLCRUNTIME_PROFILER
+#else
+        program = storage;
+#ifdef PLCRUNTIME_PROFILER
+        profile = profile_storage;
+#endif // PLCRUNTIME_PROFILER
+#endif // PLCRUNTIME_SHARED_PROGRAM
+        MAX_PROGRAM_SIZE = STORAGE_SIZE;
+        prog_size = 0;
+        program_line = 0;
+        status = UNDEFINED_STATE;
+    }
 
     void begin(const u8* program, u32 prog_size, u8 checksum) {
         format();
@@ -286,12 +413,16 @@ public:
     }
 
     void format() {
+        detach();
+        generation++;
         this->prog_size = 0;
         this->program_line = 0;
         this->status = UNDEFINED_STATE;
     }
 
     RuntimeError loadUnsafe(const u8* program, u32 prog_size) {
+        detach();
+        generation++;
         if (prog_size > PLCRUNTIME_MAX_PROGRAM_SIZE) status = PROGRAM_SIZE_EXCEEDED;
         if (prog_size > MAX_PROGRAM_SIZE) status = PROGRAM_SIZE_EXCEEDED;
         else if (prog_size == 0) {
@@ -303,6 +434,13 @@ public:
             for (u32 i = 0; i < prog_size; i++) this->program[i] = program[i];
             this->prog_size = prog_size;
             status = STATUS_SUCCESS;
+#ifdef PLCRUNTIME_INSTRUCTION_SUBSET
+            status = INSTRUCTION_SUBSET_CHECK(this->program, prog_size);
+            if (status != STATUS_SUCCESS) {
+                this->prog_size = 0;
+                Serial.println(F("Failed to load program: INSTRUCTION NOT IN THIS BUILD"));
+            }
+#endif // PLCRUNTIME_INSTRUCTION_SUBSET
         }
         return status;
     }
@@ -323,28 +461,34 @@ public:
 
     // Hot update the running program. This is a very dangerous operation, so use it with caution!
     RuntimeError modify(u32 index, u8 value) {
+        if (image) return PROGRAM_READ_ONLY;
         if (index >= prog_size) return INVALID_PROGRAM_INDEX;
         program[index] = value;
+        generation++;
         return STATUS_SUCCESS;
     }
 
     // Hot update the running program. This is a very dangerous operation, so use it with caution!
     RuntimeError modify(u32 index, u8* data, u32 size) {
+        if (image) return PROGRAM_READ_ONLY;
         if (index + size > prog_size) return INVALID_PROGRAM_INDEX;
         for (u32 i = 0; i < size; i++) program[index + i] = data[i];
+        generation++;
         return STATUS_SUCCESS;
     }
 
     RuntimeError modifyValue(u32 index, u32 value) {
+        if (image) return PROGRAM_READ_ONLY;
         if (index + sizeof(u32) > prog_size) return INVALID_PROGRAM_INDEX;
         program[index] = value >> 8;
         program[index + 1] = value & 0xFF;
+        generation++;
         return STATUS_SUCCESS;
     }
 
     // Set the active PLC Program line number
     RuntimeError setLine(u32 line_number) {
-        if (line_number >= MAX_PROGRAM_SIZE) return INVALID_PROGRAM_INDEX;
+        if (line_number >= (image ? prog_size : MAX_PROGRAM_SIZE)) return INVALID_PROGRAM_INDEX;
         program_line = line_number;
         return STATUS_SUCCESS;
     }
@@ -483,7 +627,7 @@ public:
     }
 
     // Push a new sequence of bytes to the PLC Program
-    RuntimeError push(u8* code, u32 code_size) {
+    RuntimeError push(const u8* code, u32 code_size) {
         if (prog_size + code_size > MAX_PROGRAM_SIZE) {
             status = PROGRAM_SIZE_EXCEEDED;
             Serial.print(PROGRAM_SIZE_EXCEEDED_MSG); Serial.println(prog_size);
@@ -761,4 +905,34 @@ public:
         status = STATUS_SUCCESS;
         return status;
     }
+    // Open a frame of 'size' bytes for the local variables of the current call
+    RuntimeError push_enter(u8 size) {
+        if (prog_size + 2 > MAX_PROGRAM_SIZE) {
+            status = PROGRAM_SIZE_EXCEEDED;
+            return status;
+        }
+        prog_size += InstructionCompiler::push_enter(program + prog_size, size);
+        status = STATUS_SUCCESS;
+        return status;
+    }
+    // Push the local variable at the frame offset
+    RuntimeError push_local_load(PLCRuntimeInstructionSet type, u8 offset) {
+        if (prog_size + 3 > MAX_PROGRAM_SIZE) {
+            status = PROGRAM_SIZE_EXCEEDED;
+            return status;
+        }
+        prog_size += InstructionCompiler::push_local_load(program + prog_size, type, offset);
+        status = STATUS_SUCCESS;
+        return status;
+    }
+    // Pop the value into the local variable at the frame offset
+    RuntimeError push_local_store(PLCRuntimeInstructionSet type, u8 offset) {
+        if (prog_size + 3 > MAX_PROGRAM_SIZE) {
+            status = PROGRAM_SIZE_EXCEEDED;
+            return status;
+        }
+        prog_size += InstructionCompiler::push_local_store(program + prog_size, type, offset);
+        status = STATUS_SUCCESS;
+        return status;
+    }
 };
\ No newline at end of file
@@ -77,6 +77,13 @@ int print_hex(u8 value) {
     return length;
 }
 
+// Byte of the PLC memory, flat or paged
+u8 memory_byte(VovkPLCRuntime& runtime, u32 address) {
+    u8 value = 0;
+    get_u8(runtime.memory, address, value);
+    return value;
+}
+
 
 
 #ifdef __RUNTIME_FULL_UNIT_TEST___
@@ -117,6 +124,698 @@ template <typename T> void UnitTest::review(VovkPLCRuntime& runtime, const TestC
     Serial.print(F(" - ")); Serial.print(ms, 3); Serial.println(F(" ms"));
 }
 
+#ifdef PLCRUNTIME_TREND_LOGGER
+// Trend a counter that the program increments by 3 every scan and decode all held samples
+void UnitTest::trend(VovkPLCRuntime& runtime) {
+    auto& program = runtime.program;
+    program.format();
+    program.push_pointer(16);
+    program.push_pointer(16);
+    program.push_load(type_u16);
+    program.push_u16(3);
+    program.push(ADD, type_u16);
+    program.push_move(type_u16);
+    u32 offset = Serial.print(F("Test \"trend => u16 += 3, 300 scans\""));
+    set_u8(runtime.memory, 16, 0);
+    set_u8(runtime.memory, 17, 0);
+    runtime.trend.clearTags();
+    runtime.trend.addTag(16, type_u16);
+    u32 t = micros();
+    for (u32 i = 0; i < 300; i++) runtime.run();
+    t = micros() - t;
+    TrendCursor cursor;
+    bool passed = !runtime.trend.begin(cursor);
+    u32 count = 0;
+    trend_value_t expected = cursor.values[0];
+    do {
+        passed = passed && cursor.values[0] == expected;
+        expected = (expected + 3) & 0xFFFF;
+        count++;
+    } while (passed && !runtime.trend.next(cursor));
+    passed = passed && count == runtime.trend.sample_count && count + runtime.trend.dropped_count == 300;
+    runtime.trend.clearTags();
+    f32 ms = (f32) t * 0.001;
+    for (; offset < 40; offset++) Serial.print(' ');
+    Serial.print(passed ? F("Passed") : F("FAILED !!!"));
+    Serial.print(F(" - ")); Serial.print(ms, 3); Serial.println(F(" ms"));
+}
+#endif // PLCRUNTIME_TREND_LOGGER
+
+#ifdef PLCRUNTIME_CAPTURE
+// Capture a counter that the program increments every scan, triggered when it rises above 100
+void UnitTest::capture(VovkPLCRuntime& runtime) {
+    auto& program = runtime.program;
+    program.format();
+    program.push_pointer(16);
+    program.push_pointer(16);
+    program.push_load(type_u16);
+    program.push_u16(1);
+    program.push(ADD, type_u16);
+    program.push_move(type_u16);
+    u32 offset = Serial.print(F("Test \"capture => u16 > 100, 10 + 5\""));
+    set_u8(runtime.memory, 16, 0);
+    set_u8(runtime.memory, 17, 0);
+    u16 threshold = 100;
+    runtime.capture.clearTags();
+    runtime.capture.addTag(16, type_u16);
+    runtime.capture.setTrigger(CAPTURE_TRIGGER_ABOVE, 16, type_u16, (u8*) &threshold);
+    runtime.capture.arm(10, 5);
+    u32 t = micros();
+    for (u32 i = 0; i < 200; i++) runtime.run();
+    t = micros() - t;
+    // Counter values 91 to 100 before the trigger, 101 on the trigger scan and 102 to 106 after it
+    bool passed = runtime.capture.state == CAPTURE_COMPLETE && runtime.capture.sample_count == 16 && runtime.capture.trigger_index == 10;
+    for (u32 i = 0; passed && i < runtime.capture.sample_count; i++) {
+        u16 value;
+        memcpy(&value, runtime.capture.at(i), 2);
+        passed = value == 91 + i;
+    }
+    runtime.capture.clearTags();
+    f32 ms = (f32) t * 0.001;
+    for (; offset < 40; offset++) Serial.print(' ');
+    Serial.print(passed ? F("Passed") : F("FAILED !!!"));
+    Serial.print(F(" - ")); Serial.print(ms, 3); Serial.println(F(" ms"));
+}
+#endif // PLCRUNTIME_CAPTURE
+
+#ifdef PLCRUNTIME_ALARMS
+// Raise, acknowledge and clear alarms in the second word of a 40 bit alarm area
+void UnitTest::alarms(VovkPLCRuntime& runtime) {
+    runtime.program.format();
+    runtime.program.push(EXIT);
+    u32 offset = Serial.print(F("Test \"alarms => raise, ack, clear\""));
+    for (u32 i = 16; i < 26; i++) set_u8(runtime.memory, i, 0);
+    runtime.alarms.configure(16, 21, 40);
+    u32 t = micros();
+    runtime.run();
+    set_u8(runtime.memory, 20, 0x81); // Raise alarms 32 and 39
+    runtime.run();
+    runtime.alarms.acknowledge(runtime.memory, 39);
+    runtime.run();
+    set_u8(runtime.memory, 20, 0x01); // Clear alarm 39
+    runtime.run();
+    t = micros() - t;
+    const u16 alarm[] = { 32, 39, 39, 39 };
+    const u8 type[] = { ALARM_RAISED, ALARM_RAISED, ALARM_ACKNOWLEDGED, ALARM_CLEARED };
+    AlarmEvent event;
+    bool passed = runtime.alarms.sequence == 4 && memory_byte(runtime, 25) == 0x01;
+    for (u32 i = 0; passed && i < 4; i++) {
+        passed = !runtime.alarms.read(i, event) && event.sequence == i && event.alarm == alarm[i] && event.type == type[i];
+    }
+    passed = passed && runtime.alarms.read(4, event);
+    runtime.alarms.disable();
+    f32 ms = (f32) t * 0.001;
+    for (; offset < 40; offset++) Serial.print(' ');
+    Serial.print(passed ? F("Passed") : F("FAILED !!!"));
+    Serial.print(F(" - ")); Serial.print(ms, 3); Serial.println(F(" ms"));
+}
+#endif // PLCRUNTIME_ALARMS
+
+#ifdef PLCRUNTIME_RECIPES
+// The program requests recipe 1 and copies the first parameter, the block must only change between scans
+void UnitTest::recipes(VovkPLCRuntime& runtime) {
+    auto& program = runtime.program;
+    program.format();
+    program.push_pointer(20);
+    program.push_pointer(16);
+    program.push_load(type_u8);
+    program.push_move(type_u8);
+    program.push_u8(1);
+    program.push(RECIPE);
+    u32 offset = Serial.print(F("Test \"recipes => RECIPE 1 on scan edge\""));
+    const u8 slow[] = { 10, 11, 12, 13 };
+    const u8 fast[] = { 50, 51, 52, 53 };
+    runtime.recipes.clear();
+    runtime.recipes.store("slow", 4, 16, fast, 2);
+    runtime.recipes.store("fast", 4, 16, fast, 4);
+    runtime.recipes.store("slow", 4, 16, slow, 4); // Replaced in place, "fast" stays recipe 1
+    for (u32 i = 16; i < 21; i++) set_u8(runtime.memory, i, 0);
+    u32 t = micros();
+    runtime.run();
+    bool passed = memory_byte(runtime, 16) == 0 && memory_byte(runtime, 20) == 0 && runtime.recipes.pending == 1;
+    runtime.run();
+    t = micros() - t;
+    u8 values[4];
+    readArea_u8(runtime.memory, 16, values, 4);
+    passed = passed && memcmp(values, fast, 4) == 0 && memory_byte(runtime, 20) == 50;
+    passed = passed && runtime.recipes.find("slow", 4) == 0 && runtime.recipes.find("fast", 4) == 1 && runtime.recipes.count == 2;
+    passed = passed && memcmp(runtime.recipes.data(0), slow, 4) == 0 && memcmp(runtime.recipes.data(1), fast, 4) == 0;
+    // A pending request survives the replacement of its recipe
+    runtime.recipes.request(1);
+    runtime.recipes.store("fast", 4, 16, slow, 4);
+    passed = passed && runtime.recipes.pending == 1;
+    runtime.recipes.clear();
+    f32 ms = (f32) t * 0.001;
+    for (; offset < 40; offset++) Serial.print(' ');
+    Serial.print(passed ? F("Passed") : F("FAILED !!!"));
+    Serial.print(F(" - ")); Serial.print(ms, 3); Serial.println(F(" ms"));
+}
+#endif // PLCRUNTIME_RECIPES
+
+#ifdef PLCRUNTIME_TAGS
+// Load a tag table, resolve the names and reject a table with a repeated name hash
+void UnitTest::tags(VovkPLCRuntime& runtime) {
+    u32 offset = Serial.print(F("Test \"tags => load, find, duplicate\""));
+    TagEntry entries[3] = {
+        { tagNameHash("motor_speed", 11), 16, type_u16, 2 },
+        { tagNameHash("valve_open", 10), 18, type_bool, 1 },
+        { tagNameHash("setpoint", 8), 20, type_f32, 4 },
+    };
+    u32 t = micros();
+    bool passed = !runtime.tags.load(entries, 3);
+    const TagEntry* speed = runtime.tags.find("motor_speed", 11);
+    const TagEntry* setpoint = runtime.tags.find("setpoint", 8);
+    t = micros() - t;
+    passed = passed && speed != nullptr && speed->address == 16 && speed->type == type_u16;
+    passed = passed && setpoint != nullptr && setpoint->address == 20 && setpoint->size == 4;
+    passed = passed && runtime.tags.find("motor", 5) == nullptr;
+    entries[2].hash = entries[0].hash;
+    passed = passed && runtime.tags.load(entries, 3) && runtime.tags.count == 0;
+    runtime.tags.clear();
+    f32 ms = (f32) t * 0.001;
+    for (; offset < 40; offset++) Serial.print(' ');
+    Serial.print(passed ? F("Passed") : F("FAILED !!!"));
+    Serial.print(F(" - ")); Serial.print(ms, 3); Serial.println(F(" ms"));
+}
+#endif // PLCRUNTIME_TAGS
+
+// Run a program with an unknown instruction in deferred fault mode, the rest of the block still runs and the fault
+// is reported with its program offset at the EXIT
+void UnitTest::deferred(VovkPLCRuntime& runtime) {
+    auto& program = runtime.program;
+    program.format();
+    program.push_pointer(20);
+    program.push_u8(7);
+    program.push_move(type_u8);
+    u32 fault_index = program.prog_size;
+    program.push(0x0F); // Unknown instruction
+    program.push_pointer(21);
+    program.push_u8(8);
+    program.push_move(type_u8);
+    program.push(EXIT);
+    u32 offset = Serial.print(F("Test \"deferred => fault pc at EXIT\""));
+    set_u8(runtime.memory, 20, 0);
+    set_u8(runtime.memory, 21, 0);
+    u32 t = micros();
+    RuntimeError status = runtime.runDeferred();
+    t = micros() - t;
+    bool passed = status == UNKNOWN_INSTRUCTION && runtime.fault == UNKNOWN_INSTRUCTION && runtime.fault_index == fault_index;
+    passed = passed && memory_byte(runtime, 20) == 7 && memory_byte(runtime, 21) == 8;
+    program.format();
+    program.push_pointer(20);
+    program.push_u8(9);
+    program.push_move(type_u8);
+    program.push(EXIT);
+    status = runtime.runDeferred();
+    passed = passed && status == STATUS_SUCCESS && runtime.fault == STATUS_SUCCESS && memory_byte(runtime, 20) == 9;
+    f32 ms = (f32) t * 0.001;
+    for (; offset < 40; offset++) Serial.print(' ');
+    Serial.print(passed ? F("Passed") : F("FAILED !!!"));
+    Serial.print(F(" - ")); Serial.print(ms, 3); Serial.println(F(" ms"));
+
+    // The deferred mode must not cost more than the checked run: count a u16 to 2000 in a loop with both
+    program.format();
+    program.push_pointer(20);
+    program.push_u16(0);
+    program.push_move(type_u16);
+    u32 loop = program.prog_size;
+    program.push_pointer(20);
+    program.push_pointer(20);
+    program.push_load(type_u16);
+    program.push_u16(1);
+    program.push(ADD, type_u16);
+    program.push_move(type_u16);
+    program.push_pointer(20);
+    program.push_load(type_u16);
+    program.push_u16(2000);
+    program.push(CMP_LT, type_u16);
+    program.push_jmp_if(loop);
+    program.push(EXIT);
+    // Best of 50 interleaved runs, so a busy host does not decide the result
+    u32 run_time = 0xFFFFFFFF;
+    u32 deferred_time = 0xFFFFFFFF;
+    for (u32 i = 0; i < 50; i++) {
+        t = micros();
+        runtime.run();
+        t = micros() - t;
+        if (t < run_time) run_time = t;
+        t = micros();
+        runtime.runDeferred();
+        t = micros() - t;
+        if (t < deferred_time) deferred_time = t;
+    }
+    offset = Serial.print(F("Benchmark \"deferred => 2000 loops\""));
+    for (; offset < 45; offset++) Serial.print(' ');
+    Serial.print(F("run ")); Serial.print((f32) run_time * 0.001, 3);
+    Serial.print(F(" ms / deferred ")); Serial.print((f32) deferred_time * 0.001, 3); Serial.print(F(" ms "));
+    Serial.println(deferred_time <= run_time ? F("Not slower") : F("SLOWER !!!"));
+}
+
+#ifdef PLCRUNTIME_REGISTER_ENGINE
+RuntimeRegisterEngine BenchmarkEngine;
+#endif // PLCRUNTIME_REGISTER_ENGINE
+
+// Abort an endless loop with the loop guard, the outputs are cleared and the looping jump is reported
+void UnitTest::loopGuard(VovkPLCRuntime& runtime) {
+    auto& program = runtime.program;
+    program.format();
+    program.push_u8(1);
+    program.push(DROP, type_u8);
+    u32 loop_index = program.prog_size;
+    program.push_jmp(0);
+    u32 offset = Serial.print(F("Test \"loop guard => JMP 0 forever\""));
+    runtime.loop_limit = 100;
+    set_u8(runtime.memory, runtime.output_offset, 0xFF);
+    u32 t = micros();
+    RuntimeError status = runtime.run();
+    t = micros() - t;
+    bool passed = status == PROGRAM_CYCLE_LIMIT_EXCEEDED && runtime.fault_index == loop_index;
+    passed = passed && memory_byte(runtime, runtime.output_offset) == 0;
+    // A stepped run gets a full budget of its own, 100 loops of 3 instructions
+    runtime.clear();
+    u32 steps = 0;
+    status = STATUS_SUCCESS;
+    while (status == STATUS_SUCCESS && steps < 1000) { status = runtime.step(program); steps++; }
+    passed = passed && status == PROGRAM_CYCLE_LIMIT_EXCEEDED && steps == 300;
+    // No limit, no guard
+    runtime.loop_limit = 0;
+    runtime.clear();
+    for (steps = 0; steps < 1000 && runtime.step(program) == STATUS_SUCCESS; steps++);
+    passed = passed && steps == 1000;
+#ifdef PLCRUNTIME_REGISTER_ENGINE
+    runtime.loop_limit = 100;
+    passed = passed && BenchmarkEngine.translate(runtime) == STATUS_SUCCESS;
+    passed = passed && BenchmarkEngine.run(runtime) == PROGRAM_CYCLE_LIMIT_EXCEEDED && runtime.fault_index == loop_index;
+#endif // PLCRUNTIME_REGISTER_ENGINE
+    runtime.loop_limit = PLCRUNTIME_LOOP_LIMIT;
+    f32 ms = (f32) t * 0.001;
+    for (; offset < 40; offset++) Serial.print(' ');
+    Serial.print(passed ? F("Passed") : F("FAILED !!!"));
+    Serial.print(F(" - ")); Serial.print(ms, 3); Serial.println(F(" ms"));
+}
+
+#ifdef PLCRUNTIME_REGISTER_ENGINE
+// Run the register engine after the program it translated was replaced and after it was modified in place
+void UnitTest::registerReload(VovkPLCRuntime& runtime) {
+    auto& program = runtime.program;
+    program.format();
+    program.push_pointer(20);
+    program.push_u8(7);
+    program.push_move(type_u8);
+    program.push(EXIT);
+    u32 offset = Serial.print(F("Test \"register => program reloaded\""));
+    u32 t = micros();
+    bool passed = BenchmarkEngine.translate(runtime) == STATUS_SUCCESS;
+    passed = passed && BenchmarkEngine.run(runtime) == STATUS_SUCCESS && memory_byte(runtime, 20) == 7;
+    // Same size, another value
+    program.format();
+    program.push_pointer(20);
+    u32 value_index = program.prog_size + 1;
+    program.push_u8(9);
+    program.push_move(type_u8);
+    program.push(EXIT);
+    passed = passed && BenchmarkEngine.run(runtime) == STATUS_SUCCESS && memory_byte(runtime, 20) == 9;
+    passed = passed && program.modify(value_index, 11) == STATUS_SUCCESS;
+    passed = passed && BenchmarkEngine.run(runtime) == STATUS_SUCCESS && memory_byte(runtime, 20) == 11;
+    t = micros() - t;
+    passed = passed && BenchmarkEngine.translated && BenchmarkEngine.dispatch_count > 0;
+    f32 ms = (f32) t * 0.001;
+    for (; offset < 40; offset++) Serial.print(' ');
+    Serial.print(passed ? F("Passed") : F("FAILED !!!"));
+    Serial.print(F(" - ")); Serial.print(ms, 3); Serial.println(F(" ms"));
+}
+#endif // PLCRUNTIME_REGISTER_ENGINE
+
+// Interpolate an f32 breakpoint table and a uniformly spaced i16 table, including the clamping at the ends
+void UnitTest::lookupTable(VovkPLCRuntime& runtime) {
+    const f32 curve[6] = { 0, 0, 10, 100, 30, 500 };
+    const i16 uniform[6] = { 0, 10, 0, 50, 200, 250 };
+    u16 header = 3;
+    writeArea_u8(runtime.memory, 20, (u8*) &header, 2);
+    writeArea_u8(runtime.memory, 22, (u8*) curve, sizeof(curve));
+    header = 4 | PLCRUNTIME_LUT_UNIFORM;
+    writeArea_u8(runtime.memory, 46, (u8*) &header, 2);
+    writeArea_u8(runtime.memory, 48, (u8*) uniform, sizeof(uniform));
+    // The x range -20000 .. 20000 does not fit into i16
+    const i16 wide[5] = { -20000, 20000, 0, 100, 200 };
+    header = 3 | PLCRUNTIME_LUT_UNIFORM;
+    writeArea_u8(runtime.memory, 60, (u8*) &header, 2);
+    writeArea_u8(runtime.memory, 62, (u8*) wide, sizeof(wide));
+    auto& program = runtime.program;
+    program.format();
+    program.push_pointer(20);
+    program.push_f32(25);
+    program.push(LUT_INTERP, type_f32);
+    program.push_pointer(46);
+    program.push_i16(15);
+    program.push(LUT_INTERP, type_i16);
+    program.push_pointer(46);
+    program.push_i16(100);
+    program.push(LUT_INTERP, type_i16);
+    program.push_pointer(20);
+    program.push_f32(-1);
+    program.push(LUT_INTERP, type_f32);
+    program.push_pointer(60);
+    program.push_i16(10000);
+    program.push(LUT_INTERP, type_i16);
+    u32 offset = Serial.print(F("Test \"lut => f32 search, i16 uniform\""));
+    u32 t = micros();
+    RuntimeError status = runtime.run();
+    t = micros() - t;
+    bool passed = status == STATUS_SUCCESS && runtime.stack.pop_i16() == 150 && runtime.stack.pop_f32() == 0;
+    passed = passed && runtime.stack.pop_i16() == 250 && runtime.stack.pop_i16() == 125 && runtime.stack.pop_f32() == 400;
+    f32 ms = (f32) t * 0.001;
+    for (; offset < 40; offset++) Serial.print(' ');
+    Serial.print(passed ? F("Passed") : F("FAILED !!!"));
+    Serial.print(F(" - ")); Serial.print(ms, 3); Serial.println(F(" ms"));
+}
+
+// Recursive sum of 4 + 3 + 2 + 1, every call keeps its argument in its own frame instead of a global address
+void UnitTest::frames(VovkPLCRuntime& runtime) {
+    u8 call[3];
+    auto& program = runtime.program;
+    program.format();
+    program.push_u8(4);
+    u32 sum = program.prog_size + sizeof(call) + 1;
+    program.push(call, InstructionCompiler::pushCALL(call, sum));
+    program.push(EXIT);
+    program.push_enter(1);
+    program.push_local_store(type_u8, 0);
+    program.push_local_load(type_u8, 0);
+    u32 branch = program.prog_size;
+    program.push_jmp_if_not(0);
+    program.push_local_load(type_u8, 0);
+    program.push_u8(1);
+    program.push(SUB, type_u8);
+    program.push(call, InstructionCompiler::pushCALL(call, sum));
+    program.push_local_load(type_u8, 0);
+    program.push(ADD, type_u8);
+    program.push(LEAVE);
+    program.push(RET);
+    InstructionCompiler::push_jmp_if_not(program.program + branch, program.prog_size);
+    program.push_u8(0);
+    program.push(LEAVE);
+    program.push(RET);
+    u32 offset = Serial.print(F("Test \"frames => recursive sum 4..1\""));
+    u32 t = micros();
+    RuntimeError status = runtime.run();
+    t = micros() - t;
+    bool passed = status == STATUS_SUCCESS && runtime.stack.pop_u8() == 10;
+    passed = passed && runtime.stack.call_stack.size() == 0 && runtime.stack.frame_top == 0 && runtime.stack.frame_pointer == 0;
+    // LEAVE in a call that did not ENTER, while the caller has a frame open
+    program.format();
+    program.push_enter(1);
+    u32 function = program.prog_size + sizeof(call) + 2;
+    program.push(call, InstructionCompiler::pushCALL(call, function));
+    program.push(LEAVE);
+    program.push(EXIT);
+    program.push(LEAVE);
+    program.push(RET);
+    passed = passed && runtime.run() == FRAME_UNDERFLOW && runtime.stack.frame_count == 1;
+    // RET with the frame of the call still open
+    program.format();
+    function = sizeof(call) + 1;
+    program.push(call, InstructionCompiler::pushCALL(call, function));
+    program.push(EXIT);
+    program.push_enter(1);
+    program.push(RET);
+    passed = passed && runtime.run() == FRAME_NOT_CLOSED && runtime.stack.call_stack.size() == 1;
+    f32 ms = (f32) t * 0.001;
+    for (; offset < 40; offset++) Serial.print(' ');
+    Serial.print(passed ? F("Passed") : F("FAILED !!!"));
+    Serial.print(F(" - ")); Serial.print(ms, 3); Serial.println(F(" ms"));
+}
+
+RuntimeProgramImage TestProgramImage;
+
+// Run a shared program image, the image is read-only while it is attached and released when an own program is built
+void UnitTest::programImage(VovkPLCRuntime& runtime) {
+    const u8 code[] = { type_u8, 2, type_u8, 3, ADD, type_u8 };
+    u8 checksum = 0;
+    crc8_simple(checksum, code, sizeof(code));
+    u32 offset = Serial.print(F("Test \"image => shared, read-only\""));
+    u32 t = micros();
+    bool passed = TestProgramImage.load(code, sizeof(code), checksum) == STATUS_SUCCESS;
+    passed = passed && runtime.attachProgram(TestProgramImage) == STATUS_SUCCESS && TestProgramImage.references == 1;
+#ifdef PLCRUNTIME_PROFILER
+    runtime.profiling = true;
+#endif // PLCRUNTIME_PROFILER
+    passed = passed && runtime.run() == STATUS_SUCCESS && runtime.stack.pop_u8() == 5;
+    t = micros() - t;
+#ifdef PLCRUNTIME_PROFILER
+    // The runtimes attached to the image count into its profile
+    runtime.profiling = false;
+    passed = passed && runtime.program.profile == TestProgramImage.profile && TestProgramImage.profile[4] == 1;
+#endif // PLCRUNTIME_PROFILER
+    passed = passed && runtime.program.modify(1, 7) == PROGRAM_READ_ONLY && TestProgramImage.load(code, sizeof(code), checksum) == PROGRAM_READ_ONLY;
+    runtime.program.format();
+    passed = passed && TestProgramImage.references == 0 && runtime.program.image == nullptr && runtime.program.size() == 0;
+#ifdef PLCRUNTIME_PROFILER
+    passed = passed && runtime.program.profile != TestProgramImage.profile;
+#endif // PLCRUNTIME_PROFILER
+    f32 ms = (f32) t * 0.001;
+    for (; offset < 40; offset++) Serial.print(' ');
+    Serial.print(passed ? F("Passed") : F("FAILED !!!"));
+    Serial.print(F(" - ")); Serial.print(ms, 3); Serial.println(F(" ms"));
+}
+
+// Parse a scale telegram: find the separator and the unit, compare the header, copy the first field, read the weight
+void UnitTest::strings(VovkPLCRuntime& runtime) {
+    const char telegram[] = "ST,GS,+  12.345kg";
+    writeArea_u8(runtime.memory, 30, (u8*) telegram, 17);
+    writeArea_u8(runtime.memory, 60, (u8*) "STkg", 4);
+    auto& program = runtime.program;
+    program.format();
+    program.push_pointer(30);
+    program.push_u16(17);
+    program.push_u8(',');
+    program.push(STR_FIND_BYTE);
+    program.push_pointer(30);
+    program.push_u16(17);
+    program.push_pointer(62);
+    program.push_u16(2);
+    program.push(STR_FIND);
+    program.push_pointer(30);
+    program.push_pointer(60);
+    program.push_u16(2);
+    program.push(STR_CMP);
+    program.push_pointer(70);
+    program.push_pointer(30);
+    program.push_u16(17);
+    program.push_u8(',');
+    program.push(STR_COPY_UNTIL);
+    program.push_pointer(36);
+    program.push_u16(11);
+    program.push(STR_ATOI);
+    program.push_pointer(50);
+    program.push_u16(8);
+    program.push_i32(-4071);
+    program.push(STR_ITOA);
+    u32 offset = Serial.print(F("Test \"strings => telegram parse\""));
+    u32 t = micros();
+    RuntimeError status = runtime.run();
+    t = micros() - t;
+    u8 text[5];
+    readArea_u8(runtime.memory, 50, text, 5);
+    bool passed = status == STATUS_SUCCESS && runtime.stack.pop_u16() == 5 && memcmp(text, "-4071", 5) == 0;
+    passed = passed && runtime.stack.pop_u16() == 5 && runtime.stack.pop_i32() == 12;
+    readArea_u8(runtime.memory, 70, text, 2);
+    passed = passed && runtime.stack.pop_u16() == 2 && memcmp(text, "ST", 2) == 0;
+    passed = passed && runtime.stack.pop_i8() == 0 && runtime.stack.pop_u16() == 15 && runtime.stack.pop_u16() == 2;
+    passed = passed && runtime.stack.size() == 0;
+    f32 ms = (f32) t * 0.001;
+    for (; offset < 40; offset++) Serial.print(' ');
+    Serial.print(passed ? F("Passed") : F("FAILED !!!"));
+    Serial.print(F(" - ")); Serial.print(ms, 3); Serial.println(F(" ms"));
+}
+
+#ifdef PLCRUNTIME_COMM
+// The host feeds "12," into the receive ring, the program parses it in place and queues 'K' in the transmit ring
+void UnitTest::comm(VovkPLCRuntime& runtime) {
+    auto& program = runtime.program;
+    program.format();
+    program.push_pointer(104);
+    program.push_u16(3);
+    program.push(STR_ATOI);
+    program.push_pointer(134);
+    program.push_u8('K');
+    program.push_move(type_u8);
+    program.push_pointer(130);
+    program.push_u16(1);
+    program.push_move(type_u16);
+    u32 offset = Serial.print(F("Test \"comm => rx parse, tx queue\""));
+    RuntimeComm& comm = runtime.comm;
+    u8 data[20];
+    for (u32 i = 0; i < sizeof(data); i++) data[i] = '0' + i % 10;
+    u32 t = micros();
+    bool passed = !comm.configure(runtime.memory, 0, 100, 16, 130, 16);
+    passed = passed && comm.receive(runtime.memory, 0, (const u8*) "12,", 3) == 3 && comm.space(runtime.memory, 0) == 12;
+    passed = passed && runtime.run() == STATUS_SUCCESS && runtime.stack.pop_u16() == 2 && runtime.stack.pop_i32() == 12;
+    t = micros() - t;
+    u8 sent[4];
+    passed = passed && comm.pending(runtime.memory, 0) == 1 && comm.transmit(runtime.memory, 0, sent, sizeof(sent)) == 1 && sent[0] == 'K';
+    passed = passed && comm.pending(runtime.memory, 0) == 0 && comm.receive(runtime.memory, 0, data, sizeof(data)) == 12;
+    comm.clear();
+    f32 ms = (f32) t * 0.001;
+    for (; offset < 40; offset++) Serial.print(' ');
+    Serial.print(passed ? F("Passed") : F("FAILED !!!"));
+    Serial.print(F(" - ")); Serial.print(ms, 3); Serial.println(F(" ms"));
+}
+#endif // PLCRUNTIME_COMM
+
+#ifdef PLCRUNTIME_PAGED_MEMORY
+// Pages are allocated on the first write only, a value at the end of the address space spans two of them
+void UnitTest::pagedMemory(VovkPLCRuntime& runtime) {
+    auto& program = runtime.program;
+    program.format();
+    program.push_pointer(20);
+    program.push_u8(5);
+    program.push_move(type_u8);
+    u32 offset = Serial.print(F("Test \"paged memory => lazy, span\""));
+    const u32 address = PLCRUNTIME_MAX_MEMORY_SIZE - PLCRUNTIME_PAGE_SIZE - 2;
+    u32 value = 0x12345678;
+    u32 result = 1;
+    runtime.formatMemory();
+    u32 t = micros();
+    bool passed = !readArea_u8(runtime.memory, address, (u8*) &result, 4) && result == 0 && runtime.pages.pages_used == 0;
+    passed = passed && !writeArea_u8(runtime.memory, address, (u8*) &value, 4) && runtime.pages.pages_used == 2;
+    passed = passed && !readArea_u8(runtime.memory, address, (u8*) &result, 4) && result == value;
+    passed = passed && runtime.run() == STATUS_SUCCESS && memory_byte(runtime, 20) == 5 && runtime.pages.pages_used == 3;
+    t = micros() - t;
+    passed = passed && set_u8(runtime.memory, PLCRUNTIME_MAX_MEMORY_SIZE, 1);
+    runtime.formatMemory();
+    passed = passed && runtime.pages.pages_used == 0 && memory_byte(runtime, address) == 0;
+    f32 ms = (f32) t * 0.001;
+    for (; offset < 40; offset++) Serial.print(' ');
+    Serial.print(passed ? F("Passed") : F("FAILED !!!"));
+    Serial.print(F(" - ")); Serial.print(ms, 3); Serial.println(F(" ms"));
+}
+#endif // PLCRUNTIME_PAGED_MEMORY
+
+#ifdef PLCRUNTIME_MATH_CACHE
+// The second scan with the same SQRT input is served from the cache, a new input computes it again
+void UnitTest::mathCache(VovkPLCRuntime& runtime) {
+    auto& program = runtime.program;
+    program.format();
+    program.push_pointer(20);
+    program.push_load(type_f32);
+    program.push(SQRT, type_f32);
+    u32 offset = Serial.print(F("Test \"math cache => SQRT hit, miss\""));
+    f32 x = 16.0f;
+    writeArea_u8(runtime.memory, 20, (u8*) &x, sizeof(x));
+    runtime.math_cache.clear();
+    runtime.math_cache.enabled = true;
+    u32 t = micros();
+    runtime.run();
+    f32 first = runtime.stack.pop_f32();
+    runtime.run();
+    f32 second = runtime.stack.pop_f32();
+    t = micros() - t;
+    bool passed = first > 3.999f && first < 4.001f && second == first && runtime.math_cache.hits == 1 && runtime.math_cache.misses == 1;
+    x = 2.25f;
+    writeArea_u8(runtime.memory, 20, (u8*) &x, sizeof(x));
+    runtime.run();
+    passed = passed && runtime.stack.pop_f32() != first && runtime.math_cache.misses == 2;
+    runtime.math_cache.clear();
+    runtime.math_cache.enabled = false;
+    f32 ms = (f32) t * 0.001;
+    for (; offset < 40; offset++) Serial.print(' ');
+    Serial.print(passed ? F("Passed") : F("FAILED !!!"));
+    Serial.print(F(" - ")); Serial.print(ms, 3); Serial.println(F(" ms"));
+}
+#endif // PLCRUNTIME_MATH_CACHE
+
+#ifdef PLCRUNTIME_SFC
+// Two step chart: step 0 waits for memory[21], step 1 counts its scans in memory[22] until memory[23] is set
+void UnitTest::chart(VovkPLCRuntime& runtime) {
+    auto& program = runtime.program;
+    program.format();
+    program.push(SFC);
+    program.push(EXIT);
+    u32 wait = program.prog_size;
+    program.push_pointer(21);
+    program.push_load(type_u8);
+    program.push(RET);
+    u32 count = program.prog_size;
+    program.push_pointer(22);
+    program.push_pointer(22);
+    program.push_load(type_u8);
+    program.push_u8(1);
+    program.push(ADD, type_u8);
+    program.push_move(type_u8);
+    program.push(RET);
+    u32 done = program.prog_size;
+    program.push_pointer(23);
+    program.push_load(type_u8);
+    program.push(RET);
+    u32 offset = Serial.print(F("Test \"sfc => wait, count 2 scans\""));
+    RuntimeSFC& sfc = runtime.sfc;
+    sfc.clear();
+    sfc.addStep(PLCRUNTIME_SFC_NONE);
+    sfc.addStep(count);
+    sfc.addTransition(0, 1, wait);
+    sfc.addTransition(1, 0, done);
+    sfc.setStateArea(24);
+    sfc.reset(0);
+    for (u32 i = 21; i < 25; i++) set_u8(runtime.memory, i, 0);
+    u32 t = micros();
+    bool passed = runtime.run() == STATUS_SUCCESS && sfc.isActive(0) && memory_byte(runtime, 24) == 1;
+    set_u8(runtime.memory, 21, 1);
+    passed = passed && runtime.run() == STATUS_SUCCESS && sfc.isActive(1) && !sfc.isActive(0) && memory_byte(runtime, 22) == 0;
+    runtime.run();
+    runtime.run();
+    t = micros() - t;
+    passed = passed && memory_byte(runtime, 22) == 2 && memory_byte(runtime, 24) == 2 && runtime.stack.size() == 0;
+    sfc.clear();
+    f32 ms = (f32) t * 0.001;
+    for (; offset < 40; offset++) Serial.print(' ');
+    Serial.print(passed ? F("Passed") : F("FAILED !!!"));
+    Serial.print(F(" - ")); Serial.print(ms, 3); Serial.println(F(" ms"));
+}
+#endif // PLCRUNTIME_SFC
+
+#ifdef PLCRUNTIME_REGISTER_ENGINE
+// Compare the stack engine with the register engine: dispatched instructions, execution time and result
+template <typename T> void UnitTest::benchmark(VovkPLCRuntime& runtime, const TestCase<T>& test) {
+    auto& program = runtime.program;
+    program.format();
+    if (test.build) test.build(program);
+    u32 offset = Serial.print(F("Benchmark \""));
+    offset += Serial.print(test.name);
+    offset += Serial.print('"');
+    for (; offset < 45; offset++) Serial.print(' ');
+    runtime.clear();
+    runtime.updateSystemMemory();
+    u32 stack_dispatches = 0;
+    u32 index = 0;
+    u32 t = micros();
+    while (index < program.prog_size) {
+        stack_dispatches++;
+        RuntimeError status = runtime.step(program.program, program.prog_size, index);
+        if (status != STATUS_SUCCESS) break;
+    }
+    u32 stack_time = micros() - t;
+    T stack_output = runtime.read<T>();
+    RuntimeError status = BenchmarkEngine.translate(runtime);
+    if (status != STATUS_SUCCESS) {
+        Serial.print(F("translation failed: ")); Serial.println(RUNTIME_ERROR_NAME(status));
+        return;
+    }
+    t = micros();
+    BenchmarkEngine.run(runtime);
+    u32 register_time = micros() - t;
+    T register_output = runtime.read<T>();
+    u32 register_dispatches = BenchmarkEngine.dispatch_count;
+    Serial.print(F("stack ")); print_number_padStart(stack_dispatches, 4, ' ');
+    Serial.print(F(" / register ")); print_number_padStart(register_dispatches, 4, ' ');
+    Serial.print(F(" dispatches ("));
+    f32 saved = stack_dispatches ? 100.0 * (1.0 - (f32) register_dispatches / (f32) stack_dispatches) : 0;
+    Serial.print(saved, 1); Serial.print(F("% fewer) - "));
+    Serial.print((f32) stack_time * 0.001, 3); Serial.print(F(" ms / ")); Serial.print((f32) register_time * 0.001, 3); Serial.print(F(" ms "));
+    Serial.println(stack_output == register_output ? F("Match") : F("MISMATCH !!!"));
+}
+#endif // PLCRUNTIME_REGISTER_ENGINE
+
 RuntimeError UnitTest::fullProgramDebug(VovkPLCRuntime& runtime) {
     runtime.clear();
     auto& program = runtime.program;
@@ -218,18 +917,22 @@ void runtime_unit_test(VovkPLCRuntime& runtime) {
     Tester.run(runtime, case_demo_uint64_t);
 #endif // USE_X64_OPS
     Tester.run(runtime, case_demo_int8_t);
+    Tester.run(runtime, case_math_int16_t);
     Tester.run(runtime, case_demo_float);
 #ifdef USE_X64_OPS
     Tester.run(runtime, case_demo_double);
 #endif // USE_X64_OPS
     Tester.run(runtime, case_bitwise_and_X8);
     Tester.run(runtime, case_bitwise_and_X16);
+    Tester.run(runtime, case_bitwise_lshift_X8);
     Tester.run(runtime, case_logic_and);
     Tester.run(runtime, case_logic_or);
     Tester.run(runtime, case_cmp_eq_1);
     Tester.run(runtime, case_cmp_eq_2);
     Tester.run(runtime, case_jump);
     Tester.run(runtime, case_jump_if);
+    Tester.run(runtime, case_load_move_f32);
+    Tester.run(runtime, case_program_builder);
     REPRINTLN(70, '-');
     REPRINTLN(70, '#');
     Serial.println(F("Runtime Unit Tests Completed."));
@@ -245,21 +948,87 @@ void runtime_unit_test(VovkPLCRuntime& runtime) {
     Tester.review(runtime, case_demo_uint64_t);
 #endif // USE_X64_OPS
     Tester.review(runtime, case_demo_int8_t);
+    Tester.review(runtime, case_math_int16_t);
     Tester.review(runtime, case_demo_float);
+    Tester.review(runtime, case_math_float);
 #ifdef USE_X64_OPS
     Tester.review(runtime, case_demo_double);
 #endif // USE_X64_OPS
     Tester.review(runtime, case_bitwise_and_X8);
     Tester.review(runtime, case_bitwise_and_X16);
+    Tester.review(runtime, case_bitwise_lshift_X8);
     Tester.review(runtime, case_logic_and);
     Tester.review(runtime, case_logic_or);
     Tester.review(runtime, case_cmp_eq_1);
     Tester.review(runtime, case_cmp_eq_2);
     Tester.review(runtime, case_jump);
     Tester.review(runtime, case_jump_if);
+    Tester.review(runtime, case_load_move_f32);
+    Tester.review(runtime, case_program_builder);
+#ifdef PLCRUNTIME_TREND_LOGGER
+    Tester.trend(runtime);
+#endif // PLCRUNTIME_TREND_LOGGER
+#ifdef PLCRUNTIME_CAPTURE
+    Tester.capture(runtime);
+#endif // PLCRUNTIME_CAPTURE
+#ifdef PLCRUNTIME_ALARMS
+    Tester.alarms(runtime);
+#endif // PLCRUNTIME_ALARMS
+#ifdef PLCRUNTIME_RECIPES
+    Tester.recipes(runtime);
+#endif // PLCRUNTIME_RECIPES
+#ifdef PLCRUNTIME_TAGS
+    Tester.tags(runtime);
+#endif // PLCRUNTIME_TAGS
+    Tester.deferred(runtime);
+    Tester.loopGuard(runtime);
+#ifdef PLCRUNTIME_REGISTER_ENGINE
+    Tester.registerReload(runtime);
+#endif // PLCRUNTIME_REGISTER_ENGINE
+    Tester.lookupTable(runtime);
+    Tester.frames(runtime);
+    Tester.programImage(runtime);
+    Tester.strings(runtime);
+#ifdef PLCRUNTIME_COMM
+    Tester.comm(runtime);
+#endif // PLCRUNTIME_COMM
+#ifdef PLCRUNTIME_PAGED_MEMORY
+    Tester.pagedMemory(runtime);
+#endif // PLCRUNTIME_PAGED_MEMORY
+#ifdef PLCRUNTIME_MATH_CACHE
+    Tester.mathCache(runtime);
+#endif // PLCRUNTIME_MATH_CACHE
+#ifdef PLCRUNTIME_SFC
+    Tester.chart(runtime);
+#endif // PLCRUNTIME_SFC
     REPRINTLN(70, '#');
     Serial.println(F("Runtime Unit Tests Report Completed."));
     REPRINTLN(70, '#');
+#ifdef PLCRUNTIME_REGISTER_ENGINE
+    Serial.println(F("Register engine benchmark:"));
+    REPRINTLN(70, '#');
+    Tester.benchmark(runtime, case_demo_uint8_t);
+    Tester.benchmark(runtime, case_demo_uint16_t);
+    Tester.benchmark(runtime, case_demo_uint32_t);
+#ifdef USE_X64_OPS
+    Tester.benchmark(runtime, case_demo_uint64_t);
+#endif // USE_X64_OPS
+    Tester.benchmark(runtime, case_demo_int8_t);
+    Tester.benchmark(runtime, case_demo_float);
+#ifdef USE_X64_OPS
+    Tester.benchmark(runtime, case_demo_double);
+#endif // USE_X64_OPS
+    Tester.benchmark(runtime, case_bitwise_and_X8);
+    Tester.benchmark(runtime, case_bitwise_and_X16);
+    Tester.benchmark(runtime, case_logic_and);
+    Tester.benchmark(runtime, case_logic_or);
+    Tester.benchmark(runtime, case_cmp_eq_1);
+    Tester.benchmark(runtime, case_cmp_eq_2);
+    Tester.benchmark(runtime, case_jump);
+    Tester.benchmark(runtime, case_jump_if);
+    Tester.benchmark(runtime, case_load_move_f32);
+    REPRINTLN(70, '#');
+#endif // PLCRUNTIME_REGISTER_ENGINE
     Serial.flush();
 };
 
@@ -62,6 +62,45 @@ struct UnitTest {
 #endif
 
     template <typename T> void review(VovkPLCRuntime& runtime, const TestCase<T>& test);
+#ifdef PLCRUNTIME_REGISTER_ENGINE
+    template <typename T> void benchmark(VovkPLCRuntime& runtime, const TestCase<T>& test);
+#endif // PLCRUNTIME_REGISTER_ENGINE
+#ifdef PLCRUNTIME_TREND_LOGGER
+    void trend(VovkPLCRuntime& runtime);
+#endif // PLCRUNTIME_TREND_LOGGER
+#ifdef PLCRUNTIME_CAPTURE
+    void capture(VovkPLCRuntime& runtime);
+#endif // PLCRUNTIME_CAPTURE
+#ifdef PLCRUNTIME_ALARMS
+    void alarms(VovkPLCRuntime& runtime);
+#endif // PLCRUNTIME_ALARMS
+#ifdef PLCRUNTIME_RECIPES
+    void recipes(VovkPLCRuntime& runtime);
+#endif // PLCRUNTIME_RECIPES
+#ifdef PLCRUNTIME_TAGS
+    void tags(VovkPLCRuntime& runtime);
+#endif // PLCRUNTIME_TAGS
+    void deferred(VovkPLCRuntime& runtime);
+    void loopGuard(VovkPLCRuntime& runtime);
+#ifdef PLCRUNTIME_REGISTER_ENGINE
+    void registerReload(VovkPLCRuntime& runtime);
+#endif // PLCRUNTIME_REGISTER_ENGINE
+    void lookupTable(VovkPLCRuntime& runtime);
+    void frames(VovkPLCRuntime& runtime);
+    void programImage(VovkPLCRuntime& runtime);
+    void strings(VovkPLCRuntime& runtime);
+#ifdef PLCRUNTIME_COMM
+    void comm(VovkPLCRuntime& runtime);
+#endif // PLCRUNTIME_COMM
+#ifdef PLCRUNTIME_PAGED_MEMORY
+    void pagedMemory(VovkPLCRuntime& runtime);
+#endif // PLCRUNTIME_PAGED_MEMORY
+#ifdef PLCRUNTIME_MATH_CACHE
+    void mathCache(VovkPLCRuntime& runtime);
+#endif // PLCRUNTIME_MATH_CACHE
+#ifdef PLCRUNTIME_SFC
+    void chart(VovkPLCRuntime& runtime);
+#endif // PLCRUNTIME_SFC
 
     static RuntimeError fullProgramDebug(VovkPLCRuntime& runtime);
 
@@ -119,6 +158,15 @@ const TestCase<i8> case_demo_int8_t({ "demo_int8_t => (1 - 2) * 3", STATUS_SUCCE
     program.push(MUL, type_i8);
 } });
 
+const TestCase<i16> case_math_int16_t({ "math_int16_t => abs(-2 ^ 3) % 5", STATUS_SUCCESS, 3, [](RuntimeProgram& program) {
+    program.push_i16(-2);
+    program.push_i16(3);
+    program.push(POW, type_i16);
+    program.push(ABS, type_i16);
+    program.push_i16(5);
+    program.push(MOD, type_i16);
+} });
+
 const TestCase<float> case_demo_float({ "demo_float => (0.1 + 0.2) * -1", STATUS_SUCCESS, -0.3, [](RuntimeProgram& program) {
     program.push_f32(0.1);
     program.push_f32(0.2);
@@ -127,6 +175,16 @@ const TestCase<float> case_demo_float({ "demo_float => (0.1 + 0.2) * -1", STATUS
     program.push(MUL, type_f32);
 } });
 
+const TestCase<float> case_math_float({ "math_float => 2 ^ -2 + 0.5 ^ 300", STATUS_SUCCESS, 0.25, [](RuntimeProgram& program) {
+    program.push_f32(2);
+    program.push_f32(-2);
+    program.push(POW, type_f32);
+    program.push_f32(0.5);
+    program.push_f32(300);
+    program.push(POW, type_f32);
+    program.push(ADD, type_f32);
+} });
+
 #ifdef USE_X64_OPS
 const TestCase<f64> case_demo_double({ "demo_double => (0.1 + 0.2) * -1", STATUS_SUCCESS, -0.30000000000000004, [](RuntimeProgram& program) {
     program.push_f64(0.1);
@@ -148,6 +206,11 @@ const TestCase<u16> case_bitwise_and_X16({ "bitwise_and_X16", STATUS_SUCCESS, 0x
     program.push_u16(0xF00F);
     program.push(BW_AND_X16);
 } });
+const TestCase<u8> case_bitwise_lshift_X8({ "bitwise_lshift_X8 => 3 << 2", STATUS_SUCCESS, 12, [](RuntimeProgram& program) {
+    program.push_u8(3);
+    program.push_u8(2);
+    program.push(BW_LSHIFT_X8);
+} });
 
 // Logic (boolean) operations
 const TestCase<bool> case_logic_and({ "logic_and => true && true", STATUS_SUCCESS, true, [](RuntimeProgram& program) {
@@ -231,6 +294,31 @@ const TestCase<u8> case_jump_if({ "jump_if => for loop sum", PROGRAM_EXITED, 100
     program.modifyValue(loop_jump + 1, end_destination); // Change the jump address to the exit address
 } });
 
+// Memory operations
+const TestCase<f32> case_load_move_f32({ "load_move_f32 => 1.5 * 1.5", STATUS_SUCCESS, 2.25, [](RuntimeProgram& program) {
+    program.push_pointer(4);             // [4]
+    program.push_f32(1.5);               // [4, 1.5]
+    program.push_move(type_f32);         // []
+    program.push_pointer(4);             // [4]
+    program.push_load(type_f32);         // [1.5]
+    program.push_copy(type_f32);         // [1.5, 1.5]
+    program.push(MUL, type_f32);         // [2.25]
+} });
+
+// Program assembled at compile time
+enum { builder_skip };
+typedef PLCBuilder::Program<
+    PLCBuilder::PushBool<true>,
+    PLCBuilder::JumpIf<builder_skip>,
+    PLCBuilder::PushU8<5>,
+    PLCBuilder::Op<EXIT>,
+    PLCBuilder::Label<builder_skip>,
+    PLCBuilder::PushU8<7>
+> BuilderJumpProgram;
+const TestCase<u8> case_program_builder({ "program_builder => jump_if over push 5 to push 7", STATUS_SUCCESS, 7, [](RuntimeProgram& program) {
+    program.push(BuilderJumpProgram::bytecode(), BuilderJumpProgram::size);
+} });
+
 void runtime_unit_test(VovkPLCRuntime& runtime);
 
 #else // __RUNTIME_UNIT_TEST__
@@ -118,6 +118,15 @@ void byteToHex(u8 byte, char& c1, char& c2) {
     if (c2 > '9') c2 += 'A' - '9' - 1;
 }
 
+void printHex(u64 value, u8 size) {
+    char c1, c2;
+    for (u8 i = size; i > 0; i--) {
+        byteToHex((value >> ((i - 1) * 8)) & 0xFF, c1, c2);
+        Serial.print(c1);
+        Serial.print(c2);
+    }
+}
+
 
 // BCD to DEC
 u8 bcd2dec(u8 bcd) { return ((bcd >> 4) * 10) + (bcd & 0xF); }
@@ -127,20 +136,46 @@ u8 dec2bcd(u8 dec) { return ((dec / 10) << 4) + (dec % 10); }
 
 
 
-bool get_u8(u8* memory, u32 offset, u8& value) {
+#ifdef PLCRUNTIME_PAGED_MEMORY
+
+bool get_u8(plc_memory_t memory, u32 offset, u8& value) {
+    return memory->read(offset, &value, 1);
+}
+
+bool set_u8(plc_memory_t memory, u32 offset, u8 value) {
+    return memory->write(offset, &value, 1);
+}
+
+
+bool readArea_u8(plc_memory_t memory, u32 offset, u8* value, u32 size) {
+    return memory->read(offset, value, size);
+}
+
+bool writeArea_u8(plc_memory_t memory, u32 offset, u8* value, u32 size) {
+    return memory->write(offset, value, size);
+}
+
+u8 peek_u8(plc_memory_t memory, u32 offset) {
+    u8* page = memory->page(offset, false);
+    return page ? page[offset % PLCRUNTIME_PAGE_SIZE] : 0;
+}
+
+#else
+
+bool get_u8(plc_memory_t memory, u32 offset, u8& value) {
     if (offset >= PLCRUNTIME_MAX_MEMORY_SIZE) return true;
     value = memory[offset];
     return false;
 }
 
-bool set_u8(u8* memory, u32 offset, u8 value) {
+bool set_u8(plc_memory_t memory, u32 offset, u8 value) {
     if (offset >= PLCRUNTIME_MAX_MEMORY_SIZE) return true;
     memory[offset] = value;
     return false;
 }
 
 
-bool readArea_u8(u8* memory, u32 offset, u8* value, u32 size) {
+bool readArea_u8(plc_memory_t memory, u32 offset, u8* value, u32 size) {
     if (offset + size > PLCRUNTIME_MAX_MEMORY_SIZE) return true;
     for (u32 i = 0; i < size; i++) {
         value[i] = memory[offset + i];
@@ -148,7 +183,7 @@ bool readArea_u8(u8* memory, u32 offset, u8* value, u32 size) {
     return false;
 }
 
-bool writeArea_u8(u8* memory, u32 offset, u8* value, u32 size) {
+bool writeArea_u8(plc_memory_t memory, u32 offset, u8* value, u32 size) {
     if (offset + size > PLCRUNTIME_MAX_MEMORY_SIZE) return true;
     for (u32 i = 0; i < size; i++) {
         memory[offset + i] = value[i];
@@ -156,6 +191,12 @@ bool writeArea_u8(u8* memory, u32 offset, u8* value, u32 size) {
     return false;
 }
 
+u8 peek_u8(plc_memory_t memory, u32 offset) {
+    return memory[offset];
+}
+
+#endif // PLCRUNTIME_PAGED_MEMORY
+
 
 
 #ifdef __SIMULATOR__
@@ -128,6 +128,8 @@ void processExit();
 
 void fstrcpy(char* buff, const char* fstr);
 void byteToHex(u8 byte, char& c1, char& c2);
+// Print the 'size' low bytes of the value as hex, the most significant byte first
+void printHex(u64 value, u8 size);
 
 // Define an empty F() macro if it isn't defined, so that the code can be compiled on non-Arduino platforms
 #ifndef F 
@@ -171,10 +173,20 @@ u8 bcd2dec(u8 bcd);
 // DEC to BCD
 u8 dec2bcd(u8 dec);
 
-bool get_u8(u8* memory, u32 offset, u8& value);
-bool set_u8(u8* memory, u32 offset, u8 value);
-bool readArea_u8(u8* memory, u32 offset, u8* value, u32 size);
-bool writeArea_u8(u8* memory, u32 offset, u8* value, u32 size);
+// The PLC memory is a flat array by default, or a sparse page table with PLCRUNTIME_PAGED_MEMORY
+#ifdef PLCRUNTIME_PAGED_MEMORY
+#include "memory/runtime-paged-memory.h"
+typedef RuntimePagedMemory* plc_memory_t;
+#else
+typedef u8* plc_memory_t;
+#endif // PLCRUNTIME_PAGED_MEMORY
+
+bool get_u8(plc_memory_t memory, u32 offset, u8& value);
+bool set_u8(plc_memory_t memory, u32 offset, u8 value);
+bool readArea_u8(plc_memory_t memory, u32 offset, u8* value, u32 size);
+bool writeArea_u8(plc_memory_t memory, u32 offset, u8* value, u32 size);
+// Read without the bounds check, for callers that checked the whole range once
+u8 peek_u8(plc_memory_t memory, u32 offset);
 
 u8* ___reverse_byte_order_ptr = 0;
 u8* ___reverse_byte_order_res_ptr = 0;
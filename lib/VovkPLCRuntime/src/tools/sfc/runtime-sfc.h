@@ -0,0 +1,163 @@
+// runtime-sfc.h - 1.0.0 - 2022-12-11
+//
+// Copyright (c) 2022 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+// Sequential function chart
+// A chart is a list of steps and transitions. The action of a step and the condition of a transition are bytecode
+// segments of the loaded program, entered like a CALL and left with RET. A condition leaves a bool on the stack.
+// The active steps are kept as a bitset, and the SFC instruction only visits its set bits:
+//   1. the action of every active step runs
+//   2. the transitions leaving the active steps are evaluated in the order they were added, the first one that is
+//      true moves its step to the target step
+// All transitions of a scan see the same active set, the new set is active from the next SFC on. The cost of a
+// scan depends on the number of active steps and their transitions, not on the size of the chart.
+
+#ifndef PLCRUNTIME_SFC_MAX_STEPS
+#define PLCRUNTIME_SFC_MAX_STEPS 32
+#endif // PLCRUNTIME_SFC_MAX_STEPS
+
+#ifndef PLCRUNTIME_SFC_MAX_TRANSITIONS
+#define PLCRUNTIME_SFC_MAX_TRANSITIONS 32
+#endif // PLCRUNTIME_SFC_MAX_TRANSITIONS
+
+#define PLCRUNTIME_SFC_WORDS ((PLCRUNTIME_SFC_MAX_STEPS + 31) / 32)
+#define PLCRUNTIME_SFC_NONE 0xFFFF // No action / always true condition / end of the transition list
+
+struct SfcStep {
+    u16 action; // Program offset of the action segment
+    u16 first;  // First transition leaving the step
+    u16 last;   // Last transition leaving the step, new transitions are appended to it
+};
+
+struct SfcTransition {
+    u16 condition; // Program offset of the condition segment
+    u16 target;    // Step activated by the transition
+    u16 next;      // Next transition leaving the same step
+};
+
+class RuntimeSFC {
+public:
+    SfcStep steps[PLCRUNTIME_SFC_MAX_STEPS];
+    SfcTransition transitions[PLCRUNTIME_SFC_MAX_TRANSITIONS];
+    u32 active[PLCRUNTIME_SFC_WORDS];
+    u16 step_count = 0;
+    u16 transition_count = 0;
+    u16 initial = 0;
+    u32 state_address = 0; // The active bitset is copied to the memory after every scan if state_size > 0
+    u8 state_size = 0;
+
+    RuntimeSFC() { clear(); }
+
+    void clear() {
+        step_count = 0;
+        transition_count = 0;
+        initial = 0;
+        state_size = 0;
+        for (u32 i = 0; i < PLCRUNTIME_SFC_WORDS; i++) active[i] = 0;
+    }
+
+    // Add a step with the given action segment (PLCRUNTIME_SFC_NONE for none), returns true on error
+    bool addStep(u16 action) {
+        if (step_count >= PLCRUNTIME_SFC_MAX_STEPS) return true;
+        SfcStep& step = steps[step_count++];
+        step.action = action;
+        step.first = PLCRUNTIME_SFC_NONE;
+        step.last = PLCRUNTIME_SFC_NONE;
+        return false;
+    }
+
+    // Add a transition between two steps, the condition PLCRUNTIME_SFC_NONE is always true. Returns true on error
+    bool addTransition(u16 from, u16 to, u16 condition) {
+        if (from >= step_count || to >= step_count || transition_count >= PLCRUNTIME_SFC_MAX_TRANSITIONS) return true;
+        u16 index = transition_count++;
+        SfcTransition& transition = transitions[index];
+        transition.condition = condition;
+        transition.target = to;
+        transition.next = PLCRUNTIME_SFC_NONE;
+        SfcStep& step = steps[from];
+        if (step.last == PLCRUNTIME_SFC_NONE) step.first = index;
+        else transitions[step.last].next = index;
+        step.last = index;
+        return false;
+    }
+
+    // Copy the active steps into the memory after every scan, the first byte holds the lowest steps. Returns true on error
+    bool setStateArea(u32 address) {
+        u8 size = (step_count + 7) / 8;
+        if (size == 0 || address + size > PLCRUNTIME_MAX_MEMORY_SIZE) return true;
+        state_address = address;
+        state_size = size;
+        return false;
+    }
+
+    // Deactivate all steps and activate the initial step, returns true on error
+    bool reset(u16 step = 0) {
+        if (step >= step_count) return true;
+        initial = step;
+        for (u32 i = 0; i < PLCRUNTIME_SFC_WORDS; i++) active[i] = 0;
+        active[step / 32] |= (u32) 1 << (step % 32);
+        return false;
+    }
+
+    bool isActive(u16 step) const { return step < step_count && (active[step / 32] >> (step % 32)) & 1; }
+
+    // One chart scan, the runtime executes the segments
+    template <typename Runtime> RuntimeError scan(Runtime& runtime) {
+        for (u32 w = 0; w < PLCRUNTIME_SFC_WORDS; w++) {
+            u32 bits = active[w];
+            for (u16 step = w * 32; bits; step++, bits >>= 1) {
+                if (!(bits & 1) || steps[step].action == PLCRUNTIME_SFC_NONE) continue;
+                RuntimeError status = runtime.runSegment(steps[step].action);
+                if (status != STATUS_SUCCESS) return status;
+            }
+        }
+        // A step can be left and entered in the same scan, so the changes are collected apart
+        u32 leave[PLCRUNTIME_SFC_WORDS];
+        u32 enter[PLCRUNTIME_SFC_WORDS];
+        for (u32 w = 0; w < PLCRUNTIME_SFC_WORDS; w++) leave[w] = enter[w] = 0;
+        for (u32 w = 0; w < PLCRUNTIME_SFC_WORDS; w++) {
+            u32 bits = active[w];
+            for (u16 step = w * 32; bits; step++, bits >>= 1) {
+                if (!(bits & 1)) continue;
+                for (u16 t = steps[step].first; t != PLCRUNTIME_SFC_NONE; t = transitions[t].next) {
+                    const SfcTransition& transition = transitions[t];
+                    bool fire = true;
+                    if (transition.condition != PLCRUNTIME_SFC_NONE) {
+                        u32 size = runtime.stack.size();
+                        RuntimeError status = runtime.runSegment(transition.condition);
+                        if (status != STATUS_SUCCESS) return status;
+                        if (runtime.stack.size() <= size) return STACK_UNDERFLOW;
+                        fire = runtime.stack.pop_bool();
+                    }
+                    if (!fire) continue;
+                    leave[w] |= (u32) 1 << (step % 32);
+                    enter[transition.target / 32] |= (u32) 1 << (transition.target % 32);
+                    break;
+                }
+            }
+        }
+        for (u32 w = 0; w < PLCRUNTIME_SFC_WORDS; w++) active[w] = (active[w] & ~leave[w]) | enter[w];
+        if (state_size) {
+            for (u8 i = 0; i < state_size; i++) set_u8(runtime.memory, state_address + i, (active[i / 4] >> ((i % 4) * 8)) & 0xFF);
+        }
+        return STATUS_SUCCESS;
+    }
+};
@@ -29,6 +29,10 @@ RuntimeStack::RuntimeStack() {
 void RuntimeStack::format() {
     stack.format();
     call_stack.format();
+    frame_pointer = 0;
+    frame_top = 0;
+    frame_depth = 0;
+    frame_count = 0;
 }
 int RuntimeStack::print() { return stack.print(); }
 void RuntimeStack::println() { stack.println(); }
@@ -41,6 +45,25 @@ u16 RuntimeStack::popCall() {
     if (call_stack.size() == 0) return STACK_UNDERFLOW;
     return call_stack.pop();
 }
+RuntimeError RuntimeStack::enterFrame(u8 size) {
+    if (frame_count >= PLCRUNTIME_MAX_FRAMES || frame_top + size > PLCRUNTIME_MAX_FRAME_SIZE) return STACK_OVERFLOW;
+    saved_frame_pointer[frame_count] = frame_pointer;
+    saved_frame_depth[frame_count] = frame_depth;
+    frame_count++;
+    frame_pointer = frame_top;
+    frame_depth = call_stack.size();
+    frame_top += size;
+    memset(frame + frame_pointer, 0, size);
+    return STATUS_SUCCESS;
+}
+RuntimeError RuntimeStack::leaveFrame() {
+    if (!frameOpen()) return FRAME_UNDERFLOW; // LEAVE without ENTER in this call
+    frame_count--;
+    frame_top = frame_pointer;
+    frame_pointer = saved_frame_pointer[frame_count];
+    frame_depth = saved_frame_depth[frame_count];
+    return STATUS_SUCCESS;
+}
 // Push an u8 value to the stack
 RuntimeError RuntimeStack::push(u8 value) {
     if (stack.size() >= PLCRUNTIME_MAX_STACK_SIZE) return STACK_OVERFLOW;
@@ -54,25 +77,24 @@ void RuntimeStack::pop(int size) { stack.pop(size); }
 // Peek the top u8 value from the stack
 u8 RuntimeStack::peek(int depth) { return stack.peek(depth); }
 
+// Custom sized values use the same byte order as the typed push/pop methods (MSB first, LSB on top of the stack)
 template <typename T> bool RuntimeStack::push_custom(T value) {
     if (stack.size() + sizeof(T) > PLCRUNTIME_MAX_STACK_SIZE) return true;
     for (u32 i = 0; i < sizeof(T); i++) {
-        // stack.push((value >> (8 * (sizeof(T) - i - 1))) & 0xFF);
-        stack.push((value >> (8 * i)) & 0xFF);
+        stack.push((value >> (8 * (sizeof(T) - i - 1))) & 0xFF);
     }
     return false;
 }
 
 template <typename T> T RuntimeStack::pop_custom() {
     T value = 0;
-    // for (u32 i = 0; i < sizeof(T); i++) value |= (stack.pop() << (8 * (sizeof(T) - i - 1)));
-    for (u32 i = 0; i < sizeof(T); i++) value |= (stack.pop() << (8 * i));
+    for (u32 i = 0; i < sizeof(T); i++) value |= ((T) stack.pop() << (8 * i));
     return value;
 }
 
 template <typename T> T RuntimeStack::peek_custom() {
     T value = 0;
-    for (u32 i = 0; i < sizeof(T); i++) value |= (stack.peek(i) << (8 * i));
+    for (u32 i = 0; i < sizeof(T); i++) value |= ((T) stack.peek(i) << (8 * i));
     return value;
 }
 
@@ -227,12 +249,19 @@ f64 RuntimeStack::peek_f64() { u64_to_f64 cvt; cvt.type_u64 = peek_u64(); return
 #endif // USE_X64_OPS
 
 u32 RuntimeStack::size() { return stack.size(); }
-void RuntimeStack::clear() { while (!stack.empty()) stack.pop(); while (!call_stack.empty()) call_stack.pop(); }
+void RuntimeStack::clear() {
+    while (!stack.empty()) stack.pop();
+    while (!call_stack.empty()) call_stack.pop();
+    frame_pointer = 0;
+    frame_top = 0;
+    frame_depth = 0;
+    frame_count = 0;
+}
 
 
 
 
-template <typename T> RuntimeError RuntimeStack::load_from_memory_to_stack(u8* memory) {
+template <typename T> RuntimeError RuntimeStack::load_from_memory_to_stack(plc_memory_t memory) {
     if (stack.size() < sizeof(MY_PTR_t)) return  RuntimeError::STACK_UNDERFLOW;
     MY_PTR_t address = pop_pointer();
     if (address + sizeof(T) > PLCRUNTIME_MAX_MEMORY_SIZE) return  RuntimeError::INVALID_MEMORY_ADDRESS;
@@ -244,7 +273,7 @@ template <typename T> RuntimeError RuntimeStack::load_from_memory_to_stack(u8* m
     return  RuntimeError::STATUS_SUCCESS;
 }
 
-template <typename T> RuntimeError RuntimeStack::store_from_stack_to_memory(u8* memory, bool copy) {
+template <typename T> RuntimeError RuntimeStack::store_from_stack_to_memory(plc_memory_t memory, bool copy) {
     if (stack.size() < (sizeof(T) + sizeof(MY_PTR_t))) return  RuntimeError::STACK_UNDERFLOW;
     T value = pop_custom<T>();
     MY_PTR_t address = pop_pointer();
@@ -255,7 +284,7 @@ template <typename T> RuntimeError RuntimeStack::store_from_stack_to_memory(u8*
     return error ? RuntimeError::STACK_OVERFLOW : RuntimeError::STATUS_SUCCESS;
 }
 
-RuntimeError RuntimeStack::load_from_memory_to_stack(u8* memory, u8 data_type) {
+RuntimeError RuntimeStack::load_from_memory_to_stack(plc_memory_t memory, u8 data_type) {
     switch (data_type) {
         case type_pointer: return load_from_memory_to_stack<MY_PTR_t>(memory);
         case type_bool:
@@ -276,7 +305,7 @@ RuntimeError RuntimeStack::load_from_memory_to_stack(u8* memory, u8 data_type) {
     return RuntimeError::INVALID_DATA_TYPE;
 }
 
-RuntimeError RuntimeStack::store_from_stack_to_memory(u8* memory, u8 data_type, bool copy) {
+RuntimeError RuntimeStack::store_from_stack_to_memory(plc_memory_t memory, u8 data_type, bool copy) {
     switch (data_type) {
         case type_pointer: return store_from_stack_to_memory<MY_PTR_t>(memory, copy);
         case type_bool:
@@ -295,4 +324,62 @@ RuntimeError RuntimeStack::store_from_stack_to_memory(u8* memory, u8 data_type,
         default: return RuntimeError::INVALID_DATA_TYPE;
     }
     return RuntimeError::INVALID_DATA_TYPE;
-}
\ No newline at end of file
+}
+
+// Frame values use the same byte order as the memory
+template <typename T> RuntimeError RuntimeStack::load_from_frame_to_stack(u8 offset) {
+    u32 address = frame_pointer + offset;
+    if (address + sizeof(T) > frame_top) return RuntimeError::INVALID_MEMORY_ADDRESS;
+    T value = 0;
+    memcpy(&value, frame + address, sizeof(T));
+    return push_custom(value) ? RuntimeError::STACK_OVERFLOW : RuntimeError::STATUS_SUCCESS;
+}
+
+template <typename T> RuntimeError RuntimeStack::store_from_stack_to_frame(u8 offset) {
+    if (stack.size() < sizeof(T)) return RuntimeError::STACK_UNDERFLOW;
+    u32 address = frame_pointer + offset;
+    if (address + sizeof(T) > frame_top) return RuntimeError::INVALID_MEMORY_ADDRESS;
+    T value = pop_custom<T>();
+    memcpy(frame + address, &value, sizeof(T));
+    return RuntimeError::STATUS_SUCCESS;
+}
+
+RuntimeError RuntimeStack::load_from_frame_to_stack(u8 offset, u8 data_type) {
+    switch (data_type) {
+        case type_pointer: return load_from_frame_to_stack<MY_PTR_t>(offset);
+        case type_bool:
+        case type_u8:
+        case type_i8: return load_from_frame_to_stack<u8>(offset);
+        case type_u16:
+        case type_i16: return load_from_frame_to_stack<u16>(offset);
+        case type_u32:
+        case type_i32:
+        case type_f32: return load_from_frame_to_stack<u32>(offset);
+#ifdef USE_X64_OPS
+        case type_u64:
+        case type_i64:
+        case type_f64: return load_from_frame_to_stack<u64>(offset);
+#endif // USE_X64_OPS
+        default: return RuntimeError::INVALID_DATA_TYPE;
+    }
+}
+
+RuntimeError RuntimeStack::store_from_stack_to_frame(u8 offset, u8 data_type) {
+    switch (data_type) {
+        case type_pointer: return store_from_stack_to_frame<MY_PTR_t>(offset);
+        case type_bool:
+        case type_u8:
+        case type_i8: return store_from_stack_to_frame<u8>(offset);
+        case type_u16:
+        case type_i16: return store_from_stack_to_frame<u16>(offset);
+        case type_u32:
+        case type_i32:
+        case type_f32: return store_from_stack_to_frame<u32>(offset);
+#ifdef USE_X64_OPS
+        case type_u64:
+        case type_i64:
+        case type_f64: return store_from_stack_to_frame<u64>(offset);
+#endif // USE_X64_OPS
+        default: return RuntimeError::INVALID_DATA_TYPE;
+    }
+}
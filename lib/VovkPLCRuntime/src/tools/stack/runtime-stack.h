@@ -29,6 +29,16 @@ class RuntimeStack {
 public:
     Stack<u8> stack = Stack<u8>();
     Stack<u16> call_stack = Stack<u16>();
+    // Local variables of the active calls. ENTER saves the current frame on the frame stack and reserves the bytes
+    // above frame_top, LEAVE frees them and restores the saved frame. A frame belongs to the call that opened it,
+    // LEAVE from another call and RET while it is open are errors.
+    u8 frame[PLCRUNTIME_MAX_FRAME_SIZE];
+    u16 frame_pointer = 0; // Start of the current frame
+    u16 frame_top = 0; // End of the current frame
+    u16 frame_depth = 0; // Call stack depth at which the current frame was opened
+    u16 frame_count = 0; // Open frames
+    u16 saved_frame_pointer[PLCRUNTIME_MAX_FRAMES]; // Frame pointers of the enclosing frames
+    u16 saved_frame_depth[PLCRUNTIME_MAX_FRAMES]; // Call stack depths of the enclosing frames
 
     // Create a stack with a maximum size
     RuntimeStack();
@@ -42,6 +52,13 @@ public:
 
     u16 popCall();
 
+    // Open a zeroed frame of 'size' bytes for the current call
+    RuntimeError enterFrame(u8 size);
+    // Close the current frame and restore the frame of the caller
+    RuntimeError leaveFrame();
+    // True if the current call opened a frame that is not closed yet
+    bool frameOpen() { return frame_count > 0 && frame_depth == call_stack.size(); }
+
     // Push an u8 value to the stack
     RuntimeError push(u8 value);
     // Pop an u8 value from the stack
@@ -128,10 +145,14 @@ public:
     f64 peek_f64();
 #endif // USE_X64_OPS
 
-    RuntimeError load_from_memory_to_stack(u8* memory, u8 data_type);
-    RuntimeError store_from_stack_to_memory(u8* memory, u8 data_type, bool copy = false);
-    template <typename T> RuntimeError load_from_memory_to_stack(u8* memory);
-    template <typename T> RuntimeError store_from_stack_to_memory(u8* memory, bool copy = false);
+    RuntimeError load_from_memory_to_stack(plc_memory_t memory, u8 data_type);
+    RuntimeError store_from_stack_to_memory(plc_memory_t memory, u8 data_type, bool copy = false);
+    template <typename T> RuntimeError load_from_memory_to_stack(plc_memory_t memory);
+    template <typename T> RuntimeError store_from_stack_to_memory(plc_memory_t memory, bool copy = false);
+    RuntimeError load_from_frame_to_stack(u8 offset, u8 data_type);
+    RuntimeError store_from_stack_to_frame(u8 offset, u8 data_type);
+    template <typename T> RuntimeError load_from_frame_to_stack(u8 offset);
+    template <typename T> RuntimeError store_from_stack_to_frame(u8 offset);
 
     u32 size();
     void clear();
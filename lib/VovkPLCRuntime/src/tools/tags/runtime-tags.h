@@ -0,0 +1,120 @@
+// runtime-tags.h - 1.0.0 - 2022-12-11
+//
+// Copyright (c) 2022 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+// Tag database
+// The assembler emits a table of the declared tags ('tag <name> <type> <address>'), which is loaded into the
+// runtime next to the program. The names themselves are not stored, only their 32-bit FNV-1a hash, so a name is
+// resolved by hashing it and probing an open addressing index. Two names with the same hash are rejected by the
+// assembler and by load().
+//
+// Table format (all numbers are big-endian):
+//   <u16 count> { <u32 name_hash> <u32 address> <u8 type> <u8 size> }
+
+#ifndef PLCRUNTIME_TAG_MAX_COUNT
+#define PLCRUNTIME_TAG_MAX_COUNT 16
+#endif // PLCRUNTIME_TAG_MAX_COUNT
+
+// Power of two, at least twice the number of tags
+#ifndef PLCRUNTIME_TAG_HASH_SIZE
+#define PLCRUNTIME_TAG_HASH_SIZE 32
+#endif // PLCRUNTIME_TAG_HASH_SIZE
+
+static_assert(PLCRUNTIME_TAG_HASH_SIZE >= 2 * PLCRUNTIME_TAG_MAX_COUNT, "The tag hash index must have at least twice as many slots as tags");
+
+#define PLCRUNTIME_TAG_HASH_SEED 2166136261u
+
+struct TagEntry {
+    u32 hash;    // FNV-1a of the tag name
+    u32 address; // Memory address of the value
+    u8 type;     // Data type
+    u8 size;     // Value size in bytes
+};
+
+// FNV-1a step, the name can be hashed while it is received
+inline u32 tagHashStep(u32 hash, u8 c) {
+    return (hash ^ c) * 16777619u;
+}
+
+inline u32 tagNameHash(const char* name, u32 length) {
+    u32 hash = PLCRUNTIME_TAG_HASH_SEED;
+    for (u32 i = 0; i < length; i++) hash = tagHashStep(hash, name[i]);
+    return hash;
+}
+
+class RuntimeTagTable {
+public:
+    TagEntry tags[PLCRUNTIME_TAG_MAX_COUNT];
+    u16 count = 0;
+
+    RuntimeTagTable() { clear(); }
+
+    void clear() {
+        count = 0;
+        for (u32 i = 0; i < PLCRUNTIME_TAG_HASH_SIZE; i++) index[i] = 0;
+    }
+
+    // Add a tag to the table, returns true on error
+    bool add(u32 hash, u32 address, u8 type, u8 size) {
+        if (count >= PLCRUNTIME_TAG_MAX_COUNT) return true;
+        if (size == 0 || address + size > PLCRUNTIME_MAX_MEMORY_SIZE) return true;
+        if (find(hash) != nullptr) return true;
+        u32 slot = hash & (PLCRUNTIME_TAG_HASH_SIZE - 1);
+        while (index[slot]) slot = (slot + 1) & (PLCRUNTIME_TAG_HASH_SIZE - 1);
+        TagEntry& tag = tags[count];
+        tag.hash = hash;
+        tag.address = address;
+        tag.type = type;
+        tag.size = size;
+        count++;
+        index[slot] = count;
+        return false;
+    }
+
+    // Replace the table with the given tags, returns true on error and leaves the table empty
+    bool load(const TagEntry* entries, u16 entry_count) {
+        clear();
+        for (u16 i = 0; i < entry_count; i++) {
+            if (add(entries[i].hash, entries[i].address, entries[i].type, entries[i].size)) {
+                clear();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Tag with the given name hash, nullptr if there is none
+    const TagEntry* find(u32 hash) const {
+        u32 slot = hash & (PLCRUNTIME_TAG_HASH_SIZE - 1);
+        while (index[slot]) {
+            const TagEntry& tag = tags[index[slot] - 1];
+            if (tag.hash == hash) return &tag;
+            slot = (slot + 1) & (PLCRUNTIME_TAG_HASH_SIZE - 1);
+        }
+        return nullptr;
+    }
+
+    const TagEntry* find(const char* name, u32 length) const { return find(tagNameHash(name, length)); }
+
+private:
+    u16 index[PLCRUNTIME_TAG_HASH_SIZE]; // Tag index + 1 by hash slot, 0 if empty
+};
@@ -0,0 +1,266 @@
+// runtime-trend.h - 1.0.0 - 2022-12-11
+//
+// Copyright (c) 2022 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+// Trend logger
+// A configured list of tags (memory address + data type) is sampled at the end of every Nth scan. The oldest
+// held sample is kept raw as the base sample, every following sample is stored in a byte ring buffer as a record:
+//  - the time since the previous sample in milliseconds as a varint
+//  - for every integer tag the delta to the previous value, zigzag encoded as a varint
+//  - for every real tag the XOR of the bit pattern with the previous value as a varint
+// When the buffer is full the oldest record is folded into the base sample, so the memory use stays bounded
+// and the held samples can always be decoded.
+//
+// Upload format (all numbers are big-endian):
+//   <u8 tag_count> { <u32 address> <u8 type> } <u16 interval> <u32 sample_count> <u32 dropped_count>
+//   <u32 base_time> { <base value, tag size bytes> } <u32 data_size> <u8[] records, oldest first>
+
+#ifndef PLCRUNTIME_TREND_MAX_TAGS
+#define PLCRUNTIME_TREND_MAX_TAGS 8
+#endif // PLCRUNTIME_TREND_MAX_TAGS
+
+#ifndef PLCRUNTIME_TREND_BUFFER_SIZE
+#define PLCRUNTIME_TREND_BUFFER_SIZE 256
+#endif // PLCRUNTIME_TREND_BUFFER_SIZE
+
+#ifdef USE_X64_OPS
+typedef u64 trend_value_t;
+#else // USE_X64_OPS
+typedef u32 trend_value_t;
+#endif // USE_X64_OPS
+
+#define PLCRUNTIME_TREND_VARINT_SIZE ((sizeof(trend_value_t) * 8 + 6) / 7)
+#define PLCRUNTIME_TREND_RECORD_SIZE ((PLCRUNTIME_TREND_MAX_TAGS + 1) * PLCRUNTIME_TREND_VARINT_SIZE)
+
+struct TrendTag {
+    u32 address;
+    u8 type;
+    u8 size;
+};
+
+// Decoding position, starts at the base sample
+struct TrendCursor {
+    u32 index = 0;  // Sample index, 0 is the base sample
+    u32 offset = 0; // Buffer offset of the next record
+    u32 time = 0;   // Timestamp of the sample in milliseconds
+    trend_value_t values[PLCRUNTIME_TREND_MAX_TAGS];
+};
+
+class RuntimeTrendLogger {
+public:
+    TrendTag tags[PLCRUNTIME_TREND_MAX_TAGS];
+    u8 tag_count = 0;
+    u16 interval = 1;       // Sample every Nth scan
+    u32 sample_count = 0;   // Held samples, including the base sample
+    u32 dropped_count = 0;  // Samples folded into the base sample or too large for the buffer
+
+    RuntimeTrendLogger() {}
+
+    // Add a tag to the sampled list, returns true on error
+    bool addTag(u32 address, u8 type) {
+        u8 size = DATA_TYPE_SIZE(type);
+        if (tag_count >= PLCRUNTIME_TREND_MAX_TAGS) return true;
+        if (size == 0 || size > sizeof(trend_value_t)) return true;
+        if (address + size > PLCRUNTIME_MAX_MEMORY_SIZE) return true;
+        tags[tag_count].address = address;
+        tags[tag_count].type = type;
+        tags[tag_count].size = size;
+        tag_count++;
+        reset();
+        return false;
+    }
+
+    void clearTags() {
+        tag_count = 0;
+        reset();
+    }
+
+    void setInterval(u16 scans) {
+        interval = scans > 0 ? scans : 1;
+        scan_counter = 0;
+    }
+
+    // Drop all held samples
+    void reset() {
+        head = 0;
+        used = 0;
+        sample_count = 0;
+        dropped_count = 0;
+        scan_counter = 0;
+    }
+
+    // Sample the tags from the memory, called at the end of every scan
+    void sample(plc_memory_t memory) {
+        if (tag_count == 0) return;
+        if (++scan_counter < interval) return;
+        scan_counter = 0;
+        u32 now = millis();
+        trend_value_t values[PLCRUNTIME_TREND_MAX_TAGS];
+        for (u8 i = 0; i < tag_count; i++) values[i] = readValue(memory, tags[i]);
+        if (sample_count == 0) {
+            for (u8 i = 0; i < tag_count; i++) base_values[i] = last_values[i] = values[i];
+            base_time = last_time = now;
+            sample_count = 1;
+            return;
+        }
+        u8 record[PLCRUNTIME_TREND_RECORD_SIZE];
+        u32 length = writeVarint(record, now - last_time);
+        for (u8 i = 0; i < tag_count; i++) length += writeVarint(record + length, encode(tags[i], last_values[i], values[i]));
+        for (u8 i = 0; i < tag_count; i++) last_values[i] = values[i];
+        last_time = now;
+        if (length >= PLCRUNTIME_TREND_BUFFER_SIZE) {
+            // The record can never fit, the sample becomes the new base
+            for (u8 i = 0; i < tag_count; i++) base_values[i] = values[i];
+            base_time = now;
+            dropped_count += sample_count;
+            sample_count = 1;
+            head = 0;
+            used = 0;
+            return;
+        }
+        while (PLCRUNTIME_TREND_BUFFER_SIZE - used < length) evict();
+        u32 tail = (head + used) % PLCRUNTIME_TREND_BUFFER_SIZE;
+        for (u32 i = 0; i < length; i++) buffer[(tail + i) % PLCRUNTIME_TREND_BUFFER_SIZE] = record[i];
+        used += length;
+        sample_count++;
+    }
+
+    // Position the cursor on the base sample, returns true if there are no samples
+    bool begin(TrendCursor& cursor) {
+        if (sample_count == 0) return true;
+        cursor.index = 0;
+        cursor.offset = head;
+        cursor.time = base_time;
+        for (u8 i = 0; i < tag_count; i++) cursor.values[i] = base_values[i];
+        return false;
+    }
+
+    // Advance the cursor to the next sample, returns true if there are no more samples
+    bool next(TrendCursor& cursor) {
+        if (cursor.index + 1 >= sample_count) return true;
+        cursor.offset = decodeRecord(cursor.offset, cursor.time, cursor.values);
+        cursor.index++;
+        return false;
+    }
+
+    // Print the trend in the upload format as hex
+    void upload() {
+        printHex(tag_count, 1);
+        for (u8 i = 0; i < tag_count; i++) {
+            printHex(tags[i].address, 4);
+            printHex(tags[i].type, 1);
+        }
+        printHex(interval, 2);
+        printHex(sample_count, 4);
+        printHex(dropped_count, 4);
+        printHex(base_time, 4);
+        for (u8 i = 0; i < tag_count; i++) printHex(sample_count ? base_values[i] : 0, tags[i].size);
+        printHex(used, 4);
+        for (u32 i = 0; i < used; i++) printHex(buffer[(head + i) % PLCRUNTIME_TREND_BUFFER_SIZE], 1);
+        Serial.println();
+    }
+
+private:
+    u8 buffer[PLCRUNTIME_TREND_BUFFER_SIZE];
+    u32 head = 0; // Offset of the oldest record
+    u32 used = 0; // Bytes held in the buffer
+    u16 scan_counter = 0;
+    u32 base_time = 0;
+    u32 last_time = 0;
+    trend_value_t base_values[PLCRUNTIME_TREND_MAX_TAGS];
+    trend_value_t last_values[PLCRUNTIME_TREND_MAX_TAGS];
+
+    static bool isReal(const TrendTag& tag) {
+        return tag.type == type_f32 || tag.type == type_f64;
+    }
+
+    static trend_value_t mask(const TrendTag& tag) {
+        if (tag.size >= sizeof(trend_value_t)) return ~(trend_value_t) 0;
+        return ((trend_value_t) 1 << (tag.size * 8)) - 1;
+    }
+
+    static trend_value_t readValue(plc_memory_t memory, const TrendTag& tag) {
+        u8 location[8] = { 0 };
+        readArea_u8(memory, tag.address, location, tag.size);
+        switch (tag.size) {
+            case 1: return location[0];
+            case 2: { u16 value; memcpy(&value, location, 2); return value; }
+            case 4: { u32 value; memcpy(&value, location, 4); return value; }
+#ifdef USE_X64_OPS
+            case 8: { u64 value; memcpy(&value, location, 8); return value; }
+#endif // USE_X64_OPS
+            default: return 0;
+        }
+    }
+
+    static trend_value_t encode(const TrendTag& tag, trend_value_t previous, trend_value_t value) {
+        if (isReal(tag)) return previous ^ value;
+        // Sign extend the delta from the tag width, then zigzag it
+        trend_value_t sign = (trend_value_t) 1 << (tag.size * 8 - 1);
+        trend_value_t delta = (((value - previous) & mask(tag)) ^ sign) - sign;
+        return (delta << 1) ^ ((trend_value_t) 0 - (delta >> (sizeof(trend_value_t) * 8 - 1)));
+    }
+
+    static trend_value_t decode(const TrendTag& tag, trend_value_t previous, trend_value_t code) {
+        if (isReal(tag)) return previous ^ code;
+        trend_value_t delta = (code >> 1) ^ ((trend_value_t) 0 - (code & 1));
+        return (previous + delta) & mask(tag);
+    }
+
+    static u32 writeVarint(u8* output, trend_value_t value) {
+        u32 length = 0;
+        while (value >= 0x80) {
+            output[length++] = (u8) (value & 0x7F) | 0x80;
+            value >>= 7;
+        }
+        output[length++] = (u8) value;
+        return length;
+    }
+
+    trend_value_t readVarint(u32& offset) {
+        trend_value_t value = 0;
+        u8 shift = 0;
+        while (true) {
+            u8 b = buffer[offset];
+            offset = (offset + 1) % PLCRUNTIME_TREND_BUFFER_SIZE;
+            value |= (trend_value_t) (b & 0x7F) << shift;
+            if (!(b & 0x80)) return value;
+            shift += 7;
+        }
+    }
+
+    // Apply the record at offset to the time and values, returns the offset of the next record
+    u32 decodeRecord(u32 offset, u32& time, trend_value_t* values) {
+        time += (u32) readVarint(offset);
+        for (u8 i = 0; i < tag_count; i++) values[i] = decode(tags[i], values[i], readVarint(offset));
+        return offset;
+    }
+
+    // Fold the oldest record into the base sample
+    void evict() {
+        u32 next = decodeRecord(head, base_time, base_values);
+        used -= (next + PLCRUNTIME_TREND_BUFFER_SIZE - head) % PLCRUNTIME_TREND_BUFFER_SIZE;
+        head = next;
+        sample_count--;
+        dropped_count++;
+    }
+};
@@ -63,16 +63,18 @@ void load_plc_blinky() {
      *  78 00 14  ->  toggle u8 bit 0 at address 0x0014
      *  FF        ->  end of program, which is also the address 0x0009 to jump to
     **/
-    const u8 program [] = {
-        0x5C, 0x00, 0x01,
-        0xE2, 0x00, 0x09,
-        0x78, 0x00, 0x14,
-        0xFF,
-    };
-    const u16 size = sizeof(program);
+    // The same program built at compile time, including the label address and the checksum:
+    enum { end };
+    typedef PLCBuilder::Program<
+        PLCBuilder::ReadBit<1, 4>,
+        PLCBuilder::JumpIfNot<end>,
+        PLCBuilder::WriteBitInvert<20, 0>,
+        PLCBuilder::Label<end>,
+        PLCBuilder::Op<EXIT>
+    > Blinky;
     Serial.println(F("Loading program..."));
     Serial.flush();
-    runtime.loadProgramUnsafe(program, size);
+    runtime.loadProgram(Blinky::bytecode(), Blinky::size, Blinky::checksum());
 }
 
 void setup() {
@@ -125,8 +125,18 @@ WASM_EXPORT int runDirty() {
     return runtime.runDirty();
 }
 
+WASM_EXPORT int runDeferred() {
+    return runtime.runDeferred();
+}
+
+// Program offset of the first fault of the last deferred scan
+WASM_EXPORT u32 getFaultIndex() {
+    return runtime.fault_index;
+}
+
 WASM_EXPORT void run_unit_test() {
     runtime_unit_test(runtime);
+    assembler_unit_test();
 }
 
 WASM_EXPORT void run_custom_test() {
@@ -143,8 +153,13 @@ WASM_EXPORT void doSomething() {
 }
 
 
+// The paged memory has no flat buffer, it is read and written through the byte access exports instead
 WASM_EXPORT u32 getMemoryLocation() {
+#ifdef PLCRUNTIME_PAGED_MEMORY
+    return 0;
+#else
     return (u32) runtime.memory;
+#endif // PLCRUNTIME_PAGED_MEMORY
 }
 
 